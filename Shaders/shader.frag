@@ -1,12 +1,17 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D texSampler;
+// one sampler for every texture, the texture table holds the placeholder for slots still streaming
+layout(constant_id = 0) const uint textureTableSize = 1;
+layout(binding = 1) uniform sampler texSampler;
+layout(set = 1, binding = 0) uniform texture2D textures[textureTableSize];
 
-layout(location = 0) in vec3 fragColor;
-layout(location = 1) in vec2 fragTexCoord;
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in vec4 fragTint;
+layout(location = 2) flat in uint fragTexture;
 
 layout(location = 0) out vec4 outColor;
 
-void main() { 
-    outColor = texture(texSampler, fragTexCoord);
+// every instance of a draw has the same texture, so the index is uniform across it
+void main() {
+    outColor = texture(sampler2D(textures[fragTexture], texSampler), fragTexCoord) * fragTint;
 }
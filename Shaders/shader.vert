@@ -1,21 +1,77 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
+// bound with a dynamic offset into the frame ring
+layout(binding = 0) uniform FrameData {
     mat4 view;
     mat4 proj;
+    vec4 frustum[6];
+}
+frame;
+
+// one per instance, the draw of a model starts at the first of its instances
+struct ObjectData {
+    mat4 model;
+    vec4 tint;
+    uint slot;
+    uint lod;
+    uint cluster;
+};
+layout(std430, binding = 2) readonly buffer ObjectBuffer {
+    ObjectData data[];
 }
-ubo;
+objects;
+
+// the instances a draw kept, written by the culling pass or in order by the CPU
+layout(std430, binding = 3) readonly buffer IdBuffer {
+    uint data[];
+}
+ids;
+
+// identity for float vertices, maps normalized attributes back for packed ones
+struct MeshQuantization {
+    vec4 posScale;
+    vec4 posOffset;
+    vec4 uvScaleOffset;
+};
+
+// one per model slot
+struct DrawData {
+    MeshQuantization quantization;
+    vec4             bounds;
+    uint             command;
+    uint             pool;
+    uint             poolFirst;
+    uint             lodCount;
+    uint             firstMeshlet;
+    uint             meshletCount;
+    uint             texture;
+};
+layout(std430, binding = 4) readonly buffer DrawBuffer {
+    DrawData data[];
+}
+draws;
+
+layout(push_constant) uniform DrawParams {
+    uint drawBase;
+}
+params;
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inTexCoord;
+layout(location = 1) in vec2 inTexCoord;
 
-layout(location = 0) out vec3 fragColor;
-layout(location = 1) out vec2 fragTexCoord;
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out vec4 fragTint;
+layout(location = 2) flat out uint fragTexture;
 
 void main() {
-    gl_Position  = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
-    fragColor    = inColor;
-    fragTexCoord = inTexCoord;
+    ObjectData object = objects.data[ids.data[gl_InstanceIndex]];
+    DrawData   draw   = draws.data[params.drawBase + object.slot];
+
+    MeshQuantization quant = draw.quantization;
+
+    vec3 position = inPosition * quant.posScale.xyz + quant.posOffset.xyz;
+    gl_Position   = frame.proj * frame.view * object.model * vec4(position, 1.0);
+    fragTexCoord  = inTexCoord * quant.uvScaleOffset.xy + quant.uvScaleOffset.zw;
+    fragTint      = object.tint;
+    fragTexture   = draw.texture;
 }
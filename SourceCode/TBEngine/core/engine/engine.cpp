@@ -1,10 +1,15 @@
 #include "engine.hpp"
 #include "TBEngine/utils/log/log.hpp"
 #include "TBEngine/editor/editor.hpp"
+#include "TBEngine/core/math/frustum/frustumCuller.hpp"
+#include "TBEngine/core/math/bvh/bvh.hpp"
+#include "TBEngine/resource/file/model/modelFile.hpp"
 #include "TBEngine/settings.hpp"
 #include "TBEngine/enums.hpp"
 
 #include <any>
+#include <chrono>
+#include <string>
 
 extern const TBE::Utils::Log::Logger* logger;
 
@@ -22,6 +27,14 @@ Engine::Engine()
     , editor(graphic.getImguiInfo(), winForm.getPWindow()) {
     winForm.setResizeFlag(graphic.getPFrameBufferResized());
 
+    if (SPATIAL_QUERY_BENCHMARK) {
+        Math::FrustumCuller::benchmark();
+        Math::Bvh::benchmark();
+    }
+    if (MODEL_IMPORT_BENCHMARK) {
+        Resource::File::ModelFile::benchmark("Resources/Models/viking_room.obj");
+    }
+
     loadScene();
     graphic.initSceneInterface();
 
@@ -88,15 +101,58 @@ void Engine::bindCallBackFuncs() {
 void Engine::loadScene() {
     scene.addShader("Shaders/vert.spv", ShaderType::eVertex);
     scene.addShader("Shaders/frag.spv", ShaderType::eFrag);
-    scene.addModel("Resources/Models/viking_room.obj", "Resources/Textures/viking_room.png");
+    scene.addShader("Shaders/cull.spv", ShaderType::eCompute);
+    auto room =
+        scene.addModel("Resources/Models/viking_room.obj", "Resources/Textures/viking_room.png");
+    scene.addInstance(
+        room, glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    if (LOD_BENCHMARK_SCENE) {
+        // rows of rooms running far away from the camera, most of them only a few pixels large
+        constexpr int   gridSize = 100;
+        constexpr float spacing  = 2.5f;
+        for (int x = 0; x < gridSize; x++) {
+            for (int y = 1; y < gridSize; y++) {
+                auto offset = glm::vec3((x - gridSize / 2) * spacing, -y * spacing, 0.0f);
+                scene.addInstance(room, glm::translate(glm::mat4(1.0f), offset));
+            }
+        }
+    }
     scene.read();
 }
 
 void Engine::tick() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
     winForm.tick();
     scene.tickCPU();
     graphic.tick();
     editor.tickCPU();
+
+    if (LOD_BENCHMARK_SCENE || CLUSTER_CULLING_REPORT) {
+        frameTime += std::chrono::high_resolution_clock::now() - startTime;
+        if (++frameCount == 300) {
+            const auto& sceneInterface = Graphics::VulkanGraphics::sceneInterface;
+            if (LOD_BENCHMARK_SCENE) {
+                auto msPerFrame =
+                    std::chrono::duration<double, std::milli>(frameTime).count() / frameCount;
+                logger->info(std::to_string(msPerFrame) + " ms per frame, " +
+                             std::to_string(sceneInterface.getDrawnTriangles()) +
+                             " triangles drawn, " +
+                             std::to_string(sceneInterface.getFullTriangles()) +
+                             " without levels of detail");
+            }
+            if (CLUSTER_CULLING_REPORT) {
+                logger->info(std::to_string(sceneInterface.getClustersTested()) +
+                             " meshlets tested, " +
+                             std::to_string(sceneInterface.getClustersFrustumCulled()) +
+                             " culled by the frustum, " +
+                             std::to_string(sceneInterface.getClustersBackfacing()) +
+                             " facing away");
+            }
+            frameCount = 0;
+            frameTime  = {};
+        }
+    }
 }
 
 } // namespace TBE::Engine
@@ -5,6 +5,8 @@
 #include "TBEngine/editor/editor.hpp"
 #include "TBEngine/scene/scene.hpp"
 
+#include <chrono>
+
 namespace TBE::Engine {
 using TBE::Editor::DelegateManager::KeyStateMap;
 
@@ -25,6 +27,11 @@ private:
 private:
     bool shouldClose = false;
 
+    // averaged over the frames since the last log with LOD_BENCHMARK_SCENE or
+    // CLUSTER_CULLING_REPORT
+    uint32_t                                     frameCount{};
+    std::chrono::high_resolution_clock::duration frameTime{};
+
 private:
     void tick();
 
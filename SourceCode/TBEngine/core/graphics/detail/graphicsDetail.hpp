@@ -4,11 +4,13 @@
 #include "TBEngine/utils/log/log.hpp"
 #include "TBEngine/core/math/dataFormat.hpp"
 #include "TBEngine/core/window/window.hpp"
+#include "TBEngine/core/graphics/detail/vertexLayout.hpp"
 
 
 #include <set>
 #include <algorithm>
 #include <array>
+#include <string_view>
 #include <utility>
 
 #ifdef NDEBUG
@@ -36,6 +38,8 @@ using TBE::Utils::Log::logErrorMsg;
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily = std::nullopt;
     std::optional<uint32_t> presentFamily  = std::nullopt;
+    // a family without graphics that copies next to the rendering, none if the device lacks one
+    std::optional<uint32_t> transferFamily = std::nullopt;
 
     QueueFamilyIndices(const vk::PhysicalDevice& device, const vk::SurfaceKHR& surface) {
         auto queueFamilies = device.getQueueFamilyProperties();
@@ -58,6 +62,17 @@ struct QueueFamilyIndices {
         if (!isComplete()) {
             logErrorMsg("Cannot find suitable queue families!");
         }
+
+        // a transfer only family is usually the copy engine, take one with compute if it is not
+        for (uint32_t j = 0; j < queueFamilies.size(); j++) {
+            auto flags = queueFamilies[j].queueFlags;
+            if (!(flags & vk::QueueFlagBits::eTransfer) || (flags & vk::QueueFlagBits::eGraphics)) {
+                continue;
+            }
+            if (!transferFamily || !(flags & vk::QueueFlagBits::eCompute)) {
+                transferFamily = j;
+            }
+        }
     }
 
     operator std::set<uint32_t>() {
@@ -110,12 +125,27 @@ inline bool checkValidationLayerSupport(const std::vector<const char*>& validati
     return true;
 }
 
+inline bool checkInstanceExtensionSupport(const char* extensionName) {
+    std::vector<vk::ExtensionProperties> availableExtensions{};
+    depackReturnValue(availableExtensions, vk::enumerateInstanceExtensionProperties());
+
+    return std::any_of(availableExtensions.begin(),
+                       availableExtensions.end(),
+                       [&](const vk::ExtensionProperties& extension) {
+                           return std::string_view(extension.extensionName) == extensionName;
+                       });
+}
+
 inline std::vector<const char*> getRequiredExtensions() {
     auto extensions = Window::getRequiredExtensions();
 
     if (inDebug)
         extensions.push_back(vk::EXTDebugUtilsExtensionName);
 
+    // optional, the features of device extensions are queried through it
+    if (checkInstanceExtensionSupport(vk::KHRGetPhysicalDeviceProperties2ExtensionName))
+        extensions.push_back(vk::KHRGetPhysicalDeviceProperties2ExtensionName);
+
     return extensions;
 }
 
@@ -190,40 +220,6 @@ inline vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR&    capabi
     return {};
 }
 
-inline vk::VertexInputBindingDescription getBindingDescription() {
-    vk::VertexInputBindingDescription bindDesc{};
-
-    bindDesc.setBinding(0)
-        .setStride(sizeof(Math::DataFormat::Vertex))
-        .setInputRate(vk::VertexInputRate::eVertex);
-
-    return std::move(bindDesc);
-}
-
-inline std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions() {
-    std::array<vk::VertexInputAttributeDescription, 3> attrDesc{};
-
-    attrDesc[0]
-        .setBinding(0)
-        .setLocation(0)
-        .setFormat(vk::Format::eR32G32B32Sfloat)
-        .setOffset(offsetof(Math::DataFormat::Vertex, pos));
-
-    attrDesc[1]
-        .setBinding(0)
-        .setLocation(1)
-        .setFormat(vk::Format::eR32G32B32Sfloat)
-        .setOffset(offsetof(Math::DataFormat::Vertex, color));
-
-    attrDesc[2]
-        .setBinding(0)
-        .setLocation(2)
-        .setFormat(vk::Format::eR32G32Sfloat)
-        .setOffset(offsetof(Math::DataFormat::Vertex, texCoord));
-
-    return std::move(attrDesc);
-}
-
 inline bool hasStencilComponent(vk::Format format) {
     return format == vk::Format::eD32SfloatS8Uint || format == vk::Format::eD24UnormS8Uint;
 }
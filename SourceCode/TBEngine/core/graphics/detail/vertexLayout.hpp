@@ -0,0 +1,216 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace TBE::Graphics::Detail {
+
+// one vertex attribute, declared by the vertex type in its VertexLayoutTraits
+struct VertexAttribute {
+    uint32_t   location{};
+    vk::Format format{};
+    uint32_t   offset{};
+};
+
+constexpr uint32_t getFormatSize(vk::Format format) {
+    switch (format) {
+        case vk::Format::eR32Sfloat: return 4;
+        case vk::Format::eR32G32Sfloat: return 8;
+        case vk::Format::eR32G32B32Sfloat: return 12;
+        case vk::Format::eR32G32B32A32Sfloat: return 16;
+        case vk::Format::eR16G16Unorm:
+        case vk::Format::eR16G16Snorm:
+        case vk::Format::eR16G16Sfloat: return 4;
+        case vk::Format::eR16G16B16A16Unorm:
+        case vk::Format::eR16G16B16A16Snorm:
+        case vk::Format::eR16G16B16A16Sfloat:
+        case vk::Format::eR16G16B16A16Uint: return 8;
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Snorm:
+        case vk::Format::eR8G8B8A8Uint: return 4;
+        default: return 0;
+    }
+}
+
+// size of a single component, attribute offsets have to be a multiple of it
+constexpr uint32_t getFormatComponentSize(vk::Format format) {
+    switch (format) {
+        case vk::Format::eR32Sfloat:
+        case vk::Format::eR32G32Sfloat:
+        case vk::Format::eR32G32B32Sfloat:
+        case vk::Format::eR32G32B32A32Sfloat: return 4;
+        case vk::Format::eR16G16Unorm:
+        case vk::Format::eR16G16Snorm:
+        case vk::Format::eR16G16Sfloat:
+        case vk::Format::eR16G16B16A16Unorm:
+        case vk::Format::eR16G16B16A16Snorm:
+        case vk::Format::eR16G16B16A16Sfloat:
+        case vk::Format::eR16G16B16A16Uint: return 2;
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Snorm:
+        case vk::Format::eR8G8B8A8Uint: return 1;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Attributes of a vertex type, specialize it next to the vertex struct.
+ *
+ * @details A specialization provides `static constexpr std::array attributes` of VertexAttribute.
+ * The stride is always sizeof(VertexT), VertexInput checks the declaration at compile time.
+ */
+template <typename VertexT>
+struct VertexLayoutTraits;
+
+template <>
+struct VertexLayoutTraits<Math::DataFormat::Vertex> {
+    using Vertex = Math::DataFormat::Vertex;
+
+    // color is not read by the shaders
+    static constexpr std::array attributes = {
+        VertexAttribute{0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, pos)},
+        VertexAttribute{1, vk::Format::eR32G32Sfloat, offsetof(Vertex, texCoord)},
+    };
+};
+
+template <>
+struct VertexLayoutTraits<Math::DataFormat::PackedVertex> {
+    using PackedVertex = Math::DataFormat::PackedVertex;
+
+    static constexpr std::array attributes = {
+        VertexAttribute{0, vk::Format::eR16G16B16A16Snorm, offsetof(PackedVertex, pos)},
+        VertexAttribute{1, vk::Format::eR16G16Unorm, offsetof(PackedVertex, texCoord)},
+    };
+};
+
+// C++ vertex type of each runtime layout
+template <Math::DataFormat::VertexLayout layout>
+struct VertexTypeOf;
+
+template <>
+struct VertexTypeOf<Math::DataFormat::VertexLayout::eFloat> {
+    using type = Math::DataFormat::Vertex;
+};
+
+template <>
+struct VertexTypeOf<Math::DataFormat::VertexLayout::ePacked> {
+    using type = Math::DataFormat::PackedVertex;
+};
+
+// the runtime stride table has to agree with the C++ types
+static_assert(sizeof(VertexTypeOf<Math::DataFormat::VertexLayout::eFloat>::type) ==
+              Math::DataFormat::getVertexStride(Math::DataFormat::VertexLayout::eFloat));
+static_assert(sizeof(VertexTypeOf<Math::DataFormat::VertexLayout::ePacked>::type) ==
+              Math::DataFormat::getVertexStride(Math::DataFormat::VertexLayout::ePacked));
+
+namespace LayoutCheck {
+
+template <typename VertexT>
+constexpr bool formatsKnown() {
+    for (const auto& attr : VertexLayoutTraits<VertexT>::attributes) {
+        if (getFormatSize(attr.format) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename VertexT>
+constexpr bool fitsStride() {
+    for (const auto& attr : VertexLayoutTraits<VertexT>::attributes) {
+        if (attr.offset + getFormatSize(attr.format) > sizeof(VertexT)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename VertexT>
+constexpr bool offsetsAligned() {
+    for (const auto& attr : VertexLayoutTraits<VertexT>::attributes) {
+        if (attr.offset % getFormatComponentSize(attr.format) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename VertexT>
+constexpr bool disjoint() {
+    const auto& attrs = VertexLayoutTraits<VertexT>::attributes;
+    for (size_t i = 0; i < attrs.size(); i++) {
+        for (size_t j = i + 1; j < attrs.size(); j++) {
+            if (attrs[i].location == attrs[j].location) {
+                return false;
+            }
+            bool separate = attrs[i].offset + getFormatSize(attrs[i].format) <= attrs[j].offset ||
+                            attrs[j].offset + getFormatSize(attrs[j].format) <= attrs[i].offset;
+            if (!separate) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace LayoutCheck
+
+/**
+ * @brief Vulkan vertex input descriptions of a vertex type, built at compile time.
+ *
+ * @details Only reading a layout through this type instantiates its checks, so a broken
+ * declaration fails to compile instead of failing in the validation layer.
+ */
+template <typename VertexT, uint32_t binding = 0>
+struct VertexInput {
+    using Traits = VertexLayoutTraits<VertexT>;
+
+    static_assert(std::is_standard_layout_v<VertexT>, "offsetof needs a standard layout vertex");
+    static_assert(sizeof(VertexT) % 4 == 0, "vertex stride must be a multiple of 4 bytes");
+    static_assert(LayoutCheck::formatsKnown<VertexT>(), "unknown attribute format");
+    static_assert(LayoutCheck::fitsStride<VertexT>(), "attribute exceeds the vertex stride");
+    static_assert(LayoutCheck::offsetsAligned<VertexT>(), "attribute offset is not aligned");
+    static_assert(LayoutCheck::disjoint<VertexT>(), "attributes overlap or share a location");
+
+    static constexpr vk::VertexInputBindingDescription bindingDescription{
+        binding, sizeof(VertexT), vk::VertexInputRate::eVertex};
+
+    static constexpr auto attributeDescriptions = [] {
+        std::array<vk::VertexInputAttributeDescription, Traits::attributes.size()> ret{};
+        for (size_t i = 0; i < ret.size(); i++) {
+            ret[i] = vk::VertexInputAttributeDescription{Traits::attributes[i].location,
+                                                         binding,
+                                                         Traits::attributes[i].format,
+                                                         Traits::attributes[i].offset};
+        }
+        return ret;
+    }();
+};
+
+// non owning view of the descriptions, the arrays live in VertexInput
+struct VertexInputDesc {
+    const vk::VertexInputBindingDescription*             bindingDescription{};
+    std::span<const vk::VertexInputAttributeDescription> attributeDescriptions{};
+};
+
+template <typename VertexT>
+constexpr VertexInputDesc getVertexInputDesc() {
+    return {&VertexInput<VertexT>::bindingDescription, VertexInput<VertexT>::attributeDescriptions};
+}
+
+// runtime dispatch for the pipeline builder, every layout is validated when this is compiled
+inline VertexInputDesc getVertexInputDesc(Math::DataFormat::VertexLayout layout) {
+    using Math::DataFormat::VertexLayout;
+    switch (layout) {
+        case VertexLayout::ePacked:
+            return getVertexInputDesc<VertexTypeOf<VertexLayout::ePacked>::type>();
+        case VertexLayout::eFloat:
+        default: return getVertexInputDesc<VertexTypeOf<VertexLayout::eFloat>::type>();
+    }
+}
+
+} // namespace TBE::Graphics::Detail
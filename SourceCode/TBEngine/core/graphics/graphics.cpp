@@ -2,6 +2,7 @@
 
 #include "TBEngine/utils/log/log.hpp"
 #include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
 #include "TBEngine/core/window/window.hpp"
 #include "TBEngine/settings.hpp"
 
@@ -23,17 +24,26 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyDebugUtilsMessengerEXT(VkInstance
 
 namespace TBE::Graphics { // VulkanGraphics
 using namespace TBE::Graphics::Detail;
-vk::Instance       VulkanGraphics::instance         = {};
-vk::PhysicalDevice VulkanGraphics::phyDevice        = {};
-vk::Device         VulkanGraphics::device           = {};
-vk::SurfaceKHR     VulkanGraphics::surface          = {};
-vk::CommandPool    VulkanGraphics::commandPool      = {};
-vk::Queue          VulkanGraphics::graphicsQueue    = {};
-vk::Extent2D       VulkanGraphics::extent           = {{WINDOW_WIDTH, WINDOW_HEIGHT}};
-ShaderInterface    VulkanGraphics::shaderInterface  = {};
-TextureInterface   VulkanGraphics::textureInterface = {};
-ModelInterface     VulkanGraphics::modelInterface   = {};
-SceneInterface     VulkanGraphics::sceneInterface   = {};
+vk::Instance       VulkanGraphics::instance            = {};
+vk::PhysicalDevice VulkanGraphics::phyDevice           = {};
+vk::Device         VulkanGraphics::device              = {};
+vk::SurfaceKHR     VulkanGraphics::surface             = {};
+vk::CommandPool    VulkanGraphics::commandPool         = {};
+vk::Queue          VulkanGraphics::graphicsQueue       = {};
+uint32_t           VulkanGraphics::graphicsQueueFamily = {};
+vk::CommandPool    VulkanGraphics::transferCommandPool = {};
+vk::Queue          VulkanGraphics::transferQueue       = {};
+uint32_t           VulkanGraphics::transferQueueFamily = {};
+vk::Extent2D       VulkanGraphics::extent              = {{WINDOW_WIDTH, WINDOW_HEIGHT}};
+ShaderInterface    VulkanGraphics::shaderInterface     = {};
+TextureInterface   VulkanGraphics::textureInterface    = {};
+ModelInterface     VulkanGraphics::modelInterface      = {};
+SceneInterface     VulkanGraphics::sceneInterface      = {};
+UploadContext      VulkanGraphics::uploadContext       = {};
+FrameRing          VulkanGraphics::frameRing           = {};
+CullPass           VulkanGraphics::cullPass            = {};
+ObjectCache        VulkanGraphics::objectCache         = {};
+DescriptorAllocator VulkanGraphics::descriptorAllocator = {};
 
 
 VulkanGraphics::VulkanGraphics(Window::Window& window_) : window(window_) {
@@ -68,6 +78,35 @@ void VulkanGraphics::initVulkan() {
 
     createCommandBuffers();
     createSyncObjects();
+
+    uploadContext.init();
+    frameRing.init(MAX_FRAMES_IN_FLIGHT, FRAME_RING_SIZE);
+
+    // the most descriptors of each type a set of each list has, the sets of the draws, their
+    // texture tables, one per frame in flight, and the sets the culling pass allocates every
+    // frame, its frame data and nine storage buffers
+    using vk::DescriptorType;
+    DescriptorAllocator::PoolProfile persistentProfile{
+        .setSizes = {{DescriptorType::eUniformBufferDynamic, 1},
+                     {DescriptorType::eSampler, 1},
+                     {DescriptorType::eStorageBuffer, 3}},
+        .poolSets = DESCRIPTOR_POOL_SETS};
+    DescriptorAllocator::PoolProfile bindlessProfile{
+        .setSizes = {{DescriptorType::eSampledImage, textureInterface.getTableSize()}},
+        .poolSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),
+        .flags    = textureInterface.isUpdateAfterBind()
+                        ? vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind
+                        : vk::DescriptorPoolCreateFlags{}};
+    DescriptorAllocator::PoolProfile transientProfile{
+        .setSizes = {{DescriptorType::eUniformBufferDynamic, 1},
+                     {DescriptorType::eStorageBuffer, 9}},
+        .poolSets = DESCRIPTOR_POOL_SETS};
+    descriptorAllocator.init(
+        MAX_FRAMES_IN_FLIGHT, persistentProfile, bindlessProfile, transientProfile);
+
+    // streamed slots are drawn with these until their upload is done
+    modelInterface.initPlaceholder();
+    textureInterface.initPlaceholder();
 }
 
 void VulkanGraphics::tick() {
@@ -80,6 +119,11 @@ void VulkanGraphics::tick() {
            vk::Result::eTimeout) {
         logger->warn("wait for fences: timeout.");
     }
+    // the frame recorded last with this fence is done, so are its part of the frame ring and the
+    // meshes it drew and its transient descriptor sets
+    frameRing.begin(currentFrame);
+    descriptorAllocator.beginFrame(currentFrame);
+    modelInterface.tick();
 
     auto [result, imageIndex] = device.acquireNextImageKHR(
         swapchainR.swapchain, std::numeric_limits<uint64_t>::max(), imgAviSemaphore, nullptr);
@@ -96,6 +140,9 @@ void VulkanGraphics::tick() {
 
     recordCommandBuffer(cmdBuffer, imageIndex);
 
+    // uploads recorded since the last frame go first, the frame may already draw them
+    uploadContext.flush();
+
     std::array             waitSemaphores   = {imgAviSemaphore};
     vk::PipelineStageFlags waitStages[]     = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
     std::array             signalSemaphores = {renFinSemaphore};
@@ -144,9 +191,15 @@ void VulkanGraphics::cleanup() {
     textureInterface.destroy();
     modelInterface.destroy();
     sceneInterface.destroy();
+    cullPass.destroy();
+    descriptorAllocator.destroy();
+    frameRing.destroy();
+    uploadContext.destroy();
 
-    device.destroy(graphicsPipeline);
-    device.destroy(pipelineLayout);
+    for (auto& pipeline : graphicsPipelines) {
+        device.destroy(pipeline);
+    }
+    objectCache.destroy();
     renderPass.destroy();
 
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
@@ -156,6 +209,11 @@ void VulkanGraphics::cleanup() {
     }
 
     device.destroy(commandPool, nullptr); // command buffers are freed implicitly here.
+    if (transferCommandPool) {
+        device.destroy(transferCommandPool);
+    }
+
+    MemoryAllocator::get().destroy();
 
     device.destroy(); // This would implicitly clean up the device queue.
     if (inDebug) {
@@ -173,12 +231,23 @@ void VulkanGraphics::bindTickCmdFunc(std::function<void(const vk::CommandBuffer&
     tickCmdFuncs.emplace_back(func);
 }
 
+void VulkanGraphics::bindPreRenderCmdFunc(std::function<void(const vk::CommandBuffer&)> func) {
+    preRenderCmdFuncs.emplace_back(func);
+}
+
 void VulkanGraphics::initSceneInterface() {
     createGraphicsPipeline();
+    createCullPass();
+    shaderInterface.destroyCache();
     createDescriptor();
 
-    auto sceneTickFunc =
-        std::bind(&SceneInterface::tickGPU, &sceneInterface, std::placeholders::_1, pipelineLayout);
+    bindPreRenderCmdFunc(
+        std::bind(&SceneInterface::prepareGPU, &sceneInterface, std::placeholders::_1));
+    auto sceneTickFunc = std::bind(&SceneInterface::tickGPU,
+                                   &sceneInterface,
+                                   std::placeholders::_1,
+                                   pipelineLayout,
+                                   std::span<const vk::Pipeline>(graphicsPipelines));
     bindTickCmdFunc(sceneTickFunc);
 }
 
@@ -263,6 +332,20 @@ void VulkanGraphics::pickPhysicalDevice() {
         }
     }
 
+    // validating the GPU culling on a software device keeps driver bugs out of the comparison
+    if (GPU_CULLING_VALIDATION) {
+        for (const auto& phyDeivce_ : devices) {
+            if (phyDeivce_.getProperties().deviceType == vk::PhysicalDeviceType::eCpu &&
+                isDeviceSuitable(phyDeivce_)) {
+                phyDevice   = phyDeivce_;
+                msaaSamples = getMaxUsableSampleCount(phyDevice);
+                logger->info(std::string("validating GPU culling on ") +
+                             phyDevice.getProperties().deviceName.data());
+                break;
+            }
+        }
+    }
+
     if (!phyDevice) {
         logErrorMsg("Failed to find suitable GPU.");
     }
@@ -279,6 +362,9 @@ void VulkanGraphics::createLogicalDevice() {
 
     QueueFamilyIndices indices             = QueueFamilyIndices(phyDevice, surface);
     std::set<uint32_t> uniqueQueueFamilies = indices;
+    if (USE_TRANSFER_QUEUE && indices.transferFamily) {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for (auto queueFamily : uniqueQueueFamilies) {
@@ -288,19 +374,53 @@ void VulkanGraphics::createLogicalDevice() {
             .setPQueuePriorities(&queuePriority);
         queueCreateInfos.push_back(queueCreateInfo);
     }
+    // BC textures are optional, TextureInterface decodes them when the feature is missing, so are
+    // multi draws and draw counts, CullPass falls back to single indirect draws, and indirect
+    // first instances, CullPass is disabled without them
+    // the texture table is indexed by the texture of the draw
     vk::PhysicalDeviceFeatures deviceFeatures{};
-    deviceFeatures.setSamplerAnisotropy(vk::True);
+    deviceFeatures.setSamplerAnisotropy(vk::True)
+        .setShaderSampledImageArrayDynamicIndexing(vk::True)
+        .setTextureCompressionBC(phyDevice.getFeatures().textureCompressionBC)
+        .setMultiDrawIndirect(phyDevice.getFeatures().multiDrawIndirect)
+        .setDrawIndirectFirstInstance(phyDevice.getFeatures().drawIndirectFirstInstance);
+
+    auto extensions = deviceExtensions;
+    for (auto extension : CullPass::getOptionalExtensions(phyDevice)) {
+        extensions.push_back(extension);
+    }
+    for (auto extension : DescriptorAllocator::getOptionalExtensions(phyDevice)) {
+        extensions.push_back(extension);
+    }
+    for (auto extension : TextureInterface::getOptionalExtensions(phyDevice)) {
+        extensions.push_back(extension);
+    }
+
+    // the texture table is partially bound and updated after bind when the device can
+    auto indexingFeatures = TextureInterface::getIndexingFeatures(phyDevice);
 
     vk::DeviceCreateInfo createInfo{};
     createInfo.setFlags(vk::DeviceCreateFlags())
         .setQueueCreateInfos(queueCreateInfos)
-        .setPEnabledExtensionNames(deviceExtensions)
+        .setPEnabledExtensionNames(extensions)
         .setPEnabledFeatures(&deviceFeatures);
+    if (indexingFeatures.descriptorBindingPartiallyBound) {
+        createInfo.setPNext(&indexingFeatures);
+    }
 
     depackReturnValue(device, phyDevice.createDevice(createInfo));
-
-    graphicsQueue = device.getQueue(indices.graphicsFamily.value(), 0);
-    presentQueue  = device.getQueue(indices.presentFamily.value(), 0);
+    textureInterface.initTable(indexingFeatures);
+
+    graphicsQueue       = device.getQueue(indices.graphicsFamily.value(), 0);
+    presentQueue        = device.getQueue(indices.presentFamily.value(), 0);
+    graphicsQueueFamily = indices.graphicsFamily.value();
+    transferQueueFamily = graphicsQueueFamily;
+    if (USE_TRANSFER_QUEUE && indices.transferFamily) {
+        transferQueueFamily = indices.transferFamily.value();
+        transferQueue       = device.getQueue(transferQueueFamily, 0);
+        logger->info("uploads use the transfer queue family " +
+                     std::to_string(transferQueueFamily));
+    }
 }
 
 void VulkanGraphics::createSwapChain() {
@@ -321,12 +441,20 @@ void VulkanGraphics::createGraphicsPipeline() {
     vk::PipelineDynamicStateCreateInfo dynamicState{};
     dynamicState.setDynamicStates(dynamicStates);
 
-    auto bindingDescription    = getBindingDescription();
-    auto attributeDescriptions = getAttributeDescriptions();
-
-    vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.setVertexBindingDescriptions(bindingDescription)
-        .setVertexAttributeDescriptions(attributeDescriptions);
+    // one pipeline per vertex layout, they only differ in the vertex input state
+    using Math::DataFormat::VertexLayout;
+    using Math::DataFormat::vertexLayoutCount;
+
+    std::array<vk::PipelineVertexInputStateCreateInfo, vertexLayoutCount> vertexInputInfos{};
+    for (size_t i = 0; i < vertexLayoutCount; i++) {
+        auto inputDesc = getVertexInputDesc(static_cast<VertexLayout>(i));
+        vertexInputInfos[i]
+            .setVertexBindingDescriptionCount(1)
+            .setPVertexBindingDescriptions(inputDesc.bindingDescription)
+            .setVertexAttributeDescriptionCount(
+                static_cast<uint32_t>(inputDesc.attributeDescriptions.size()))
+            .setPVertexAttributeDescriptions(inputDesc.attributeDescriptions.data());
+    }
 
     vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.setTopology(vk::PrimitiveTopology::eTriangleList)
@@ -386,31 +514,35 @@ void VulkanGraphics::createGraphicsPipeline() {
         .setDepthBoundsTestEnable(vk::False)
         .setStencilTestEnable(vk::False);
 
-    // define the uniform data that would be passed to shader
-    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.setSetLayouts(shaderInterface.descriptors.layout);
-
-    depackReturnValue(pipelineLayout, device.createPipelineLayout(pipelineLayoutInfo));
-
-    vk::GraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.setStages(shaderStages)
-        .setPVertexInputState(&vertexInputInfo)
-        .setPInputAssemblyState(&inputAssembly)
-        .setPViewportState(&viewportState)
-        .setPRasterizationState(&rasterizer)
-        .setPMultisampleState(&multisampling)
-        .setPColorBlendState(&colorBlending)
-        .setPDynamicState(&dynamicState)
-        .setLayout(pipelineLayout)
-        .setRenderPass(renderPass.renderPass)
-        .setSubpass(0)
-        .setPDepthStencilState(&depthStencil);
-
-    std::vector<vk::Pipeline> grapPipes{};
-    depackReturnValue(grapPipes, device.createGraphicsPipelines(nullptr, pipelineInfo));
-    graphicsPipeline = std::move(grapPipes[0]);
+    // where the draws of the frame start in the frame ring, they carry the dequantization
+    vk::PushConstantRange pushConstantRange{};
+    pushConstantRange.setStageFlags(vk::ShaderStageFlagBits::eVertex)
+        .setOffset(0)
+        .setSize(sizeof(uint32_t));
+
+    // define the uniform data that would be passed to shader, the texture table is set 1
+    std::array<vk::DescriptorSetLayout, 2> setLayouts{shaderInterface.descriptors.layout,
+                                                      shaderInterface.descriptors.tableLayout};
+    pipelineLayout = objectCache.getPipelineLayout(setLayouts, pushConstantRange);
+
+    std::array<vk::GraphicsPipelineCreateInfo, vertexLayoutCount> pipelineInfos{};
+    for (size_t i = 0; i < vertexLayoutCount; i++) {
+        pipelineInfos[i]
+            .setStages(shaderStages)
+            .setPVertexInputState(&vertexInputInfos[i])
+            .setPInputAssemblyState(&inputAssembly)
+            .setPViewportState(&viewportState)
+            .setPRasterizationState(&rasterizer)
+            .setPMultisampleState(&multisampling)
+            .setPColorBlendState(&colorBlending)
+            .setPDynamicState(&dynamicState)
+            .setLayout(pipelineLayout)
+            .setRenderPass(renderPass.renderPass)
+            .setSubpass(0)
+            .setPDepthStencilState(&depthStencil);
+    }
 
-    shaderInterface.destroyCache();
+    depackReturnValue(graphicsPipelines, device.createGraphicsPipelines(nullptr, pipelineInfos));
 }
 
 void VulkanGraphics::createFramebuffers() {
@@ -438,6 +570,11 @@ void VulkanGraphics::createCommandPool() {
         .setQueueFamilyIndex(indices.graphicsFamily.value());
 
     depackReturnValue(commandPool, device.createCommandPool(poolInfo));
+
+    if (transferQueue) {
+        poolInfo.setQueueFamilyIndex(transferQueueFamily);
+        depackReturnValue(transferCommandPool, device.createCommandPool(poolInfo));
+    }
 }
 
 void VulkanGraphics::createColorResources() {
@@ -452,19 +589,24 @@ void VulkanGraphics::createDepthResources() {
     depthImageR.init(ImageResourceType::eDepth);
 }
 
-void VulkanGraphics::createDescriptor() {
-    std::array<vk::DescriptorPoolSize, 2> poolSizes{};
-    poolSizes[0]
-        .setType(vk::DescriptorType::eUniformBuffer)
-        .setDescriptorCount(static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT));
-    poolSizes[1]
-        .setType(vk::DescriptorType::eCombinedImageSampler)
-        .setDescriptorCount(static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT));
+// the scene draws on the CPU if no culling shader has been added
+void VulkanGraphics::createCullPass() {
+    if (shaderInterface.computeStageInfos.empty()) {
+        logger->info("no culling shader, instances are drawn by the CPU");
+        return;
+    }
+    cullPass.init(shaderInterface.computeStageInfos.front(),
+                  frameRing.getBuffers(),
+                  sizeof(Math::DataFormat::FrameData));
+}
 
-    shaderInterface.descriptors.initPool(static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT), poolSizes);
-    shaderInterface.descriptors.initSets(sceneInterface.getUniformBufferRs(),
-                                         modelInterface.getTextureSampler(0),
-                                         modelInterface.getTextureImageView(0));
+void VulkanGraphics::createDescriptor() {
+    shaderInterface.descriptors.initSets(frameRing.getBuffers(),
+                                         sizeof(Math::DataFormat::FrameData),
+                                         textureInterface.sampler,
+                                         textureInterface.getPlaceholder(),
+                                         textureInterface.getTableSize(),
+                                         textureInterface.isPartiallyBound());
 }
 
 void VulkanGraphics::createCommandBuffers() {
@@ -540,7 +682,8 @@ bool VulkanGraphics::isDeviceSuitable(const vk::PhysicalDevice& phyDevice) {
     auto supportedFeatures = phyDevice.getFeatures();
 
     return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-           supportedFeatures.samplerAnisotropy;
+           supportedFeatures.samplerAnisotropy &&
+           supportedFeatures.shaderSampledImageArrayDynamicIndexing;
 }
 
 void VulkanGraphics::recordCommandBuffer(vk::CommandBuffer cmdBuffer, uint32_t imageIndex) {
@@ -558,10 +701,11 @@ void VulkanGraphics::recordCommandBuffer(vk::CommandBuffer cmdBuffer, uint32_t i
         .setFramebuffer(swapchainFramebuffers[imageIndex])
         .setRenderArea(renderArea)
         .setClearValues(clearValues);
+    for (auto& func : preRenderCmdFuncs) {
+        func(cmdBuffer);
+    }
     cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
 
-    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, graphicsPipeline);
-
     vk::Viewport viewport{};
     viewport.setX(0.0f)
         .setY(0.0f)
@@ -591,34 +735,14 @@ vk::Format VulkanGraphics::findDepthFormat() {
         vk::FormatFeatureFlagBits::eDepthStencilAttachment);
 }
 
+// recorded with the pending uploads, only waits for their batch instead of the whole queue
 void disposableCommands(std::function<void(vk::CommandBuffer&)> func) {
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo.setLevel(vk::CommandBufferLevel::ePrimary)
-        .setCommandPool(VulkanGraphics::commandPool)
-        .setCommandBufferCount(1);
-
-    std::vector<vk::CommandBuffer> cmdBuffers{};
-    depackReturnValue(cmdBuffers, VulkanGraphics::device.allocateCommandBuffers(allocInfo));
-    auto cmdBuffer = cmdBuffers[0];
-
-    vk::CommandBufferBeginInfo beginInfo{};
-    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-
-    handleVkResult(cmdBuffer.begin(beginInfo));
+    auto&             context   = VulkanGraphics::uploadContext;
+    vk::CommandBuffer cmdBuffer = context.getGraphicsCmdBuffer();
 
     func(cmdBuffer);
 
-    handleVkResult(cmdBuffer.end());
-
-    vk::SubmitInfo submitInfo{};
-    submitInfo.setCommandBuffers(cmdBuffer);
-
-    handleVkResult(VulkanGraphics::graphicsQueue.submit(submitInfo));
-    while (VulkanGraphics::graphicsQueue.waitIdle() == vk::Result::eTimeout) {
-        logger->warn("graphicsQueue waitIdle in disposableCommands(): timeout.");
-    }
-
-    VulkanGraphics::device.free(VulkanGraphics::commandPool, 1, &cmdBuffer);
+    context.wait(context.getTicket());
 }
 
 } // namespace TBE::Graphics
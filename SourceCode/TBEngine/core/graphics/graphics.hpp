@@ -5,6 +5,11 @@
 #include "TBEngine/core/graphics/vulkanAbstract/imageResource/imageResource.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/swapchainResource/swapchainResource.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/renderPass/renderPass.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/uploadContext/uploadContext.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/frameRing/frameRing.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/cullPass/cullPass.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/objectCache/objectCache.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/descriptorAllocator/descriptorAllocator.hpp"
 #include "TBEngine/scene/scene.hpp"
 #include "interface/shaderInterface/shaderInterface.hpp"
 #include "interface/textureInterface/textureInterface.hpp"
@@ -31,7 +36,7 @@ void disposableCommands(std::function<void(vk::CommandBuffer&)> func);
 
 class VulkanGraphics final {
 private:
-    friend void disposableCommands(std::function<void(vk::CommandBuffer&)> func);
+    friend class UploadContext;
 
 public:
     VulkanGraphics(Window::Window& window_);
@@ -47,6 +52,8 @@ private:
 public:
     bool*                     getPFrameBufferResized();
     void                      bindTickCmdFunc(std::function<void(const vk::CommandBuffer&)> func);
+    // recorded before the render pass begins, for compute and transfer work of the frame
+    void bindPreRenderCmdFunc(std::function<void(const vk::CommandBuffer&)> func);
     ImGui_ImplVulkan_InitInfo getImguiInfo();
 
     void initSceneInterface();
@@ -66,6 +73,7 @@ private:
     void createColorResources();
     void createDepthResources();
     void createDescriptor();
+    void createCullPass();
     void createCommandBuffers();
     void createSyncObjects();
 
@@ -85,13 +93,14 @@ private:
     std::vector<vk::Semaphore>     renderFinishedSemaphores{};
     std::vector<vk::Fence>         inFlightFences{};
     vk::PipelineLayout             pipelineLayout{};
-    vk::Pipeline                   graphicsPipeline{};
+    std::vector<vk::Pipeline>      graphicsPipelines{}; // indexed by VertexLayout
     uint32_t                       mipLevels{};
     vk::SampleCountFlagBits        msaaSamples = vk::SampleCountFlagBits::e1;
     vk::DebugUtilsMessengerEXT     debugMessenger{};
 
 private:
     std::vector<std::function<void(const vk::CommandBuffer&)>> tickCmdFuncs{};
+    std::vector<std::function<void(const vk::CommandBuffer&)>> preRenderCmdFuncs{};
 
 private:
     bool       isDeviceSuitable(const vk::PhysicalDevice& phyDevice);
@@ -109,6 +118,11 @@ public:
     static TextureInterface textureInterface;
     static ModelInterface   modelInterface;
     static SceneInterface   sceneInterface;
+    static UploadContext    uploadContext;
+    static FrameRing        frameRing;
+    static CullPass         cullPass;
+    static ObjectCache      objectCache; // owns the samplers and layouts it hands out
+    static DescriptorAllocator descriptorAllocator; // owns the sets of the renderer
 
 public:
     static vk::Instance       instance;
@@ -120,6 +134,11 @@ public:
 private:
     static vk::CommandPool commandPool;
     static vk::Queue       graphicsQueue;
+    static uint32_t        graphicsQueueFamily;
+    // null when the device has no separate transfer family, uploads use graphicsQueue then
+    static vk::CommandPool transferCommandPool;
+    static vk::Queue       transferQueue;
+    static uint32_t        transferQueueFamily;
 };
 
 } // namespace TBE::Graphics
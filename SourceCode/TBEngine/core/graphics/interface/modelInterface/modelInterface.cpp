@@ -1,47 +1,104 @@
 #include "modelInterface.hpp"
 #include "TBEngine/core/graphics/graphics.hpp"
 
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <string>
+
 namespace TBE::Graphics {
+using Math::DataFormat::Vertex;
 
-void ModelInterface::destroy() {
-    vertBufs.clear();
-    idxBufs.clear();
+template <typename T, size_t N>
+static std::span<std::byte> toBytes(std::array<T, N>& arr) {
+    return std::span<std::byte>(static_cast<std::byte*>(static_cast<void*>(arr.data())),
+                                arr.size() * sizeof(T));
 }
 
-void ModelInterface::read(const std::span<std::byte> vertices,
-                          const std::span<std::byte> indices,
-                          const size_t               idxSize) {
-    idxSizes.emplace_back(idxSize);
-    auto& vertBuf = vertBufs.emplace_back();
-    auto& idxBuf  = idxBufs.emplace_back();
-    vertBuf.init(vertices,
-                 vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                 vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-    idxBuf.init(indices,
-                vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                vk::MemoryPropertyFlagBits::eDeviceLocal);
+void ModelInterface::destroy() {
+    geometry.destroy();
+    meshes.clear();
+    meshDescs.clear();
+    meshlets.clear();
+    textures.clear();
+    ready.clear();
+    placeholder = GeometryPool::nullMesh;
 }
 
-const vk::Buffer& ModelInterface::getVertBuffer(uint32_t idx) {
-    return vertBufs[idx].buffer;
-}
+void ModelInterface::initPlaceholder() {
+    // a unit cube in the float layout, it needs no quantization
+    std::array<Vertex, 8> vertices{};
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[i].pos      = {i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f};
+        vertices[i].color    = {1.0f, 1.0f, 1.0f};
+        vertices[i].texCoord = {i & 1 ? 1.0f : 0.0f, i & 2 ? 1.0f : 0.0f};
+    }
+    std::array<uint16_t, 36> indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                                        2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+
+    placeholderDesc              = {};
+    placeholderDesc.vertexLayout = Math::DataFormat::VertexLayout::eFloat;
+    placeholderDesc.idxStride    = sizeof(uint16_t);
+    placeholderDesc.idxCount     = indices.size();
+    placeholderDesc.bounds       = {0.0f, 0.0f, 0.0f, std::sqrt(0.75f)};
+    placeholderDesc.boxMin       = glm::vec3(-0.5f);
+    placeholderDesc.boxMax       = glm::vec3(0.5f);
+    placeholderDesc.lods[0]      = {0, static_cast<uint32_t>(indices.size()), 0.0f};
 
-const vk::Buffer& ModelInterface::getIdxBuffer(uint32_t idx) {
-    return idxBufs[idx].buffer;
+    UploadBatch batch{};
+    placeholder = geometry.add(toBytes(vertices), toBytes(indices), {}, placeholderDesc, batch);
+    batch.submit();
 }
 
-const vk::Sampler& ModelInterface::getTextureSampler(uint32_t idx) {
-    return Graphics::VulkanGraphics::textureInterface.sampler;
+uint32_t ModelInterface::reserve() {
+    meshes.emplace_back(GeometryPool::nullMesh);
+    meshDescs.emplace_back();
+    meshlets.emplace_back();
+    textures.emplace_back(0);
+    ready.emplace_back(false);
+    return size() - 1;
 }
 
-const vk::ImageView& ModelInterface::getTextureImageView(uint32_t idx) {
-    return Graphics::VulkanGraphics::textureInterface.imageR.imageView;
+void ModelInterface::read(uint32_t                          idx,
+                          const std::span<std::byte>        vertices,
+                          const std::span<std::byte>        indices,
+                          const std::span<std::byte>        meshletsByte,
+                          const Math::DataFormat::MeshDesc& meshDesc) {
+    UploadBatch batch{};
+    upload(idx, vertices, indices, meshletsByte, meshDesc, batch);
+    batch.submit();
+    setReady(idx);
 }
 
-const size_t ModelInterface::getIdxSize(uint32_t idx) {
-    return idxSizes[idx];
+void ModelInterface::upload(uint32_t                          idx,
+                            const std::span<std::byte>        vertices,
+                            const std::span<std::byte>        indices,
+                            const std::span<std::byte>        meshletsByte,
+                            const Math::DataFormat::MeshDesc& meshDesc,
+                            UploadBatch&                      batch) {
+    if (ready[idx] || meshes[idx] != GeometryPool::nullMesh) {
+        Utils::Log::logErrorMsg("mesh slot " + std::to_string(idx) + " is uploaded already");
+    }
+    meshDescs[idx] = meshDesc;
+    meshlets[idx].resize(meshletsByte.size() / sizeof(Math::DataFormat::Meshlet));
+    std::memcpy(meshlets[idx].data(), meshletsByte.data(), meshletsByte.size());
+    meshes[idx] = geometry.add(vertices, indices, meshletsByte, meshDesc, batch);
 }
 
+void ModelInterface::release(uint32_t idx) {
+    if (meshes[idx] == GeometryPool::nullMesh) {
+        return;
+    }
+    // the range may only be handed out again once the copies into it are done
+    if (!ready[idx]) {
+        auto& context = VulkanGraphics::uploadContext;
+        context.wait(context.getTicket());
+    }
+    geometry.remove(meshes[idx]);
+    meshes[idx]    = GeometryPool::nullMesh;
+    meshDescs[idx] = {};
+    ready[idx]     = false;
+    meshlets[idx].clear();
+}
 
 } // namespace TBE::Graphics
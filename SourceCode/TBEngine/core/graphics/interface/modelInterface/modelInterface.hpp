@@ -1,31 +1,82 @@
 #pragma once
 #include "TBEngine/utils/includes/includeVulkan.hpp"
-#include "TBEngine/core/graphics/vulkanAbstract/bufferResource/bufferResource.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/geometryPool/geometryPool.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/uploadBatch/uploadBatch.hpp"
+#include "TBEngine/core/math/dataFormat.hpp"
 
 #include <vector>
 
 namespace TBE::Graphics {
 
+// meshes live in slots, a slot is drawn as the placeholder cube until its upload is done
+// the meshes themselves are ranges of the shared geometry pool
 class ModelInterface {
 public:
     void destroy();
+    // once per frame, after the fence of the frame about to be recorded has been waited for
+    void tick() { geometry.tick(); }
+    void report() { geometry.report(); }
 
 public:
-    void read(const std::span<std::byte> vertices,
-              const std::span<std::byte> indices,
-              const size_t               idxSize);
+    // upload the placeholder cube, has to be called before any slot is drawn
+    void initPlaceholder();
+
+    [[nodiscard]] uint32_t reserve();
+    uint32_t               size() const { return static_cast<uint32_t>(meshDescs.size()); }
+
+    // upload into the slot and wait for it, meshlets holds Math::DataFormat::Meshlet
+    void read(uint32_t                          idx,
+              const std::span<std::byte>        vertices,
+              const std::span<std::byte>        indices,
+              const std::span<std::byte>        meshlets,
+              const Math::DataFormat::MeshDesc& meshDesc);
+
+    // same as read(), but only records the upload into batch, call setReady() once it is done
+    void upload(uint32_t                          idx,
+                const std::span<std::byte>        vertices,
+                const std::span<std::byte>        indices,
+                const std::span<std::byte>        meshlets,
+                const Math::DataFormat::MeshDesc& meshDesc,
+                UploadBatch&                      batch);
+    void setReady(uint32_t idx) { ready[idx] = true; }
+    bool isReady(uint32_t idx) const { return ready[idx]; }
+
+    // the slot shows the placeholder again, its range is reused once no frame draws it anymore
+    void release(uint32_t idx);
+    // pack the meshes of the geometry pool, waits for the device
+    void compact() { geometry.compact(); }
 
 public:
-    const vk::Buffer&    getVertBuffer(uint32_t idx);
-    const vk::Buffer&    getIdxBuffer(uint32_t idx);
-    const vk::Sampler&   getTextureSampler(uint32_t idx);
-    const vk::ImageView& getTextureImageView(uint32_t idx);
-    const size_t         getIdxSize(uint32_t idx);
+    // the getters below fall back to the placeholder for slots that are not ready
+    GeometryPool::MeshHandle getMesh(uint32_t idx) const {
+        return ready[idx] ? meshes[idx] : placeholder;
+    }
+    const GeometryPool& getGeometry() const { return geometry; }
+
+    // the material of a slot, its element in the texture table of TextureInterface, the table
+    // shows the placeholder until that texture is ready
+    void     setTexture(uint32_t idx, uint32_t texture) { textures[idx] = texture; }
+    uint32_t getTexture(uint32_t idx) const { return textures[idx]; }
+
+    const Math::DataFormat::MeshDesc& getMeshDesc(uint32_t idx) {
+        return ready[idx] ? meshDescs[idx] : placeholderDesc;
+    }
+    // a copy of what was uploaded, for culling on the CPU
+    std::span<const Math::DataFormat::Meshlet> getMeshlets(uint32_t idx) const {
+        return ready[idx] ? std::span<const Math::DataFormat::Meshlet>(meshlets[idx])
+                          : std::span<const Math::DataFormat::Meshlet>();
+    }
 
 private:
-    std::vector<Graphics::BufferResource> vertBufs{};
-    std::vector<Graphics::BufferResource> idxBufs{};
-    std::vector<size_t>                   idxSizes{};
+    GeometryPool                                        geometry{};
+    std::vector<GeometryPool::MeshHandle>               meshes{};
+    std::vector<Math::DataFormat::MeshDesc>             meshDescs{};
+    std::vector<std::vector<Math::DataFormat::Meshlet>> meshlets{};
+    std::vector<uint32_t>                               textures{};
+    std::vector<bool>                                   ready{};
+
+    GeometryPool::MeshHandle   placeholder = GeometryPool::nullMesh;
+    Math::DataFormat::MeshDesc placeholderDesc{};
 };
 
 } // namespace TBE::Graphics
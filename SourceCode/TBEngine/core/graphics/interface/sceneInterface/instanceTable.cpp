@@ -0,0 +1,147 @@
+#include "instanceTable.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <algorithm>
+
+namespace TBE::Graphics {
+using Math::DataFormat::ObjectData;
+
+InstanceHandle InstanceTable::add(uint32_t slotIdx, const ObjectData& data) {
+    if (slotIdx >= slots.size()) {
+        slots.resize(slotIdx + 1);
+    }
+
+    InstanceHandle handle{};
+    if (freeHandles.empty()) {
+        handle = static_cast<InstanceHandle>(instances.size());
+        instances.emplace_back();
+    } else {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+
+    auto& slot = slots[slotIdx];
+    auto  idx  = static_cast<uint32_t>(slot.instances.size());
+    slot.instances.push_back(data);
+    slot.instances.back().slot = slotIdx;
+    slot.handles.push_back(handle);
+    instances[handle] = {slotIdx, idx};
+    instanceCount++;
+
+    if (slot.instances.size() > slot.capacity) {
+        relayout = true;
+    } else {
+        markDirty(slot, idx);
+    }
+    return handle;
+}
+
+void InstanceTable::set(InstanceHandle instance, const ObjectData& data) {
+    if (instance >= instances.size() || instances[instance].slot == UINT32_MAX) {
+        Utils::Log::logErrorMsg("set an instance that does not exist");
+    }
+    auto [slotIdx, idx]                = instances[instance];
+    slots[slotIdx].instances[idx]      = data;
+    slots[slotIdx].instances[idx].slot = slotIdx;
+    markDirty(slots[slotIdx], idx);
+}
+
+const ObjectData& InstanceTable::get(InstanceHandle instance) const {
+    if (!contains(instance)) {
+        Utils::Log::logErrorMsg("get an instance that does not exist");
+    }
+    auto [slotIdx, idx] = instances[instance];
+    return slots[slotIdx].instances[idx];
+}
+
+void InstanceTable::remove(InstanceHandle instance) {
+    if (instance >= instances.size() || instances[instance].slot == UINT32_MAX) {
+        Utils::Log::logErrorMsg("remove an instance that does not exist");
+    }
+    auto [slotIdx, idx] = instances[instance];
+    auto& slot          = slots[slotIdx];
+
+    // the last instance of the slot takes the place, the range stays contiguous
+    auto last = static_cast<uint32_t>(slot.instances.size() - 1);
+    if (idx != last) {
+        slot.instances[idx]                = slot.instances[last];
+        slot.handles[idx]                  = slot.handles[last];
+        instances[slot.handles[idx]].index = idx;
+        markDirty(slot, idx);
+    }
+    // the entry left behind is cleared, so nothing reading the packed array takes it for one
+    markDirty(slot, last);
+    slot.instances.pop_back();
+    slot.handles.pop_back();
+
+    instances[instance] = {};
+    freeHandles.push_back(instance);
+    instanceCount--;
+}
+
+void InstanceTable::clear() {
+    slots.clear();
+    instances.clear();
+    freeHandles.clear();
+    packed.clear();
+    instanceCount = 0;
+    relayout      = false;
+}
+
+void InstanceTable::compact() {
+    // give the room back once most of the array is left over by removed instances
+    if (packed.size() > 64 && packed.size() > instanceCount * 4) {
+        relayout = true;
+    }
+    if (relayout) {
+        layout();
+        return;
+    }
+
+    for (auto& slot : slots) {
+        if (slot.dirtyBegin >= slot.dirtyEnd) {
+            continue;
+        }
+        auto count = static_cast<uint32_t>(slot.instances.size());
+        auto end   = std::min(slot.dirtyEnd, count);
+        if (slot.dirtyBegin < end) {
+            std::copy(slot.instances.begin() + slot.dirtyBegin,
+                      slot.instances.begin() + end,
+                      packed.begin() + slot.first + slot.dirtyBegin);
+        }
+        if (slot.dirtyEnd > count) {
+            std::fill(packed.begin() + slot.first + std::max(slot.dirtyBegin, count),
+                      packed.begin() + slot.first + slot.dirtyEnd,
+                      ObjectData{});
+        }
+        slot.dirtyBegin = UINT32_MAX;
+        slot.dirtyEnd   = 0;
+    }
+}
+
+void InstanceTable::markDirty(Slot& slot, uint32_t index) {
+    slot.dirtyBegin = std::min(slot.dirtyBegin, index);
+    slot.dirtyEnd   = std::max(slot.dirtyEnd, index + 1);
+}
+
+// every slot gets half its count again as room to grow, so adding a few instances later does not
+// move the other slots
+void InstanceTable::layout() {
+    uint32_t first = 0;
+    for (auto& slot : slots) {
+        auto count    = static_cast<uint32_t>(slot.instances.size());
+        slot.first    = first;
+        slot.capacity = count + count / 2;
+        first += slot.capacity;
+    }
+
+    packed.assign(first, ObjectData{});
+    for (auto& slot : slots) {
+        std::copy(slot.instances.begin(), slot.instances.end(), packed.begin() + slot.first);
+        slot.dirtyBegin = UINT32_MAX;
+        slot.dirtyEnd   = 0;
+    }
+    relayout = false;
+}
+
+} // namespace TBE::Graphics
@@ -0,0 +1,83 @@
+#pragma once
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// stays valid until the instance is removed
+using InstanceHandle                         = uint32_t;
+static constexpr InstanceHandle nullInstance = UINT32_MAX;
+
+/**
+ * @brief The instances of every model slot, packed into one array drawn with one call per slot.
+ *
+ * @details The instances of a slot are a contiguous range of the packed array, followed by some
+ * room to grow, so its draw is a single drawIndexed with firstInstance at the start of the range.
+ * Removing an instance moves the last one of the slot into its place, the room is filled with
+ * entries whose slot is UINT32_MAX. Changes only mark the entries they touch, compact() copies
+ * just those into the packed array, unless a slot outgrew its room or the array is mostly empty
+ * room, then every range is laid out again.
+ */
+class InstanceTable {
+public:
+    [[nodiscard]] InstanceHandle add(uint32_t slot, const Math::DataFormat::ObjectData& data);
+    void set(InstanceHandle instance, const Math::DataFormat::ObjectData& data);
+    void remove(InstanceHandle instance);
+    void clear();
+
+    // bring the packed array up to date, once per frame before it is read
+    void compact();
+
+public:
+    // valid after compact()
+    std::span<const Math::DataFormat::ObjectData> getPacked() const { return packed; }
+    uint32_t getFirst(uint32_t slot) const { return slot < slots.size() ? slots[slot].first : 0; }
+    uint32_t getCount(uint32_t slot) const {
+        return slot < slots.size() ? static_cast<uint32_t>(slots[slot].instances.size()) : 0;
+    }
+    // where the instance is in the packed array
+    uint32_t getPackedIndex(InstanceHandle instance) const {
+        return slots[instances[instance].slot].first + instances[instance].index;
+    }
+
+    bool contains(InstanceHandle instance) const {
+        return instance < instances.size() && instances[instance].slot != UINT32_MAX;
+    }
+    const Math::DataFormat::ObjectData& get(InstanceHandle instance) const;
+    std::span<const InstanceHandle>     getHandles(uint32_t slot) const {
+        return slot < slots.size() ? std::span<const InstanceHandle>{slots[slot].handles}
+                                       : std::span<const InstanceHandle>{};
+    }
+
+private:
+    struct Slot {
+        std::vector<Math::DataFormat::ObjectData> instances{};
+        std::vector<InstanceHandle>               handles{}; // the owner of every instance
+        uint32_t                                  first{};
+        uint32_t                                  capacity{};
+        uint32_t                                  dirtyBegin = UINT32_MAX;
+        uint32_t                                  dirtyEnd{};
+    };
+
+    struct Instance {
+        uint32_t slot = UINT32_MAX; // UINT32_MAX for an unused handle
+        uint32_t index{};
+    };
+
+private:
+    void markDirty(Slot& slot, uint32_t index);
+    void layout();
+
+private:
+    std::vector<Slot>                         slots{};
+    std::vector<Instance>                     instances{};
+    std::vector<InstanceHandle>               freeHandles{};
+    std::vector<Math::DataFormat::ObjectData> packed{};
+    uint32_t                                  instanceCount{};
+    bool                                      relayout = false;
+};
+
+} // namespace TBE::Graphics
@@ -1,44 +1,601 @@
 #include "sceneInterface.hpp"
 #include "TBEngine/core/graphics/graphics.hpp"
+#include "TBEngine/core/math/frustum/frustum.hpp"
+#include "TBEngine/settings.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
 
 namespace TBE::Graphics {
+using Math::DataFormat::ClusterInstance;
+using Math::DataFormat::DrawData;
+using Math::DataFormat::FrameData;
+using Math::DataFormat::Meshlet;
+using Math::DataFormat::ObjectData;
+
+static constexpr uint32_t drawCommandSize = sizeof(vk::DrawIndexedIndirectCommand);
 
 void SceneInterface::destroy() {
-    std::for_each(uniformBufferRs.begin(),
-                  uniformBufferRs.end(),
-                  [](Graphics::BufferResourceUniform& buffer) { buffer.destroy(); });
+    instances.clear();
+    cullChecks.clear();
+    bvh.clear();
+    changed.clear();
+    slotBoxes.clear();
+    lodOf.clear();
+    clusters.clear();
+    clusterReadbacks.clear();
+}
+
+InstanceHandle SceneInterface::addInstance(uint32_t idx, const ObjectData& data) {
+    auto instance = instances.add(idx, data);
+    changed.push_back(instance);
+    if (instance >= lodOf.size()) {
+        lodOf.resize(instance + 1);
+    }
+    lodOf[instance] = 0;
+    return instance;
+}
+
+void SceneInterface::setInstance(InstanceHandle instance, const ObjectData& data) {
+    instances.set(instance, data);
+    changed.push_back(instance);
+}
+
+void SceneInterface::removeInstance(InstanceHandle instance) {
+    instances.remove(instance);
+    changed.push_back(instance);
+}
+
+InstanceHandle SceneInterface::pick(const glm::vec3& origin, const glm::vec3& direction) {
+    updateBvh();
+    return bvh.raycast(origin, direction).item;
+}
+
+void SceneInterface::prepareGPU(const vk::CommandBuffer& cmdBuffer) {
+    auto& modelInterface = Graphics::VulkanGraphics::modelInterface;
+    auto& frameRing      = Graphics::VulkanGraphics::frameRing;
+    auto& cullPass       = Graphics::VulkanGraphics::cullPass;
+    auto  frame          = frameRing.getFrame();
+
+    // the ring of this frame has been handed back after its fence, nothing reads it anymore and
+    // the results of the culling pass recorded with it last time are in
+    if (GPU_CULLING_VALIDATION) {
+        checkCulling(frame);
+    }
+    readClusterStats(frame);
+
+    // the culling pass packs the meshlets it keeps, which needs the draw counts
+    draws.culled   = cullPass.isEnabled();
+    clusterCulling = CLUSTER_CULLING && (!draws.culled || cullPass.hasDrawCount());
+
+    draws.frame = frameRing.allocate(sizeof(FrameData));
+    std::memcpy(draws.frame.data, &frameData, sizeof(FrameData));
+
+    // only the changed instances are packed again, the whole array goes into the ring with the
+    // level of detail of every instance
+    instances.compact();
+    auto  packed      = instances.getPacked();
+    auto  objectCount = static_cast<uint32_t>(packed.size());
+    auto  objectAlloc = frameRing.allocateArray(std::max(objectCount, 1u), sizeof(ObjectData));
+    auto* objects     = static_cast<ObjectData*>(objectAlloc.data);
+    auto  objectBase  = objectAlloc.offset / static_cast<uint32_t>(sizeof(ObjectData));
+    std::copy(packed.begin(), packed.end(), objects);
+    selectLods(packed, objects);
+    auto clusterIds = collectClusters(packed, objects, objectBase);
+
+    // one command per level of every slot that has an instance, grouped by geometry pool, so a
+    // pool draws a contiguous run of them, the pass packs the meshlets it keeps behind them
+    const auto& geometry  = modelInterface.getGeometry();
+    auto        slotCount = modelInterface.size();
+    auto        poolCount = GeometryPool::getPoolCount();
+    draws.poolFirst.assign(poolCount, 0);
+    draws.poolSize.assign(poolCount, 0);
+    draws.packedFirst.assign(poolCount, 0);
+    draws.packedSize.assign(poolCount, 0);
+    for (uint32_t idx = 0; idx < slotCount; idx++) {
+        if (instances.getCount(idx) > 0) {
+            auto pool = geometry.getPool(modelInterface.getMesh(idx));
+            draws.poolSize[pool] += modelInterface.getMeshDesc(idx).lodCount;
+        }
+    }
+    uint32_t commandCount = 0;
+    uint32_t packedCount  = 0;
+    for (uint32_t pool = 0; pool < poolCount; pool++) {
+        draws.poolFirst[pool] = commandCount;
+        commandCount += draws.poolSize[pool];
+        draws.packedFirst[pool] = packedCount;
+        draws.packedSize[pool]  = draws.poolSize[pool] + clusterCapacity[pool];
+        packedCount += draws.packedSize[pool];
+    }
+
+    // every level of a slot has room for the ids of all its instances, every cluster instance
+    // has one of its own behind them
+    uint32_t idCount = 0;
+    for (uint32_t idx = 0; idx < slotCount; idx++) {
+        idCount += instances.getCount(idx) * modelInterface.getMeshDesc(idx).lodCount;
+    }
+    auto drawAlloc = frameRing.allocateArray(std::max(slotCount, 1u), sizeof(DrawData));
+    auto idAlloc = frameRing.allocateArray(std::max(idCount + clusterIds, 1u), sizeof(uint32_t));
+    draws.drawBase = drawAlloc.offset / static_cast<uint32_t>(sizeof(DrawData));
+    auto idBase    = idAlloc.offset / static_cast<uint32_t>(sizeof(uint32_t));
+
+    // the culling pass raises instanceCount and writes the ids, without it the CPU culls them
+    auto*    drawData = static_cast<DrawData*>(drawAlloc.data);
+    auto     next     = draws.poolFirst;
+    uint32_t nextId   = idBase;
+    draws.commandList.assign(commandCount, vk::DrawIndexedIndirectCommand{});
+    draws.slotCommand.assign(slotCount, UINT32_MAX);
+    for (uint32_t idx = 0; idx < slotCount; idx++) {
+        auto  mesh     = modelInterface.getMesh(idx);
+        auto& meshDesc = modelInterface.getMeshDesc(idx);
+        auto  count    = instances.getCount(idx);
+
+        DrawData draw{};
+        draw.quantization = meshDesc.quantization;
+        draw.bounds       = meshDesc.bounds;
+        draw.texture      = modelInterface.getTexture(idx);
+        if (count > 0) {
+            const auto& range = geometry.getRange(mesh);
+            draw.pool         = geometry.getPool(mesh);
+            draw.poolFirst    = draws.packedFirst[draw.pool];
+            draw.command      = next[draw.pool];
+            draw.lodCount     = meshDesc.lodCount;
+            draw.firstMeshlet = range.firstMeshlet;
+            draw.meshletCount = range.meshletCount;
+            next[draw.pool] += meshDesc.lodCount;
+
+            for (uint32_t lod = 0; lod < meshDesc.lodCount; lod++) {
+                draws.commandList[draw.command + lod] = {meshDesc.lods[lod].indexCount,
+                                                         0,
+                                                         range.firstIndex +
+                                                             meshDesc.lods[lod].firstIndex,
+                                                         range.vertexOffset,
+                                                         nextId};
+                nextId += count;
+            }
+            draws.slotCommand[idx] = draw.command;
+        }
+        drawData[idx] = draw;
+    }
+
+    updateBvh();
+    if (!draws.culled) {
+        cullOnCpu(packed, static_cast<uint32_t*>(idAlloc.data), idBase, objectBase, nextId);
+        return;
+    }
+    if (LOD_BENCHMARK_SCENE) {
+        countTriangles();
+    }
+
+    // the id of a cluster instance is its object, every command of a meshlet draws it once
+    auto* ids          = static_cast<uint32_t*>(idAlloc.data);
+    auto  clusterCount = static_cast<uint32_t>(clusters.size());
+    auto  clusterAlloc =
+        frameRing.allocateArray(std::max(clusterCount, 1u), sizeof(ClusterInstance));
+    auto statAlloc = frameRing.allocateArray(2, sizeof(uint32_t));
+    for (auto& cluster : clusters) {
+        ids[nextId - idBase] = cluster.object;
+        cluster.id           = nextId++;
+    }
+    std::copy(clusters.begin(), clusters.end(), static_cast<ClusterInstance*>(clusterAlloc.data));
+    std::fill_n(static_cast<uint32_t*>(statAlloc.data), 2, 0u);
+
+    draws.commands = frameRing.allocateArray(std::max(commandCount, 1u), drawCommandSize);
+    draws.packed   = frameRing.allocateArray(std::max(packedCount, 1u), drawCommandSize);
+    draws.counts   = frameRing.allocateArray(poolCount, sizeof(uint32_t));
+    std::copy(draws.commandList.begin(),
+              draws.commandList.end(),
+              static_cast<vk::DrawIndexedIndirectCommand*>(draws.commands.data));
+    std::fill_n(static_cast<uint32_t*>(draws.counts.data), poolCount, 0u);
+
+    CullParams params{};
+    params.objectBase   = objectBase;
+    params.objectCount  = objectCount;
+    params.drawBase     = draws.drawBase;
+    params.slotCount    = slotCount;
+    params.commandBase  = draws.commands.offset / drawCommandSize;
+    params.idBase       = idBase;
+    params.packedBase   = draws.packed.offset / drawCommandSize;
+    params.countBase    = draws.counts.offset / static_cast<uint32_t>(sizeof(uint32_t));
+    params.clusterBase  = clusterAlloc.offset / static_cast<uint32_t>(sizeof(ClusterInstance));
+    params.clusterCount = clusterCount;
+    params.statBase     = statAlloc.offset / static_cast<uint32_t>(sizeof(uint32_t));
+    cullPass.record(
+        cmdBuffer, frame, draws.frame.offset, params, geometry.getMeshletBuffer(), maxMeshlets);
+
+    if (clusterReadbacks.size() <= frame) {
+        clusterReadbacks.resize(frame + 1);
+    }
+    clusterReadbacks[frame] = {static_cast<const uint32_t*>(statAlloc.data), clusterMeshlets};
+    if (GPU_CULLING_VALIDATION) {
+        expectCulling(idAlloc, idBase, objectBase, objects);
+    }
 }
 
-void SceneInterface::tickGPU(const vk::CommandBuffer& cmdBuffer, const vk::PipelineLayout& layout) {
-    std::array vertexBuffers = {Graphics::VulkanGraphics::modelInterface.getVertBuffer(0)};
-    std::array<vk::DeviceSize, vertexBuffers.size()> offsets = {0};
-    cmdBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
-    cmdBuffer.bindIndexBuffer(
-        Graphics::VulkanGraphics::modelInterface.getIdxBuffer(0), 0, vk::IndexType::eUint32);
+void SceneInterface::tickGPU(const vk::CommandBuffer&      cmdBuffer,
+                             const vk::PipelineLayout&     layout,
+                             std::span<const vk::Pipeline> pipelines) {
+    auto& modelInterface = Graphics::VulkanGraphics::modelInterface;
+    auto& descriptors    = Graphics::VulkanGraphics::shaderInterface.descriptors;
+    auto& frameRing      = Graphics::VulkanGraphics::frameRing;
+    auto& cullPass       = Graphics::VulkanGraphics::cullPass;
+    auto  frame          = frameRing.getFrame();
+
+    // the fence of this frame has been waited for, so its set can take the newly streamed textures
+    auto& textureInterface = Graphics::VulkanGraphics::textureInterface;
+    descriptors.updateTextures(
+        frame, textureInterface.getTable(), textureInterface.getTableVersion());
+    std::array<vk::DescriptorSet, 2> sets{descriptors.sets[frame], descriptors.tableSets[frame]};
     cmdBuffer.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
-        layout,
-        0,
-        Graphics::VulkanGraphics::shaderInterface.descriptors.sets[currentFrame],
-        static_cast<uint32_t>(0));
-    cmdBuffer.drawIndexed(
-        static_cast<uint32_t>(Graphics::VulkanGraphics::modelInterface.getIdxSize(0)), 1, 0, 0, 0);
-}
-
-void SceneInterface::updateUniformBuffer(std::span<std::byte> data) {
-    uniformBufferRs[currentFrame].update(data);
-}
-
-void SceneInterface::initUniformBuffer() {
-    vk::DeviceSize bufferSize = sizeof(Math::DataFormat::UniformBufferObject);
-    uniformBufferRs.resize(MAX_FRAMES_IN_FLIGHT);
-    std::for_each(uniformBufferRs.begin(),
-                  uniformBufferRs.end(),
-                  [bufferSize](Graphics::BufferResourceUniform& buffer) {
-                      buffer.init(bufferSize,
-                                  Graphics::VulkanGraphics::phyDevice.getMemoryProperties());
-                  });
+        vk::PipelineBindPoint::eGraphics, layout, 0, sets, draws.frame.offset);
+    cmdBuffer.pushConstants(
+        layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(uint32_t), &draws.drawBase);
+
+    // every pool of the geometry is bound once and draws its run of commands, slots still
+    // streaming are drawn with the placeholder mesh
+    const auto& geometry = modelInterface.getGeometry();
+    for (uint32_t pool = 0; pool < GeometryPool::getPoolCount(); pool++) {
+        auto first = draws.poolFirst[pool];
+        auto size  = draws.poolSize[pool];
+        if (size == 0) {
+            continue;
+        }
+
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                               pipelines[static_cast<size_t>(GeometryPool::getVertexLayout(pool))]);
+        std::array vertexBuffers = {geometry.getVertBuffer(pool)};
+        std::array<vk::DeviceSize, vertexBuffers.size()> offsets = {0};
+        cmdBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
+        cmdBuffer.bindIndexBuffer(geometry.getIdxBuffer(pool), 0, geometry.getIdxType(pool));
+
+        // without the draw counts there are no meshlet commands and packedSize is size
+        if (draws.culled) {
+            cullPass.drawIndirect(cmdBuffer,
+                                  draws.commands.buffer,
+                                  draws.commands.offset + first * drawCommandSize,
+                                  draws.packed.offset + draws.packedFirst[pool] * drawCommandSize,
+                                  draws.counts.offset + pool * sizeof(uint32_t),
+                                  draws.packedSize[pool]);
+            continue;
+        }
+        for (uint32_t i = first; i < first + size; i++) {
+            const auto& command = draws.commandList[i];
+            if (command.instanceCount == 0) {
+                continue;
+            }
+            cmdBuffer.drawIndexed(command.indexCount,
+                                  command.instanceCount,
+                                  command.firstIndex,
+                                  command.vertexOffset,
+                                  command.firstInstance);
+        }
+        for (const auto& command : draws.clusterLists[pool]) {
+            cmdBuffer.drawIndexed(command.indexCount,
+                                  command.instanceCount,
+                                  command.firstIndex,
+                                  command.vertexOffset,
+                                  command.firstInstance);
+        }
+    }
+}
+
+// the instances of a slot whose mesh has been streamed in since get the box of the real mesh
+// instead of the placeholder one
+void SceneInterface::updateBvh() {
+    auto& modelInterface = Graphics::VulkanGraphics::modelInterface;
+    auto  slotCount      = modelInterface.size();
+
+    slotBoxes.resize(slotCount);
+    for (uint32_t idx = 0; idx < slotCount; idx++) {
+        const auto& meshDesc = modelInterface.getMeshDesc(idx);
+        Math::Aabb  box{meshDesc.boxMin, meshDesc.boxMax};
+        if (!(slotBoxes[idx] == box)) {
+            slotBoxes[idx] = box;
+            auto handles   = instances.getHandles(idx);
+            changed.insert(changed.end(), handles.begin(), handles.end());
+        }
+    }
+
+    for (auto instance : changed) {
+        if (!instances.contains(instance)) {
+            bvh.remove(instance);
+            continue;
+        }
+        const auto& data = instances.get(instance);
+        bvh.set(instance, Math::transformAabb(data.model, slotBoxes[data.slot]));
+    }
+    changed.clear();
+    bvh.update();
+}
+
+// every instance starts from the level it was drawn with last frame, so the selector can hold it
+// serial, a selection is a few flops, less than starting threads for it every frame
+void SceneInterface::selectLods(std::span<const ObjectData> packed, ObjectData* objects) {
+    auto& modelInterface = Graphics::VulkanGraphics::modelInterface;
+    lodSelector.setView(frameData.view,
+                        frameData.proj,
+                        static_cast<float>(Graphics::VulkanGraphics::extent.height),
+                        LOD_PIXEL_ERROR,
+                        LOD_HYSTERESIS);
+
+    for (uint32_t idx = 0; idx < modelInterface.size(); idx++) {
+        const auto& meshDesc = modelInterface.getMeshDesc(idx);
+        auto        lods     = std::span(meshDesc.lods).first(meshDesc.lodCount);
+        auto        handles  = instances.getHandles(idx);
+        auto        first    = instances.getFirst(idx);
+        for (size_t i = 0; i < handles.size(); i++) {
+            const auto& model = packed[first + i].model;
+            auto&       lod   = lodOf[handles[i]];
+            auto        next  = lodSelector.select(lods, model, meshDesc.bounds, lod);
+            lod               = static_cast<uint8_t>(next);
+            objects[first + i].lod     = next;
+            objects[first + i].cluster = UINT32_MAX; // set by collectClusters()
+        }
+    }
+}
+
+// the cluster instances of the frame and the meshlets they have, CLUSTER_DRAW_BUDGET and the
+// group rows of the meshlet dispatch bound how many the culling pass gets, the rest are drawn whole
+// returns how many ids they need, one each
+uint32_t SceneInterface::collectClusters(std::span<const ObjectData> packed,
+                                         ObjectData*                 objects,
+                                         uint32_t                    objectBase) {
+    auto& modelInterface = Graphics::VulkanGraphics::modelInterface;
+    auto  eye            = glm::vec3(glm::inverse(frameData.view)[3]);
+
+    clusters.clear();
+    clusterCapacity.assign(GeometryPool::getPoolCount(), 0);
+    maxMeshlets     = 0;
+    clusterMeshlets = 0;
+    if (!clusterCulling) {
+        return 0;
+    }
+
+    uint32_t instanceCount = 0;
+    uint32_t budget        = CLUSTER_DRAW_BUDGET;
+    for (uint32_t idx = 0; idx < modelInterface.size(); idx++) {
+        auto meshletCount = static_cast<uint32_t>(modelInterface.getMeshlets(idx).size());
+        if (meshletCount == 0 || instances.getCount(idx) == 0) {
+            continue;
+        }
+        auto pool    = modelInterface.getGeometry().getPool(modelInterface.getMesh(idx));
+        auto handles = instances.getHandles(idx);
+        auto first   = instances.getFirst(idx);
+        for (uint32_t i = 0; i < handles.size(); i++) {
+            if (lodOf[handles[i]] != 0) {
+                continue;
+            }
+            // the CPU draws its meshlets from a list of its own, whatever their count
+            if (!draws.culled) {
+                clusterMeshlets += meshletCount;
+                instanceCount++;
+                continue;
+            }
+            if (meshletCount > budget || clusters.size() == CullPass::maxClusterInstances) {
+                continue;
+            }
+
+            ClusterInstance cluster{};
+            cluster.eye    = glm::inverse(packed[first + i].model) * glm::vec4(eye, 1.0f);
+            cluster.object = objectBase + first + i;
+            objects[first + i].cluster = static_cast<uint32_t>(clusters.size());
+            clusters.push_back(cluster);
+
+            budget -= meshletCount;
+            clusterMeshlets += meshletCount;
+            clusterCapacity[pool] += meshletCount;
+            maxMeshlets = std::max(maxMeshlets, meshletCount);
+        }
+    }
+    return draws.culled ? static_cast<uint32_t>(clusters.size()) : instanceCount;
+}
+
+// the visible instances of a level are written to the front of its ids, in no particular order,
+// the cluster instances get an id each from clusterId on
+void SceneInterface::cullOnCpu(std::span<const ObjectData> packed,
+                               uint32_t*                   ids,
+                               uint32_t                    idBase,
+                               uint32_t                    objectBase,
+                               uint32_t                    clusterId) {
+    auto&       modelInterface = Graphics::VulkanGraphics::modelInterface;
+    const auto& geometry       = modelInterface.getGeometry();
+
+    auto        eye            = glm::vec3(glm::inverse(frameData.view)[3]);
+
+    visible.clear();
+    bvh.queryFrustum(frameData.frustum, visible);
+
+    draws.clusterLists.resize(GeometryPool::getPoolCount());
+    for (auto& list : draws.clusterLists) {
+        list.clear();
+    }
+    drawnTriangles = fullTriangles = 0;
+    clustersBackfacing             = 0;
+    uint32_t kept                  = 0;
+    for (auto instance : visible) {
+        auto  idx     = instances.getPackedIndex(instance);
+        auto  slot    = packed[idx].slot;
+        auto  first   = draws.slotCommand[slot];
+        auto& command = draws.commandList[first + lodOf[instance]];
+        fullTriangles += draws.commandList[first].indexCount / 3;
+
+        auto meshlets = modelInterface.getMeshlets(slot);
+        if (clusterCulling && lodOf[instance] == 0 && !meshlets.empty()) {
+            const auto& model       = packed[idx].model;
+            ids[clusterId - idBase] = objectBase + idx;
+            kept += cullMeshlets(model,
+                                 glm::vec3(glm::inverse(model) * glm::vec4(eye, 1.0f)),
+                                 meshlets,
+                                 command,
+                                 clusterId++,
+                                 geometry.getPool(modelInterface.getMesh(slot)));
+            continue;
+        }
+        ids[command.firstInstance - idBase + command.instanceCount++] = objectBase + idx;
+        drawnTriangles += command.indexCount / 3;
+    }
+
+    // the meshlets of cluster instances outside the frustum were never looked at
+    clustersTested        = clusterMeshlets;
+    clustersFrustumCulled = clusterMeshlets - kept - clustersBackfacing;
+}
+
+// runs of meshlets kept next to each other are drawn by one command, they are contiguous in the
+// index blob, returns how many were kept
+uint32_t SceneInterface::cullMeshlets(const glm::mat4&                      model,
+                                      const glm::vec3&                      eye,
+                                      std::span<const Meshlet>              meshlets,
+                                      const vk::DrawIndexedIndirectCommand& full,
+                                      uint32_t                              id,
+                                      uint32_t                              pool) {
+    auto&    list  = draws.clusterLists[pool];
+    uint32_t kept  = 0;
+    bool     merge = false;
+    for (const auto& meshlet : meshlets) {
+        if (!Math::sphereInFrustum(frameData.frustum,
+                                   Math::transformSphere(model, meshlet.sphere))) {
+            merge = false;
+            continue;
+        }
+        if (Math::meshletBackfacing(meshlet.sphere, meshlet.cone, eye)) {
+            clustersBackfacing++;
+            merge = false;
+            continue;
+        }
+
+        kept++;
+        drawnTriangles += meshlet.indexCount / 3;
+        if (merge) {
+            list.back().indexCount += meshlet.indexCount;
+        } else {
+            list.push_back({meshlet.indexCount,
+                            1,
+                            full.firstIndex + meshlet.firstIndex,
+                            full.vertexOffset,
+                            id});
+        }
+        merge = true;
+    }
+    return kept;
+}
+
+// the counters of the meshlet dispatch recorded with this frame last time
+void SceneInterface::readClusterStats(uint32_t frame) {
+    if (frame >= clusterReadbacks.size() || !clusterReadbacks[frame].stats) {
+        return;
+    }
+    auto& readback        = clusterReadbacks[frame];
+    clustersTested        = readback.tested;
+    clustersBackfacing    = readback.stats[1];
+    clustersFrustumCulled = readback.tested - readback.stats[0] - readback.stats[1];
+    readback.stats        = nullptr;
+}
+
+// before culling, the pass only keeps its results on the GPU
+void SceneInterface::countTriangles() {
+    drawnTriangles = fullTriangles = 0;
+    for (uint32_t idx = 0; idx < draws.slotCommand.size(); idx++) {
+        auto first = draws.slotCommand[idx];
+        for (auto instance : instances.getHandles(idx)) {
+            drawnTriangles += draws.commandList[first + lodOf[instance]].indexCount / 3;
+            fullTriangles += draws.commandList[first].indexCount / 3;
+        }
+    }
+}
+
+// the same sphere test as Shaders/cull.comp, instances within a small distance of a plane may go
+// either way on the GPU and are only remembered as border ones
+// cluster instances are left out, their meshlets are only counted
+void SceneInterface::expectCulling(const FrameAllocation& ids,
+                                   uint32_t               idBase,
+                                   uint32_t               objectBase,
+                                   const ObjectData*      objects) {
+    auto& modelInterface = Graphics::VulkanGraphics::modelInterface;
+    auto  frame          = Graphics::VulkanGraphics::frameRing.getFrame();
+    if (cullChecks.size() <= frame) {
+        cullChecks.resize(frame + 1);
+    }
+
+    auto& check    = cullChecks[frame];
+    check.commands = static_cast<const vk::DrawIndexedIndirectCommand*>(draws.commands.data);
+    check.ids      = static_cast<const uint32_t*>(ids.data);
+    check.idBase   = idBase;
+    check.commandSlots.assign(draws.commandList.size(), 0);
+    check.kept.assign(draws.commandList.size(), {});
+    check.border.assign(draws.commandList.size(), {});
+
+    const Math::FrustumPlanes& planes = frameData.frustum;
+
+    // every instance is expected in the command of the level selected for it
+    auto packed = instances.getPacked();
+    for (uint32_t idx = 0; idx < modelInterface.size(); idx++) {
+        auto count = instances.getCount(idx);
+        if (count == 0) {
+            continue;
+        }
+        auto first   = instances.getFirst(idx);
+        auto handles = instances.getHandles(idx);
+        auto bounds  = modelInterface.getMeshDesc(idx).bounds;
+        for (uint32_t lod = 0; lod < modelInterface.getMeshDesc(idx).lodCount; lod++) {
+            check.commandSlots[draws.slotCommand[idx] + lod] = idx;
+        }
+
+        for (uint32_t i = first; i < first + count; i++) {
+            if (objects[i].cluster != UINT32_MAX) {
+                continue;
+            }
+            auto  command   = draws.slotCommand[idx] + lodOf[handles[i - first]];
+            auto  sphere    = Math::transformSphere(packed[i].model, bounds);
+            float tolerance = 1e-3f * std::max(1.0f, sphere.w);
+
+            auto inner = sphere, outer = sphere;
+            inner.w -= tolerance;
+            outer.w += tolerance;
+            if (Math::sphereInFrustum(planes, inner)) {
+                check.kept[command].push_back(objectBase + i);
+            } else if (Math::sphereInFrustum(planes, outer)) {
+                check.border[command].push_back(objectBase + i);
+            }
+        }
+    }
+}
+
+void SceneInterface::checkCulling(uint32_t frame) {
+    if (frame >= cullChecks.size() || !cullChecks[frame].commands) {
+        return;
+    }
+    auto& check = cullChecks[frame];
+
+    uint32_t mismatches = 0;
+    for (size_t command = 0; command < check.kept.size(); command++) {
+        const auto& gpuCommand = check.commands[command];
+        const auto* first      = check.ids + (gpuCommand.firstInstance - check.idBase);
+        std::vector<uint32_t> gpuKept(first, first + gpuCommand.instanceCount);
+        std::sort(gpuKept.begin(), gpuKept.end());
+
+        // every instance the CPU keeps has to be there, the rest may only be border ones
+        const auto& kept   = check.kept[command];
+        const auto& border = check.border[command];
+        bool match = std::includes(gpuKept.begin(), gpuKept.end(), kept.begin(), kept.end());
+        for (auto id : gpuKept) {
+            match = match && (std::binary_search(kept.begin(), kept.end(), id) ||
+                              std::binary_search(border.begin(), border.end(), id));
+        }
+        if (!match) {
+            logger->warn("GPU culling of model " + std::to_string(check.commandSlots[command]) +
+                         " kept " + std::to_string(gpuKept.size()) + " instances, the CPU " +
+                         std::to_string(kept.size()) + " and " + std::to_string(border.size()) +
+                         " on the border");
+            mismatches++;
+        }
+    }
+    if (mismatches == 0) {
+        logger->trace("GPU culling matches the CPU for " + std::to_string(check.kept.size()) +
+                      " draws");
+    }
+    check.commands = nullptr;
 }
 
 } // namespace TBE::Graphics
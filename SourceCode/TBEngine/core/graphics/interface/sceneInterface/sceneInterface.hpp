@@ -1,30 +1,158 @@
 #pragma once
 #include "TBEngine/utils/includes/includeVulkan.hpp"
 #include "TBEngine/enums.hpp"
-#include "TBEngine/core/graphics/vulkanAbstract/bufferResource/bufferResource.hpp"
+#include "TBEngine/core/math/dataFormat.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/frameRing/frameRing.hpp"
+#include "TBEngine/core/math/bvh/bvh.hpp"
+#include "TBEngine/core/math/lod/lodSelector.hpp"
+#include "instanceTable.hpp"
 
 #include <any>
+#include <span>
+#include <vector>
 
 namespace TBE::Graphics {
 
+// the CPU side only keeps the data, prepareGPU() writes it into the frame ring once the frame it
+// is recorded for has finished on the GPU, and culls the instances there if CullPass is enabled,
+// on the CPU with a BVH over the world boxes of the instances otherwise, which picking uses too
+// the level of detail of every instance is selected on the CPU either way, each level of a model
+// has its own draw, instances drawn at the full mesh of a mesh with meshlets are cluster instances
+// with CLUSTER_CULLING, their meshlets are culled one by one and drawn by a command each
 class SceneInterface {
 public:
     void destroy();
 
 public:
     std::vector<std::tuple<InputType, std::any>> getBindFuncs();
-    void                                         initUniformBuffer();
 
 public:
-    void tickGPU(const vk::CommandBuffer& cmdBuffer, const vk::PipelineLayout& layout);
+    // before the render pass, writes the draws of the frame and records their culling
+    void prepareGPU(const vk::CommandBuffer& cmdBuffer);
+    // pipelines are indexed by Math::DataFormat::VertexLayout
+    void tickGPU(const vk::CommandBuffer&      cmdBuffer,
+                 const vk::PipelineLayout&     layout,
+                 std::span<const vk::Pipeline> pipelines);
 
 public:
-    void                                       updateUniformBuffer(std::span<std::byte> data);
-    std::span<Graphics::BufferResourceUniform> getUniformBufferRs() { return uniformBufferRs; }
+    void setFrameData(const Math::DataFormat::FrameData& data) { frameData = data; }
+
+    // a model slot is drawn once per instance, all of them in one draw
+    [[nodiscard]] InstanceHandle addInstance(uint32_t                            idx,
+                                             const Math::DataFormat::ObjectData& data);
+    void setInstance(InstanceHandle instance, const Math::DataFormat::ObjectData& data);
+    void removeInstance(InstanceHandle instance);
+
+    // the instance whose world box the ray enters first, nullInstance if it misses all of them
+    InstanceHandle pick(const glm::vec3& origin, const glm::vec3& direction);
+    const Math::DataFormat::ObjectData& getInstance(InstanceHandle instance) const {
+        return instances.get(instance);
+    }
+
+    // of the last frame, after culling if the CPU culls, before it otherwise, and only counted
+    // with LOD_BENCHMARK_SCENE then
+    uint64_t getDrawnTriangles() const { return drawnTriangles; }
+    uint64_t getFullTriangles() const { return fullTriangles; } // all drawn at the full mesh
+
+    // meshlets of the cluster instances of a frame, a few frames late when the GPU culls them,
+    // those of instances outside the frustum count as culled by it
+    uint32_t getClustersTested() const { return clustersTested; }
+    uint32_t getClustersFrustumCulled() const { return clustersFrustumCulled; }
+    uint32_t getClustersBackfacing() const { return clustersBackfacing; }
+
+private:
+    // where prepareGPU() put the draws of the frame in the frame ring
+    struct FrameDraws {
+        FrameAllocation frame{};
+        FrameAllocation commands{};
+        FrameAllocation packed{};
+        FrameAllocation counts{};
+        uint32_t        drawBase{};
+        bool            culled = false;
+
+        std::vector<vk::DrawIndexedIndirectCommand> commandList{};
+        std::vector<uint32_t>                       poolFirst{}; // first command of every pool
+        std::vector<uint32_t>                       poolSize{};
+        std::vector<uint32_t> slotCommand{}; // first command of every slot, one per level
+        std::vector<uint32_t> packedFirst{}; // the commands and the meshlets the pass may pack
+        std::vector<uint32_t> packedSize{};
+
+        // per pool, the meshlets the CPU kept, runs of them next to each other are merged
+        std::vector<std::vector<vk::DrawIndexedIndirectCommand>> clusterLists{};
+    };
+
+    // the counters of the meshlet dispatch, read once the fence of the frame has signalled
+    struct ClusterReadback {
+        const uint32_t* stats = nullptr; // in the frame ring, kept and facing away
+        uint32_t        tested{};
+    };
+
+    // what the culling pass should have kept, compared once the fence of the frame has signalled
+    struct CullCheck {
+        const vk::DrawIndexedIndirectCommand* commands = nullptr; // in the frame ring
+        const uint32_t*                       ids      = nullptr;
+        uint32_t                              idBase{};
+        std::vector<uint32_t>                 commandSlots{};
+        std::vector<std::vector<uint32_t>>    kept{};   // per command, sorted
+        std::vector<std::vector<uint32_t>>    border{}; // per command, too close to a plane to tell
+    };
+
+private:
+    void     updateBvh();
+    void     selectLods(std::span<const Math::DataFormat::ObjectData> packed,
+                        Math::DataFormat::ObjectData*                 objects);
+    uint32_t collectClusters(std::span<const Math::DataFormat::ObjectData> packed,
+                             Math::DataFormat::ObjectData*                 objects,
+                             uint32_t                                      objectBase);
+    void     cullOnCpu(std::span<const Math::DataFormat::ObjectData> packed,
+                       uint32_t*                                     ids,
+                       uint32_t                                      idBase,
+                       uint32_t                                      objectBase,
+                       uint32_t                                      clusterId);
+    uint32_t cullMeshlets(const glm::mat4&                           model,
+                          const glm::vec3&                           eye, // in model space
+                          std::span<const Math::DataFormat::Meshlet> meshlets,
+                          const vk::DrawIndexedIndirectCommand&      full,
+                          uint32_t                                   id,
+                          uint32_t                                   pool);
+    void     readClusterStats(uint32_t frame);
+    void     countTriangles();
+    void     expectCulling(const FrameAllocation&              ids,
+                           uint32_t                            idBase,
+                           uint32_t                            objectBase,
+                           const Math::DataFormat::ObjectData* objects);
+    void checkCulling(uint32_t frame);
 
 private:
-    std::vector<Graphics::BufferResourceUniform> uniformBufferRs{};
-    uint32_t                                     currentFrame = 0;
+    Math::DataFormat::FrameData frameData{};
+    InstanceTable               instances{};
+    FrameDraws                  draws{};
+    std::vector<CullCheck>      cullChecks{}; // indexed by frame, GPU_CULLING_VALIDATION only
+
+    // the world boxes of the instances, changed ones are set again by updateBvh()
+    Math::Bvh                   bvh{};
+    std::vector<InstanceHandle> changed{};   // may hold duplicates and removed instances
+    std::vector<Math::Aabb>     slotBoxes{}; // the mesh box every slot was last set with
+
+    // per instance handle, the level of detail it was drawn with last
+    Math::LodSelector    lodSelector{};
+    std::vector<uint8_t> lodOf{};
+    uint64_t             drawnTriangles{};
+    uint64_t             fullTriangles{};
+
+    // cluster instances of the frame, the entries are only made for the culling pass
+    bool                                           clusterCulling = false;
+    std::vector<Math::DataFormat::ClusterInstance> clusters{};
+    std::vector<uint32_t>                          clusterCapacity{}; // meshlets per pool
+    uint32_t                                       maxMeshlets{};
+    uint32_t                                       clusterMeshlets{}; // of the cluster instances
+    std::vector<ClusterReadback>                   clusterReadbacks{}; // indexed by frame
+    uint32_t                                       clustersTested{};
+    uint32_t                                       clustersFrustumCulled{};
+    uint32_t                                       clustersBackfacing{};
+
+    // CPU culling, reused every frame
+    std::vector<uint32_t> visible{}; // instance handles
 };
 
 } // namespace TBE::Graphics
@@ -1,4 +1,5 @@
 #include "shaderInterface.hpp"
+#include "TBEngine/core/graphics/graphics.hpp"
 
 namespace TBE::Graphics {
 using namespace TBE::Utils::Log;
@@ -29,6 +30,7 @@ void ShaderInterface::destroyCache() {
             modules.clear();
         }
         stageInfos.clear();
+        computeStageInfos.clear();
         bindings.clear();
         destroyed = true;
     }
@@ -43,8 +45,19 @@ void ShaderInterface::addShader(std::vector<char> shaderCode, ShaderType type) {
             shaderStageInfo.setStage(vk::ShaderStageFlagBits::eVertex);
             break;
         case ShaderType::eFrag:
-            shaderStageInfo.setStage(vk::ShaderStageFlagBits::eFragment);
+            // the size of the texture table is the specialization constant 0
+            textureTableSize = VulkanGraphics::textureInterface.getTableSize();
+            fragSpecialization.setMapEntries(tableSizeEntry)
+                .setDataSize(sizeof(textureTableSize))
+                .setPData(&textureTableSize);
+            shaderStageInfo.setStage(vk::ShaderStageFlagBits::eFragment)
+                .setPSpecializationInfo(&fragSpecialization);
             break;
+        case ShaderType::eCompute:
+            // a compute pass creates the layout of its own descriptor sets
+            shaderStageInfo.setStage(vk::ShaderStageFlagBits::eCompute);
+            computeStageInfos.emplace_back(shaderStageInfo);
+            return;
         case ShaderType::eUnknown:
         default:
             logErrorMsg("illegal ShaderType");
@@ -52,7 +65,8 @@ void ShaderInterface::addShader(std::vector<char> shaderCode, ShaderType type) {
     }
     stageInfos.emplace_back(shaderStageInfo);
 
-    bindings.emplace_back(createBinding(type));
+    auto stageBindings = createBindings(type);
+    bindings.insert(bindings.end(), stageBindings.begin(), stageBindings.end());
 }
 
 vk::ShaderModule ShaderInterface::createShaderModule(const std::vector<char>& code) {
@@ -72,22 +86,40 @@ const std::vector<vk::PipelineShaderStageCreateInfo> ShaderInterface::initDescri
     if (!bindings.empty()) {
         descriptors.initLayout(bindings);
     }
+    const auto& textureInterface = VulkanGraphics::textureInterface;
+    descriptors.initTableLayout(textureInterface.getTableSize(),
+                                textureInterface.getTableBindingFlags(),
+                                textureInterface.isUpdateAfterBind());
     return stageInfos;
 }
 
-vk::DescriptorSetLayoutBinding ShaderInterface::createBinding(ShaderType type) {
-    vk::DescriptorSetLayoutBinding binding{};
+// the vertex stage reads the frame data at a dynamic offset and the rest from storage buffers
+std::vector<vk::DescriptorSetLayoutBinding> ShaderInterface::createBindings(ShaderType type) {
+    std::vector<vk::DescriptorSetLayoutBinding> stageBindings{};
     switch (type) {
         case ShaderType::eVertex:
-            binding.setBinding(0)
-                .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+            stageBindings.resize(4);
+            stageBindings[0]
+                .setBinding(0)
+                .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
                 .setDescriptorCount(1)
                 .setStageFlags(vk::ShaderStageFlagBits::eVertex);
+            // objects, instance ids and draws
+            for (uint32_t i = 1; i < stageBindings.size(); i++) {
+                stageBindings[i]
+                    .setBinding(i + 1)
+                    .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                    .setDescriptorCount(1)
+                    .setStageFlags(vk::ShaderStageFlagBits::eVertex);
+            }
             break;
         case ShaderType::eFrag:
-            binding.setBinding(1)
+            // one sampler for every texture, the texture table is the set of its own
+            stageBindings.resize(1);
+            stageBindings[0]
+                .setBinding(1)
                 .setDescriptorCount(1)
-                .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                .setDescriptorType(vk::DescriptorType::eSampler)
                 .setPImmutableSamplers(nullptr)
                 .setStageFlags(vk::ShaderStageFlagBits::eFragment);
             break;
@@ -96,7 +128,7 @@ vk::DescriptorSetLayoutBinding ShaderInterface::createBinding(ShaderType type) {
             logErrorMsg("illegal ShaderType");
             break;
     }
-    return std::move(binding);
+    return stageBindings;
 }
 
 } // namespace TBE::Graphics
@@ -28,12 +28,19 @@ public:
 public:
     std::vector<vk::ShaderModule>                  modules{};
     std::vector<vk::PipelineShaderStageCreateInfo> stageInfos{};
+    std::vector<vk::PipelineShaderStageCreateInfo> computeStageInfos{}; // pipelines of their own
     std::vector<vk::DescriptorSetLayoutBinding>    bindings{};
     Graphics::Descriptor                           descriptors;
 
 private:
-    [[nodiscard]] vk::ShaderModule               createShaderModule(const std::vector<char>& code);
-    [[nodiscard]] vk::DescriptorSetLayoutBinding createBinding(ShaderType type);
+    // the fragment stage points at these
+    uint32_t                   textureTableSize{};
+    vk::SpecializationMapEntry tableSizeEntry{0, 0, sizeof(uint32_t)};
+    vk::SpecializationInfo     fragSpecialization{};
+
+private:
+    [[nodiscard]] vk::ShaderModule createShaderModule(const std::vector<char>& code);
+    [[nodiscard]] std::vector<vk::DescriptorSetLayoutBinding> createBindings(ShaderType type);
 
 private:
     using super = GraphicsInterface;
@@ -1,52 +1,117 @@
 #include "textureInterface.hpp"
 #include "TBEngine/core/graphics/graphics.hpp"
-#include "TBEngine/core/graphics/vulkanAbstract/bufferResource/stagingBuffer.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/resource/texture/blockCompress/blockCompress.hpp"
+#include "TBEngine/settings.hpp"
 
+#include <algorithm>
+#include <string>
 
 namespace TBE::Graphics {
 using namespace TBE::Utils::Log;
-using TBE::Graphics::StagingBuffer;
+using namespace TBE::Graphics::Detail;
 
-TextureInterface::TextureInterface() : super(), imageR() {
+TextureInterface::TextureInterface() : super() {
 }
 
 TextureInterface::~TextureInterface() {
     destroy();
 }
 
+// the sampler belongs to the object cache
 void TextureInterface::destroy() {
-    static bool destroyed = false;
-    if (!destroyed) {
-        device.destroy(sampler);
-        imageR.destroy();
-        destroyed = true;
+    sampler = nullptr;
+    textures.clear();
+    ready.clear();
+    table.clear();
+    placeholderR.destroy();
+}
+
+std::vector<const char*>
+TextureInterface::getOptionalExtensions(const vk::PhysicalDevice& phyDevice) {
+    if (getIndexingFeatures(phyDevice).descriptorBindingPartiallyBound) {
+        return {vk::EXTDescriptorIndexingExtensionName, vk::KHRMaintenance3ExtensionName};
     }
+    return {};
 }
 
-void TextureInterface::read(Resource::File::TextureContent* pTexContent) {
-    auto           pixels    = pTexContent->pixels;
-    int            texHeight = pTexContent->texHeight, texWidth = pTexContent->texWidth;
-    vk::DeviceSize imageSize = texHeight * texWidth * 4;
-    mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+// the features of the device extension are only reported through the instance extension
+vk::PhysicalDeviceDescriptorIndexingFeaturesEXT
+TextureInterface::getIndexingFeatures(const vk::PhysicalDevice& phyDevice) {
+    if (!checkInstanceExtensionSupport(vk::KHRGetPhysicalDeviceProperties2ExtensionName) ||
+        !checkDeviceExtensionSupport(
+            phyDevice,
+            {vk::EXTDescriptorIndexingExtensionName, vk::KHRMaintenance3ExtensionName})) {
+        return {};
+    }
+    auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+        VulkanGraphics::instance.getProcAddr("vkGetPhysicalDeviceFeatures2KHR"));
+    if (!getFeatures2) {
+        return {};
+    }
 
-    std::span<std::byte> data(static_cast<std::byte*>(static_cast<void*>(pixels)), imageSize);
-    StagingBuffer        stagingBuffer{data};
-    pTexContent->free();
+    vk::PhysicalDeviceDescriptorIndexingFeaturesEXT supported{};
+    vk::PhysicalDeviceFeatures2                     features{};
+    features.setPNext(&supported);
+    getFeatures2(phyDevice, reinterpret_cast<VkPhysicalDeviceFeatures2*>(&features));
+
+    // update after bind only matters to a table that is partially bound
+    vk::PhysicalDeviceDescriptorIndexingFeaturesEXT used{};
+    used.setDescriptorBindingPartiallyBound(supported.descriptorBindingPartiallyBound)
+        .setDescriptorBindingSampledImageUpdateAfterBind(
+            supported.descriptorBindingPartiallyBound &&
+            supported.descriptorBindingSampledImageUpdateAfterBind);
+    return used;
+}
 
-    imageR.setFormat(vk::Format::eR8G8B8A8Srgb);
-    imageR.setWH(texWidth, texHeight);
-    imageR.init(ImageResourceType::eTexture);
+void TextureInterface::initTable(const vk::PhysicalDeviceDescriptorIndexingFeaturesEXT& features) {
+    indexing = features;
+    indexing.setPNext(nullptr);
+
+    const auto& limits = phyDevice.getProperties().limits;
+    uint32_t    perStage = limits.maxPerStageDescriptorSampledImages;
+    uint32_t    perSet   = limits.maxDescriptorSetSampledImages;
+    if (isUpdateAfterBind()) {
+        auto getProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(
+            VulkanGraphics::instance.getProcAddr("vkGetPhysicalDeviceProperties2KHR"));
+        vk::PhysicalDeviceDescriptorIndexingPropertiesEXT indexingLimits{};
+        vk::PhysicalDeviceProperties2                     properties{};
+        properties.setPNext(&indexingLimits);
+        getProperties2(phyDevice, reinterpret_cast<VkPhysicalDeviceProperties2*>(&properties));
+        perStage = indexingLimits.maxPerStageDescriptorUpdateAfterBindSampledImages;
+        perSet   = indexingLimits.maxDescriptorSetUpdateAfterBindSampledImages;
+    }
+    tableSize = std::max(1u, std::min({TEXTURE_TABLE_SIZE, perStage, perSet}));
 
-    transitionImageLayout({.image     = imageR.image,
-                           .format    = vk::Format::eR8G8B8A8Srgb,
-                           .oldLayout = vk::ImageLayout::eUndefined,
-                           .newLayout = vk::ImageLayout::eTransferDstOptimal,
-                           .mipLevels = mipLevels});
-    stagingBuffer.copyTo(
-        &imageR, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
+    logger->info("texture table of " + std::to_string(tableSize) + " elements" +
+                 (isPartiallyBound() ? ", partially bound" : "") +
+                 (isUpdateAfterBind() ? ", updated after bind" : ""));
+}
 
-    generateMipmaps();
+vk::DescriptorBindingFlags TextureInterface::getTableBindingFlags() const {
+    vk::DescriptorBindingFlags flags{};
+    if (isPartiallyBound()) {
+        flags |= vk::DescriptorBindingFlagBits::ePartiallyBound;
+    }
+    if (isUpdateAfterBind()) {
+        flags |= vk::DescriptorBindingFlagBits::eUpdateAfterBind;
+    }
+    return flags;
+}
+
+void TextureInterface::initPlaceholder() {
+    Resource::File::TextureContent content{};
+    content.storage   = {std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}};
+    content.pixels    = content.storage;
+    content.texWidth  = 1;
+    content.texHeight = 1;
+    content.mips      = {Resource::Texture::TextureMip{.size = 4, .width = 1, .height = 1}};
+
+    UploadBatch batch{};
+    uploadImage(placeholderR, &content, batch);
+    batch.submit();
 
+    // no maxLod clamp, so the one sampler fits textures with any number of levels
     vk::SamplerCreateInfo samplerInfo{};
     samplerInfo.setMagFilter(vk::Filter::eLinear)
         .setMinFilter(vk::Filter::eLinear)
@@ -60,142 +125,131 @@ void TextureInterface::read(Resource::File::TextureContent* pTexContent) {
         .setCompareEnable(vk::False)
         .setCompareOp(vk::CompareOp::eAlways)
         .setMipmapMode(vk::SamplerMipmapMode::eLinear)
-        .setMaxLod(static_cast<float>(mipLevels));
+        .setMaxLod(vk::LodClampNone);
+
+    sampler = VulkanGraphics::objectCache.getSampler(samplerInfo);
+}
+
+// a new slot shows the placeholder, the version is raised so that its element gets written even
+// while the table is partially bound
+uint32_t TextureInterface::reserve() {
+    auto idx = static_cast<uint32_t>(textures.size());
+    textures.emplace_back();
+    ready.emplace_back(false);
+    if (idx < tableSize) {
+        table.emplace_back(placeholderR.imageView);
+    }
+    if (idx == tableSize - 1) {
+        logger->warn("the texture table is full at " + std::to_string(tableSize) +
+                     " elements, textures from slot " + std::to_string(idx) +
+                     " on are drawn with the placeholder");
+    }
+    tableVersion++;
+    return idx;
+}
+
+void TextureInterface::setReady(uint32_t idx) {
+    ready[idx] = true;
+    if (idx < tableSize - 1) {
+        table[idx] = textures[idx].imageView;
+        tableVersion++;
+    }
+}
 
-    depackReturnValue(sampler, device.createSampler(samplerInfo));
+void TextureInterface::read(uint32_t idx, Resource::File::TextureContent* pTexContent) {
+    UploadBatch batch{};
+    upload(idx, pTexContent, batch);
+    batch.submit();
+    setReady(idx);
 }
 
-void TextureInterface::transitionImageLayout(__TextureTransitionImageLayoutArgs args) {
-    auto& [image, format, oldLayout, newLayout, mipLevels] = args;
-    vk::ImageSubresourceRange subresourceRange{};
-    subresourceRange.setBaseMipLevel(0).setLevelCount(mipLevels).setBaseArrayLayer(0).setLayerCount(
-        1);
-
-    vk::ImageMemoryBarrier barrier{};
-    barrier.setOldLayout(oldLayout)
-        .setNewLayout(newLayout)
-        .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
-        .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
-        .setImage(image)
-        .setSubresourceRange(subresourceRange);
-
-    vk::PipelineStageFlags sourceStage{};
-    vk::PipelineStageFlags destinationStage{};
-    if (oldLayout == vk::ImageLayout::eUndefined &&
-        newLayout == vk::ImageLayout::eTransferDstOptimal) {
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eNone)
-            .setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
-
-        sourceStage      = vk::PipelineStageFlagBits::eTopOfPipe;
-        destinationStage = vk::PipelineStageFlagBits::eTransfer;
-    } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal &&
-               newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
-            .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-        sourceStage      = vk::PipelineStageFlagBits::eTransfer;
-        destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-    } else {
-        logErrorMsg("unsupported layout transition!");
+void TextureInterface::upload(uint32_t                        idx,
+                              Resource::File::TextureContent* pTexContent,
+                              UploadBatch&                    batch) {
+    if (ready[idx] || textures[idx].image) {
+        logErrorMsg("texture slot " + std::to_string(idx) + " is uploaded already");
     }
+    uploadImage(textures[idx], pTexContent, batch);
+}
 
-    auto func = [&sourceStage, &destinationStage, &barrier](vk::CommandBuffer& cmdBuffer) {
-        cmdBuffer.pipelineBarrier( // TODO: what's this
-            sourceStage,
-            destinationStage,
-            {},
-            {},
-            {},
-            barrier);
-    };
-
-    Graphics::disposableCommands(func);
+const vk::ImageView& TextureInterface::getImageView(uint32_t idx) const {
+    return idx < textures.size() && ready[idx] ? textures[idx].imageView : placeholderR.imageView;
 }
 
-void TextureInterface::generateMipmaps() {
-    auto formatProperties = phyDevice.getFormatProperties(imageR.format);
-    if (!(formatProperties.optimalTilingFeatures &
-          vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
-        logErrorMsg("texture image format does not support linear blitting!");
+void TextureInterface::uploadImage(ImageResource&                  imageR,
+                                   Resource::File::TextureContent* pTexContent,
+                                   UploadBatch&                    batch) {
+    if (pTexContent->mips.empty()) {
+        logErrorMsg("texture has no mip levels");
+    }
+    if (!imageR.isSampledFormatSupported(static_cast<vk::Format>(pTexContent->format))) {
+        decodeToRGBA8(pTexContent);
     }
 
-    Graphics::disposableCommands([this](const vk::CommandBuffer& cmdBuffer) {
-        vk::ImageMemoryBarrier barrier{};
-        barrier.image                           = imageR.image;
-        barrier.srcQueueFamilyIndex             = vk::QueueFamilyIgnored;
-        barrier.dstQueueFamilyIndex             = vk::QueueFamilyIgnored;
-        barrier.subresourceRange.aspectMask     = vk::ImageAspectFlagBits::eColor;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount     = 1;
-        barrier.subresourceRange.levelCount     = 1;
-
-        int32_t mipWidth = imageR.width, mipHeight = imageR.height;
-
-        for (uint32_t i = 1; i < mipLevels; i++) {
-            barrier.subresourceRange.baseMipLevel = i - 1;
-            barrier.oldLayout                     = vk::ImageLayout::eTransferDstOptimal;
-            barrier.newLayout                     = vk::ImageLayout::eTransferSrcOptimal;
-            barrier.srcAccessMask                 = vk::AccessFlagBits::eTransferWrite;
-            barrier.dstAccessMask                 = vk::AccessFlagBits::eTransferRead;
-
-            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                      vk::PipelineStageFlagBits::eTransfer,
-                                      {},
-                                      {},
-                                      {},
-                                      barrier);
-
-            vk::ImageBlit blit{};
-            blit.setSrcOffsets({{{0, 0, 0}, {mipWidth, mipHeight, 1}}})
-                .setDstOffsets(
-                    {{{0, 0, 0},
-                      {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1}}});
-            blit.srcSubresource.aspectMask     = vk::ImageAspectFlagBits::eColor;
-            blit.srcSubresource.mipLevel       = i - 1;
-            blit.srcSubresource.baseArrayLayer = 0;
-            blit.srcSubresource.layerCount     = 1;
-
-            blit.dstSubresource.aspectMask     = vk::ImageAspectFlagBits::eColor;
-            blit.dstSubresource.mipLevel       = i;
-            blit.dstSubresource.baseArrayLayer = 0;
-            blit.dstSubresource.layerCount     = 1;
-
-            cmdBuffer.blitImage(imageR.image,
-                                vk::ImageLayout::eTransferSrcOptimal,
-                                imageR.image,
-                                vk::ImageLayout::eTransferDstOptimal,
-                                blit,
-                                vk::Filter::eLinear);
-
-            barrier.setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
-                .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-                .setSrcAccessMask(vk::AccessFlagBits::eTransferRead)
-                .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                      vk::PipelineStageFlagBits::eFragmentShader,
-                                      {},
-                                      {},
-                                      {},
-                                      barrier);
-            if (mipWidth > 1)
-                mipWidth /= 2;
-            if (mipHeight > 1)
-                mipHeight /= 2;
-        }
-        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-        barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-            .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
-            .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                                  vk::PipelineStageFlagBits::eFragmentShader,
-                                  {},
-                                  {},
-                                  {},
-                                  barrier);
-    });
+    int        texHeight = pTexContent->texHeight, texWidth = pTexContent->texWidth;
+    vk::Format format    = static_cast<vk::Format>(pTexContent->format);
+    uint32_t   mipLevels = static_cast<uint32_t>(pTexContent->mips.size());
+
+    auto staging = batch.stage(pTexContent->pixels);
+
+    // the chain is built on import or read from a KTX2, every level goes through the one copy
+    std::vector<vk::BufferImageCopy> regions(mipLevels);
+    for (uint32_t i = 0; i < mipLevels; i++) {
+        const auto& mip = pTexContent->mips[i];
+        regions[i]
+            .setBufferOffset(mip.offset)
+            .setBufferRowLength(0)
+            .setBufferImageHeight(0)
+            .setImageOffset({0, 0, 0})
+            .setImageExtent({mip.width, mip.height, 1});
+        regions[i]
+            .imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor)
+            .setMipLevel(i)
+            .setBaseArrayLayer(0)
+            .setLayerCount(1);
+    }
+
+    pTexContent->free();
+
+    imageR.setFormat(format);
+    imageR.setWH(texWidth, texHeight);
+    imageR.setMipLevels(mipLevels);
+    imageR.init(ImageResourceType::eTexture);
+
+    // the transitions and the copy are recorded on flush, together with those of every other
+    // texture in the batch
+    batch.uploadImage(imageR.image, mipLevels, staging, std::move(regions));
+}
+
+// fallback for devices without BC sampling, the texture is uploaded as RGBA8 instead
+void TextureInterface::decodeToRGBA8(Resource::File::TextureContent* pTexContent) {
+    using Resource::Texture::TextureFormat;
+    auto format = pTexContent->format;
+
+    std::vector<std::byte>                     pixels{};
+    std::vector<Resource::Texture::TextureMip> mips{};
+    if (!Resource::Texture::isBlockCompressed(format) ||
+        !Resource::Texture::decompressMipChain(pTexContent->pixels,
+                                               pTexContent->mips,
+                                               format,
+                                               pixels,
+                                               mips)) {
+        logErrorMsg("texture format " + std::string(Resource::Texture::toString(format)) +
+                    " is not supported by the device");
+    }
+    logger->warn("device cannot sample " + std::string(Resource::Texture::toString(format)) +
+                 ", uploading the texture as RGBA8");
+
+    // only the pixels change, the mapped file of a cooked or KTX2 texture can go
+    int texWidth = pTexContent->texWidth, texHeight = pTexContent->texHeight;
+    pTexContent->free();
+    pTexContent->storage   = std::move(pixels);
+    pTexContent->pixels    = pTexContent->storage;
+    pTexContent->mips      = std::move(mips);
+    pTexContent->texWidth  = texWidth;
+    pTexContent->texHeight = texHeight;
+    pTexContent->format =
+        Resource::Texture::isSrgb(format) ? TextureFormat::eRGBA8Srgb : TextureFormat::eRGBA8Unorm;
 }
 
 } // namespace TBE::Graphics
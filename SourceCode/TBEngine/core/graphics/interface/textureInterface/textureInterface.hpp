@@ -2,21 +2,23 @@
 
 #include "TBEngine/utils/includes/includeVulkan.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/imageResource/imageResource.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/uploadBatch/uploadBatch.hpp"
 #include "TBEngine/resource/file/texture/textureFile.hpp"
 #include "TBEngine/core/graphics/interface/base/graphicsInterface.hpp"
 
+#include <algorithm>
 #include <filesystem>
+#include <span>
+#include <vector>
 
 namespace TBE::Graphics {
 
-struct __TextureTransitionImageLayoutArgs {
-    vk::Image       image{};
-    vk::Format      format{};
-    vk::ImageLayout oldLayout{};
-    vk::ImageLayout newLayout{};
-    uint32_t        mipLevels{};
-};
-
+// textures live in slots, a slot shows the 1x1 placeholder until its upload is done
+// the slots are the elements of a bindless table of sampled images, every draw indexes it with the
+// texture slot of its model, so any number of textures is drawn without binding a set per draw
+// the last element is kept for the slots past the table, it shows the placeholder
+// with VK_EXT_descriptor_indexing the table is partially bound, only the elements of slots are
+// written, and updated after bind, so its size is bound by the larger update after bind limits
 class TextureInterface final : public GraphicsInterface {
 public:
     TextureInterface();
@@ -25,18 +27,71 @@ public:
     void destroy();
 
 public:
-    // read in the file and init imageR and sampler, release the texture data itself as long as it
-    // has been read into staging buffer
-    void read(Resource::File::TextureContent* pTexContent);
+    // the device extensions the table uses when the device has them
+    static std::vector<const char*> getOptionalExtensions(const vk::PhysicalDevice& phyDevice);
+    // the features of VK_EXT_descriptor_indexing the table uses, to enable on the device, all off
+    // when the device or the instance lacks an extension they need
+    static vk::PhysicalDeviceDescriptorIndexingFeaturesEXT
+    getIndexingFeatures(const vk::PhysicalDevice& phyDevice);
+
+    // the indexing features the device was created with, they decide the size of the table
+    void initTable(const vk::PhysicalDeviceDescriptorIndexingFeaturesEXT& features);
+
+    // create the placeholder texture and the sampler shared by all the textures
+    void initPlaceholder();
+
+    [[nodiscard]] uint32_t reserve();
+
+    // read in the file and init the slot, release the texture data itself as long as it has been
+    // read into staging buffer
+    void read(uint32_t idx, Resource::File::TextureContent* pTexContent);
+
+    // same as read(), but only records the upload into batch, call setReady() once it is done
+    void upload(uint32_t idx, Resource::File::TextureContent* pTexContent, UploadBatch& batch);
+    void setReady(uint32_t idx);
+    bool isReady(uint32_t idx) const { return ready[idx]; }
 
 public:
-    Graphics::ImageResource imageR;
-    vk::Sampler             sampler{};
-    uint32_t                mipLevels{0};
+    const vk::ImageView& getImageView(uint32_t idx) const;
+    const vk::ImageView& getPlaceholder() const { return placeholderR.imageView; }
+
+    // what every slot shows, indexed like the table, Descriptor::updateTextures() writes it
+    std::span<const vk::ImageView> getTable() const { return table; }
+    // raised whenever a slot is added or starts showing its texture, the table is unchanged while
+    // it is equal
+    uint64_t                       getTableVersion() const { return tableVersion; }
+    // elements of the table, TEXTURE_TABLE_SIZE within the limits of the device
+    uint32_t getTableSize() const { return tableSize; }
+    // the element a slot is drawn with, the placeholder one for the slots past the table
+    uint32_t getTableElement(uint32_t idx) const { return std::min(idx, tableSize - 1); }
+
+    // elements of the table no draw indexes may be left unwritten
+    bool isPartiallyBound() const { return indexing.descriptorBindingPartiallyBound; }
+    // the table needs a layout and a pool created for update after bind
+    bool isUpdateAfterBind() const { return indexing.descriptorBindingSampledImageUpdateAfterBind; }
+    vk::DescriptorBindingFlags getTableBindingFlags() const;
+
+    // whether textures are worth compressing on import, they are decoded again otherwise
+    bool supportsBlockCompression() const { return phyDevice.getFeatures().textureCompressionBC; }
+
+public:
+    vk::Sampler sampler{};
+
+private:
+    std::vector<Graphics::ImageResource> textures{};
+    std::vector<bool>                    ready{};
+    std::vector<vk::ImageView>           table{};
+    uint64_t                             tableVersion{};
+    uint32_t                             tableSize{1};
+    Graphics::ImageResource              placeholderR{};
+
+    vk::PhysicalDeviceDescriptorIndexingFeaturesEXT indexing{};
 
 private:
-    void transitionImageLayout(__TextureTransitionImageLayoutArgs args);
-    void generateMipmaps();
+    void uploadImage(ImageResource&                  imageR,
+                     Resource::File::TextureContent* pTexContent,
+                     UploadBatch&                    batch);
+    void decodeToRGBA8(Resource::File::TextureContent* pTexContent);
 
 private:
     using super = GraphicsInterface;
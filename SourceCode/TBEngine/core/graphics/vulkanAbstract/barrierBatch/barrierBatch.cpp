@@ -0,0 +1,191 @@
+#include "barrierBatch.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <string>
+
+namespace TBE::Graphics {
+
+// reads and writes of the layout, what a barrier into it waits for or makes visible
+LayoutUsage getLayoutUsage(vk::ImageLayout layout) {
+    using Stage  = vk::PipelineStageFlagBits;
+    using Access = vk::AccessFlagBits;
+
+    switch (layout) {
+        case vk::ImageLayout::eUndefined:
+        case vk::ImageLayout::ePreinitialized: return {Stage::eTopOfPipe, {}};
+        case vk::ImageLayout::eTransferDstOptimal:
+            return {Stage::eTransfer, Access::eTransferWrite};
+        case vk::ImageLayout::eTransferSrcOptimal:
+            return {Stage::eTransfer, Access::eTransferRead};
+        case vk::ImageLayout::eShaderReadOnlyOptimal:
+            return {Stage::eVertexShader | Stage::eFragmentShader, Access::eShaderRead};
+        case vk::ImageLayout::eColorAttachmentOptimal:
+            return {Stage::eColorAttachmentOutput,
+                    Access::eColorAttachmentRead | Access::eColorAttachmentWrite};
+        case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+            return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+                    Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite};
+        case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+            return {Stage::eEarlyFragmentTests | Stage::eFragmentShader,
+                    Access::eDepthStencilAttachmentRead | Access::eShaderRead};
+        case vk::ImageLayout::ePresentSrcKHR: return {Stage::eBottomOfPipe, {}};
+        case vk::ImageLayout::eGeneral:
+            return {Stage::eAllCommands, Access::eMemoryRead | Access::eMemoryWrite};
+        default:
+            Utils::Log::logErrorMsg("no barrier rule for image layout " + vk::to_string(layout));
+    }
+    return {};
+}
+
+void BarrierBatch::transition(vk::Image            image,
+                              uint32_t             baseMip,
+                              uint32_t             levelCount,
+                              vk::ImageLayout      newLayout,
+                              vk::ImageAspectFlags aspect) {
+    auto dst = getLayoutUsage(newLayout);
+    for (const auto& run : advance(image, baseMip, levelCount, newLayout)) {
+        auto src = getLayoutUsage(run.oldLayout);
+
+        vk::ImageMemoryBarrier barrier{};
+        barrier.setOldLayout(run.oldLayout)
+            .setNewLayout(newLayout)
+            .setSrcAccessMask(src.access)
+            .setDstAccessMask(dst.access)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(image)
+            .setSubresourceRange({aspect, run.baseMip, run.levelCount, 0, 1});
+        imageBarriers.push_back(barrier);
+
+        srcStages |= src.stages;
+        dstStages |= dst.stages;
+    }
+}
+
+// the release waits for the writes and makes nothing visible, the acquire does the latter
+void BarrierBatch::release(vk::Image            image,
+                           uint32_t             baseMip,
+                           uint32_t             levelCount,
+                           vk::ImageLayout      newLayout,
+                           uint32_t             srcFamily,
+                           uint32_t             dstFamily,
+                           BarrierBatch&        acquire,
+                           vk::ImageAspectFlags aspect) {
+    auto dst = getLayoutUsage(newLayout);
+    for (const auto& run : advance(image, baseMip, levelCount, newLayout)) {
+        auto src = getLayoutUsage(run.oldLayout);
+
+        vk::ImageMemoryBarrier barrier{};
+        barrier.setOldLayout(run.oldLayout)
+            .setNewLayout(newLayout)
+            .setSrcAccessMask(src.access)
+            .setSrcQueueFamilyIndex(srcFamily)
+            .setDstQueueFamilyIndex(dstFamily)
+            .setImage(image)
+            .setSubresourceRange({aspect, run.baseMip, run.levelCount, 0, 1});
+        imageBarriers.push_back(barrier);
+        srcStages |= src.stages;
+        dstStages |= vk::PipelineStageFlagBits::eBottomOfPipe;
+
+        barrier.setSrcAccessMask({}).setDstAccessMask(dst.access);
+        acquire.imageBarriers.push_back(barrier);
+        acquire.srcStages |= vk::PipelineStageFlagBits::eTopOfPipe;
+        acquire.dstStages |= dst.stages;
+    }
+}
+
+void BarrierBatch::release(vk::Buffer    buffer,
+                           uint32_t      srcFamily,
+                           uint32_t      dstFamily,
+                           BarrierBatch& acquire) {
+    vk::BufferMemoryBarrier barrier{};
+    barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setSrcQueueFamilyIndex(srcFamily)
+        .setDstQueueFamilyIndex(dstFamily)
+        .setBuffer(buffer)
+        .setOffset(0)
+        .setSize(vk::WholeSize);
+    bufferBarriers.push_back(barrier);
+    srcStages |= vk::PipelineStageFlagBits::eTransfer;
+    dstStages |= vk::PipelineStageFlagBits::eBottomOfPipe;
+
+    barrier.setSrcAccessMask({}).setDstAccessMask(vk::AccessFlagBits::eMemoryRead);
+    acquire.bufferBarriers.push_back(barrier);
+    acquire.srcStages |= vk::PipelineStageFlagBits::eTopOfPipe;
+    acquire.dstStages |= vk::PipelineStageFlagBits::eAllCommands;
+}
+
+void BarrierBatch::memory(vk::PipelineStageFlags srcStages_,
+                          vk::AccessFlags        srcAccess,
+                          vk::PipelineStageFlags dstStages_,
+                          vk::AccessFlags        dstAccess) {
+    vk::MemoryBarrier barrier{};
+    barrier.setSrcAccessMask(srcAccess).setDstAccessMask(dstAccess);
+    memoryBarriers.push_back(barrier);
+    srcStages |= srcStages_;
+    dstStages |= dstStages_;
+}
+
+void BarrierBatch::record(const vk::CommandBuffer& cmdBuffer) {
+    if (empty()) {
+        return;
+    }
+    cmdBuffer.pipelineBarrier(
+        srcStages, dstStages, {}, memoryBarriers, bufferBarriers, imageBarriers);
+
+    memoryBarriers.clear();
+    bufferBarriers.clear();
+    imageBarriers.clear();
+    srcStages = {};
+    dstStages = {};
+}
+
+vk::ImageLayout BarrierBatch::getLayout(vk::Image image, uint32_t mip) const {
+    auto found = layouts.find(static_cast<VkImage>(image));
+    if (found == layouts.end() || mip >= found->second.size()) {
+        return vk::ImageLayout::eUndefined;
+    }
+    return found->second[mip];
+}
+
+bool BarrierBatch::empty() const {
+    return memoryBarriers.empty() && bufferBarriers.empty() && imageBarriers.empty();
+}
+
+void BarrierBatch::reset() {
+    layouts.clear();
+    memoryBarriers.clear();
+    bufferBarriers.clear();
+    imageBarriers.clear();
+    srcStages = {};
+    dstStages = {};
+}
+
+std::vector<BarrierBatch::LevelRun> BarrierBatch::advance(vk::Image       image,
+                                                          uint32_t        baseMip,
+                                                          uint32_t        levelCount,
+                                                          vk::ImageLayout newLayout) {
+    auto& levels = layouts[static_cast<VkImage>(image)];
+    if (levels.size() < baseMip + levelCount) {
+        levels.resize(baseMip + levelCount, vk::ImageLayout::eUndefined);
+    }
+
+    std::vector<LevelRun> runs{};
+    for (uint32_t mip = baseMip; mip < baseMip + levelCount; mip++) {
+        auto oldLayout = levels[mip];
+        if (oldLayout == newLayout) {
+            continue;
+        }
+        levels[mip] = newLayout;
+
+        if (!runs.empty() && runs.back().oldLayout == oldLayout &&
+            runs.back().baseMip + runs.back().levelCount == mip) {
+            runs.back().levelCount++;
+        } else {
+            runs.push_back({mip, 1, oldLayout});
+        }
+    }
+    return runs;
+}
+
+} // namespace TBE::Graphics
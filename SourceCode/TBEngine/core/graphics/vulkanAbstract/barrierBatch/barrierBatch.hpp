@@ -0,0 +1,93 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// the stages and the accesses an image is used with in a layout
+struct LayoutUsage {
+    vk::PipelineStageFlags stages{};
+    vk::AccessFlags        access{};
+};
+
+LayoutUsage getLayoutUsage(vk::ImageLayout layout);
+
+/**
+ * @brief Collects barriers and records all of them with a single pipelineBarrier.
+ *
+ * @details The layout of every mip level of an image is remembered from its first transition on,
+ * so a transition only names the layout it goes to and levels already there are left out. Levels
+ * coming from the same layout share one barrier. Stages and accesses follow from the layouts, see
+ * getLayoutUsage(). record() merges the stage masks of everything queued since the last call,
+ * which is as strict as recording the barriers one by one and costs one command.
+ * An image nobody has transitioned yet is taken to be in eUndefined, freshly created that is, the
+ * layouts are only kept until reset().
+ * A release to another queue family queues the matching acquire into the batch of that family,
+ * both carry the same layout transition and it happens once.
+ */
+class BarrierBatch {
+public:
+    BarrierBatch() = default;
+
+public:
+    void transition(vk::Image            image,
+                    uint32_t             baseMip,
+                    uint32_t             levelCount,
+                    vk::ImageLayout      newLayout,
+                    vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor);
+
+    // transition and release the levels to dstFamily, acquire is recorded on that family
+    void release(vk::Image            image,
+                 uint32_t             baseMip,
+                 uint32_t             levelCount,
+                 vk::ImageLayout      newLayout,
+                 uint32_t             srcFamily,
+                 uint32_t             dstFamily,
+                 BarrierBatch&        acquire,
+                 vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor);
+    // a buffer written by transfers, read by anything after the acquire
+    void release(vk::Buffer buffer, uint32_t srcFamily, uint32_t dstFamily, BarrierBatch& acquire);
+
+    // a global barrier, for what is not handed to another family
+    void memory(vk::PipelineStageFlags srcStages,
+                vk::AccessFlags        srcAccess,
+                vk::PipelineStageFlags dstStages,
+                vk::AccessFlags        dstAccess);
+
+    // nothing is recorded when nothing is queued
+    void record(const vk::CommandBuffer& cmdBuffer);
+
+    vk::ImageLayout getLayout(vk::Image image, uint32_t mip) const;
+    bool            empty() const;
+    // forget the layouts too, the images may be destroyed and their handles reused
+    void            reset();
+
+private:
+    // levels coming from the same layout, they share a barrier
+    struct LevelRun {
+        uint32_t        baseMip{};
+        uint32_t        levelCount{};
+        vk::ImageLayout oldLayout{};
+    };
+
+    // the runs of levels not in newLayout yet, which are then taken to be in it
+    std::vector<LevelRun> advance(vk::Image       image,
+                                  uint32_t        baseMip,
+                                  uint32_t        levelCount,
+                                  vk::ImageLayout newLayout);
+
+private:
+    std::unordered_map<VkImage, std::vector<vk::ImageLayout>> layouts{};
+
+    std::vector<vk::MemoryBarrier>       memoryBarriers{};
+    std::vector<vk::BufferMemoryBarrier> bufferBarriers{};
+    std::vector<vk::ImageMemoryBarrier>  imageBarriers{};
+    vk::PipelineStageFlags               srcStages{};
+    vk::PipelineStageFlags               dstStages{};
+};
+
+} // namespace TBE::Graphics
@@ -1,92 +1,111 @@
 #include "bufferResource.hpp"
 #include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
-#include "TBEngine/core/graphics/vulkanAbstract/bufferResource/stagingBuffer.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/uploadBatch/uploadBatch.hpp"
 #include "TBEngine/core/graphics/graphics.hpp"
 
+#include <utility>
+
 namespace TBE::Graphics {
 using namespace TBE::Graphics::Detail;
 using TBE::Utils::Log::logErrorMsg;
 
+BufferResource::BufferResource(BufferResource&& other) noexcept
+    : VulkanAbstractBase()
+    , buffer(std::exchange(other.buffer, nullptr))
+    , allocation(std::exchange(other.allocation, {}))
+    , size(std::exchange(other.size, 0)) {
+}
+
+BufferResource& BufferResource::operator=(BufferResource&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        buffer     = std::exchange(other.buffer, nullptr);
+        allocation = std::exchange(other.allocation, {});
+        size       = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
 BufferResource::~BufferResource() {
     destroy();
 }
 
+// the handles are checked, the device may already be gone when a static owner is destructed
 void BufferResource::destroy() {
-    static bool destroyed = false;
-    if (!destroyed) {
+    if (buffer) {
         device.destroy(buffer);
-        device.free(memory);
-        destroyed = true;
+        buffer = nullptr;
     }
+    MemoryAllocator::get().free(allocation);
+    size = 0;
 }
 
 void BufferResource::init(const std::span<std::byte>& inData,
                           vk::BufferUsageFlags        usage,
                           vk::MemoryPropertyFlags     memPro) {
-    size = inData.size();
+    UploadBatch batch{};
+    init(inData, usage, memPro, batch);
+    batch.submit();
+}
 
-    std::tie(buffer, memory) = createBuffer(size, usage, memPro, phyDevice.getMemoryProperties());
+void BufferResource::init(const std::span<std::byte>& inData,
+                          vk::BufferUsageFlags        usage,
+                          vk::MemoryPropertyFlags     memPro,
+                          UploadBatch&                batch) {
+    size = inData.size();
 
-    StagingBuffer stagingBuffer{inData};
+    std::tie(buffer, allocation) = createBuffer(size, usage, memPro);
 
+    auto staging = batch.stage(inData);
 
-    Graphics::disposableCommands([&stagingBuffer, this](vk::CommandBuffer& cmdBuffer) {
-        vk::BufferCopy copyRegion{};
-        copyRegion.setSize(this->size);
-        cmdBuffer.copyBuffer(stagingBuffer.buffer, this->buffer, 1, &copyRegion);
-    });
+    vk::BufferCopy copyRegion{};
+    copyRegion.setSrcOffset(staging.offset).setSize(size);
+    batch.getCmdBuffer().copyBuffer(staging.buffer, buffer, 1, &copyRegion);
+    batch.handOver(buffer);
 }
 
-std::tuple<vk::Buffer, vk::DeviceMemory>
-BufferResource::createBuffer(vk::DeviceSize                     size,
-                             vk::BufferUsageFlags               usage,
-                             vk::MemoryPropertyFlags            memPro,
-                             vk::PhysicalDeviceMemoryProperties phyMemPro) {
-    vk::Buffer       buffer{};
-    vk::DeviceMemory bufferMemory{};
+std::tuple<vk::Buffer, MemoryAllocation>
+BufferResource::createBuffer(vk::DeviceSize          size,
+                             vk::BufferUsageFlags    usage,
+                             vk::MemoryPropertyFlags memPro) {
+    vk::Buffer buffer{};
 
     vk::BufferCreateInfo bufferInfo{};
     bufferInfo.setSize(size).setUsage(usage).setSharingMode(vk::SharingMode::eExclusive);
 
     depackReturnValue(buffer, device.createBuffer(bufferInfo));
 
-    auto memRequirements = device.getBufferMemoryRequirements(buffer);
-
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.setAllocationSize(memRequirements.size)
-        .setMemoryTypeIndex(findMemoryType(phyMemPro, memRequirements.memoryTypeBits, memPro));
+    auto bufferAllocation = MemoryAllocator::get().allocate(buffer, memPro);
 
-    depackReturnValue(bufferMemory, device.allocateMemory(allocInfo));
-
-    handleVkResult(device.bindBufferMemory(buffer, bufferMemory, 0));
+    return std::make_tuple(std::move(buffer), std::move(bufferAllocation));
+}
 
-    return std::make_tuple(std::move(buffer), std::move(bufferMemory));
+BufferResourceUniform::BufferResourceUniform(BufferResourceUniform&& other) noexcept
+    : BufferResource(std::move(other))
+    , mapPtr(std::exchange(other.mapPtr, nullptr))
+    , bufferSize(std::exchange(other.bufferSize, 0)) {
 }
 
 BufferResourceUniform::~BufferResourceUniform() {
     destroy();
 }
 
+// the memory stays mapped by the allocator
 void BufferResourceUniform::destroy() {
-    static bool destroyed = false;
-    if (!destroyed) {
-        device.destroy(buffer);
-        device.free(memory);
-        destroyed = true;
-    }
+    BufferResource::destroy();
+    mapPtr     = nullptr;
+    bufferSize = 0;
 }
 
-void BufferResourceUniform::init(vk::DeviceSize                            size,
-                                 const vk::PhysicalDeviceMemoryProperties& phyMemPro) {
+void BufferResourceUniform::init(vk::DeviceSize size) {
     bufferSize = size;
 
-    std::tie(buffer, memory) = createBuffer(bufferSize,
-                                            vk::BufferUsageFlagBits::eUniformBuffer,
-                                            vk::MemoryPropertyFlagBits::eHostVisible |
-                                                vk::MemoryPropertyFlagBits::eHostCoherent,
-                                            phyMemPro);
+    std::tie(buffer, allocation) = createBuffer(bufferSize,
+                                                vk::BufferUsageFlagBits::eUniformBuffer,
+                                                vk::MemoryPropertyFlagBits::eHostVisible |
+                                                    vk::MemoryPropertyFlagBits::eHostCoherent);
 
-    depackReturnValue(mapPtr, device.mapMemory(memory, 0, bufferSize));
+    mapPtr = allocation.mapped;
 }
 
 void BufferResourceUniform::update(const std::span<std::byte>& newData) {
@@ -2,44 +2,58 @@
 
 #include "TBEngine/utils/includes/includeVulkan.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
 
 #include <span>
 #include <tuple>
 
 namespace TBE::Graphics {
 
+class UploadBatch;
+
+// owns its buffer and memory, moving hands them over and leaves the source empty
 class BufferResource : public VulkanAbstractBase {
 public:
     BufferResource() : VulkanAbstractBase() {}
+    BufferResource(BufferResource&& other) noexcept;
+    BufferResource& operator=(BufferResource&& other) noexcept;
     ~BufferResource();
     void destroy() override;
 
+    BufferResource(const BufferResource&)            = delete;
+    BufferResource& operator=(const BufferResource&) = delete;
+
 public:
+    // records the copy into the shared upload context, frames drawn from now on see the data
     void init(const std::span<std::byte>& inData,
               vk::BufferUsageFlags        usage,
               vk::MemoryPropertyFlags     memPro);
 
+    // only records the copy, the data may not be read before the batch is done
+    void init(const std::span<std::byte>& inData,
+              vk::BufferUsageFlags        usage,
+              vk::MemoryPropertyFlags     memPro,
+              UploadBatch&                batch);
+
 public:
     vk::Buffer       buffer{};
-    vk::DeviceMemory memory{};
+    MemoryAllocation allocation{};
     vk::DeviceSize   size{};
 
 protected:
-    [[nodiscard]] std::tuple<vk::Buffer, vk::DeviceMemory>
-    createBuffer(vk::DeviceSize                     size,
-                 vk::BufferUsageFlags               usage,
-                 vk::MemoryPropertyFlags            memPro,
-                 vk::PhysicalDeviceMemoryProperties phyMemPro);
+    [[nodiscard]] std::tuple<vk::Buffer, MemoryAllocation>
+    createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags memPro);
 };
 
 class BufferResourceUniform : public BufferResource {
 public:
     BufferResourceUniform() {}
+    BufferResourceUniform(BufferResourceUniform&& other) noexcept;
     ~BufferResourceUniform();
     void destroy() override;
 
 public:
-    void init(vk::DeviceSize size, const vk::PhysicalDeviceMemoryProperties& phyMemPro);
+    void init(vk::DeviceSize size);
 
     void update(const std::span<std::byte>& newData);
 
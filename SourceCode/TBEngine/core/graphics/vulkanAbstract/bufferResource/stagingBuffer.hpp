@@ -2,9 +2,9 @@
 
 #include "TBEngine/utils/includes/includeVulkan.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
-#include "TBEngine/core/graphics/vulkanAbstract/imageResource/imageResource.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
 
-#include <functional>
+#include <span>
 
 namespace TBE::Graphics {
 
@@ -16,12 +16,11 @@ public:
 
 public:
     void destroy() override;
-    void copyTo(ImageResource* imageR, uint32_t width, uint32_t height);
 
 public:
     vk::Buffer       buffer{};
-    vk::DeviceMemory memory{};
-    void*            data = nullptr;
+    MemoryAllocation allocation{};
+    void*            data = nullptr; // persistently mapped by the allocator
 
 private:
     void createBuffer(const std::span<std::byte>& inData);
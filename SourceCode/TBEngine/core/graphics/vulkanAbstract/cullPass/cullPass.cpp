@@ -0,0 +1,206 @@
+#include "cullPass.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/core/graphics/graphics.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/barrierBatch/barrierBatch.hpp"
+#include "TBEngine/settings.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+
+static constexpr uint32_t cullGroupSize   = 64; // local_size_x of Shaders/cull.comp
+static constexpr uint32_t cullBufferCount = 8;  // the frame ring bindings 1 to 8
+static constexpr uint32_t meshletBinding  = 9;  // the meshlet buffer of the geometry pools
+static constexpr uint32_t drawCommandSize = sizeof(vk::DrawIndexedIndirectCommand);
+
+// what the template of the set is written from, every storage binding is the whole buffer and
+// the push constants index into it, the meshlet binding holds the ring as well without meshlets
+struct CullSetData {
+    vk::DescriptorBufferInfo frame{};
+    vk::DescriptorBufferInfo ring{};
+    vk::DescriptorBufferInfo meshlets{};
+};
+
+CullPass::~CullPass() {
+    destroy();
+}
+
+std::vector<const char*> CullPass::getOptionalExtensions(const vk::PhysicalDevice& phyDevice) {
+    if (GPU_DRIVEN_RENDERING &&
+        checkDeviceExtensionSupport(phyDevice, {vk::KHRDrawIndirectCountExtensionName})) {
+        return {vk::KHRDrawIndirectCountExtensionName};
+    }
+    return {};
+}
+
+void CullPass::init(const vk::PipelineShaderStageCreateInfo& stage,
+                    std::span<const vk::Buffer>              frameBuffers,
+                    vk::DeviceSize                           frameDataSize) {
+    auto graphicsFamily = VulkanGraphics::uploadContext.getQueueFamilies()[0];
+    auto familyFlags    = phyDevice.getQueueFamilyProperties()[graphicsFamily].queueFlags;
+    if (!GPU_DRIVEN_RENDERING || !(familyFlags & vk::QueueFlagBits::eCompute)) {
+        logger->info("GPU culling is off, instances are drawn by the CPU");
+        return;
+    }
+    // the commands start at the instance ids of their model, LOD or meshlet
+    if (!phyDevice.getFeatures().drawIndirectFirstInstance) {
+        logger->info("no drawIndirectFirstInstance, instances are drawn by the CPU");
+        return;
+    }
+
+    std::array<vk::DescriptorSetLayoutBinding, 2 + cullBufferCount> bindings{};
+    bindings[0]
+        .setBinding(0)
+        .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+        .setDescriptorCount(1)
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    for (uint32_t i = 1; i < bindings.size(); i++) {
+        bindings[i]
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+    setLayout = VulkanGraphics::objectCache.getSetLayout(bindings);
+
+    // a set is allocated and written every frame, the meshlet buffer may have been recreated
+    std::array<vk::DescriptorUpdateTemplateEntry, 2 + cullBufferCount> entries{};
+    entries[0] = {
+        0, 0, 1, vk::DescriptorType::eUniformBufferDynamic, offsetof(CullSetData, frame), 0};
+    for (uint32_t binding = 1; binding < entries.size(); binding++) {
+        auto offset      = binding == meshletBinding ? offsetof(CullSetData, meshlets)
+                                                     : offsetof(CullSetData, ring);
+        entries[binding] = {binding, 0, 1, vk::DescriptorType::eStorageBuffer, offset, 0};
+    }
+    setTemplate = VulkanGraphics::descriptorAllocator.createTemplate(setLayout, entries);
+    this->frameBuffers.assign(frameBuffers.begin(), frameBuffers.end());
+    this->frameDataSize = frameDataSize;
+
+    vk::PushConstantRange pushConstantRange{
+        vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullParams)};
+    layout = VulkanGraphics::objectCache.getPipelineLayout(setLayout, pushConstantRange);
+
+    vk::ComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.setStage(stage).setLayout(layout);
+    depackReturnValue(pipeline, device.createComputePipeline(nullptr, pipelineInfo));
+
+    // both are optional, the draws fall back to what the device has
+    multiDraw = phyDevice.getFeatures().multiDrawIndirect;
+    if (!getOptionalExtensions(phyDevice).empty()) {
+        drawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            device.getProcAddr("vkCmdDrawIndexedIndirectCountKHR"));
+    }
+    logger->info(std::string("GPU culling is on, ") +
+                 (hasDrawCount() ? "draws are packed and counted"
+                  : multiDraw    ? "every command of a pool is drawn at once"
+                                 : "every command is drawn on its own"));
+}
+
+// the handles are checked, the device may already be gone when a static owner is destructed
+void CullPass::destroy() {
+    if (pipeline) {
+        device.destroy(pipeline);
+        pipeline = nullptr;
+    }
+    // both layouts belong to the object cache, the template to the descriptor allocator
+    layout    = nullptr;
+    setLayout = nullptr;
+    frameBuffers.clear();
+    drawIndexedIndirectCount = nullptr;
+}
+
+void CullPass::record(const vk::CommandBuffer& cmdBuffer,
+                      uint32_t                 frame,
+                      uint32_t                 frameDataOffset,
+                      CullParams               params,
+                      const vk::Buffer&        meshletBuffer,
+                      uint32_t                 maxMeshlets) {
+    // the geometry pools create and regrow their meshlet buffer, a transient set of the frame
+    // picks up the current one and costs no allocation once the pools of the frame have grown
+    CullSetData data{};
+    data.frame    = {frameBuffers[frame], 0, frameDataSize};
+    data.ring     = {frameBuffers[frame], 0, vk::WholeSize};
+    data.meshlets = {meshletBuffer ? meshletBuffer : frameBuffers[frame], 0, vk::WholeSize};
+
+    auto set = VulkanGraphics::descriptorAllocator.allocateTransient(setLayout);
+    VulkanGraphics::descriptorAllocator.update(set, setTemplate, &data);
+
+    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+    cmdBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute, layout, 0, set, frameDataOffset);
+
+    // the ring is host coherent and written before the submit, which makes it visible already
+    params.mode = 0;
+    cmdBuffer.pushConstants(
+        layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullParams), &params);
+    cmdBuffer.dispatch((params.objectCount + cullGroupSize - 1) / cullGroupSize, 1, 1);
+
+    // reads only what the CPU wrote and appends to the packed commands and the counts, which the
+    // first dispatch leaves alone and the second adds to atomically, so it needs no barrier
+    if (params.clusterCount > 0 && maxMeshlets > 0 && hasDrawCount()) {
+        params.mode = 2;
+        cmdBuffer.pushConstants(
+            layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullParams), &params);
+        cmdBuffer.dispatch((maxMeshlets + cullGroupSize - 1) / cullGroupSize,
+                           std::min(params.clusterCount, maxClusterInstances),
+                           1);
+    }
+
+    BarrierBatch barriers{};
+    if (hasDrawCount()) {
+        barriers.memory(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::AccessFlagBits::eShaderWrite,
+                        vk::PipelineStageFlagBits::eComputeShader,
+                        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+        barriers.record(cmdBuffer);
+
+        params.mode = 1;
+        cmdBuffer.pushConstants(
+            layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullParams), &params);
+        cmdBuffer.dispatch((params.slotCount + cullGroupSize - 1) / cullGroupSize, 1, 1);
+    }
+
+    barriers.memory(vk::PipelineStageFlagBits::eComputeShader,
+                    vk::AccessFlagBits::eShaderWrite,
+                    vk::PipelineStageFlagBits::eDrawIndirect |
+                        vk::PipelineStageFlagBits::eVertexShader,
+                    vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead);
+    // the validation and the meshlet counters are read back once the fence of the frame has
+    // signalled
+    if (GPU_CULLING_VALIDATION || params.clusterCount > 0) {
+        barriers.memory(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::AccessFlagBits::eShaderWrite,
+                        vk::PipelineStageFlagBits::eHost,
+                        vk::AccessFlagBits::eHostRead);
+    }
+    barriers.record(cmdBuffer);
+}
+
+void CullPass::drawIndirect(const vk::CommandBuffer& cmdBuffer,
+                            const vk::Buffer&        buffer,
+                            vk::DeviceSize           commandOffset,
+                            vk::DeviceSize           packedOffset,
+                            vk::DeviceSize           countOffset,
+                            uint32_t                 drawCount) const {
+    if (hasDrawCount()) {
+        drawIndexedIndirectCount(cmdBuffer,
+                                 buffer,
+                                 packedOffset,
+                                 buffer,
+                                 countOffset,
+                                 drawCount,
+                                 drawCommandSize);
+    } else if (multiDraw) {
+        cmdBuffer.drawIndexedIndirect(buffer, commandOffset, drawCount, drawCommandSize);
+    } else {
+        for (uint32_t i = 0; i < drawCount; i++) {
+            cmdBuffer.drawIndexedIndirect(
+                buffer, commandOffset + i * drawCommandSize, 1, drawCommandSize);
+        }
+    }
+}
+
+} // namespace TBE::Graphics
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// push constants of Shaders/cull.comp, every base is an element index into the frame ring buffer
+struct CullParams {
+    uint32_t objectBase{};
+    uint32_t objectCount{};
+    uint32_t drawBase{};
+    uint32_t slotCount{};
+    uint32_t commandBase{};
+    uint32_t idBase{};
+    uint32_t packedBase{};
+    uint32_t countBase{};
+    uint32_t clusterBase{};
+    uint32_t clusterCount{}; // cluster instances, 0 skips the meshlet dispatch
+    uint32_t statBase{};     // two counters, the meshlets kept and those facing away
+    uint32_t mode{};         // set by record()
+};
+
+/**
+ * @brief Frustum culling of every instance in a compute pass, which writes the indirect draws.
+ *
+ * @details The first dispatch tests one instance per invocation against the frustum of the frame
+ * and appends the visible ones to the instance ids of their command, raising its instanceCount.
+ * The second one packs the commands that kept an instance per geometry pool and counts them, so
+ * a pool is drawn by one drawIndexedIndirectCount. Everything the pass reads and writes lives in
+ * the frame ring, the CPU only writes one command per model whatever the instance count.
+ * Cluster instances, those whose meshlets are culled one by one, are skipped by the first
+ * dispatch and get one of their own with an invocation per meshlet, every meshlet kept is packed
+ * as a command of its own. It needs the draw counts, SceneInterface makes no cluster instances
+ * without them.
+ * Without VK_KHR_draw_indirect_count every command of the pool is drawn, empty ones cost next to
+ * nothing, and without multiDrawIndirect they are drawn one call each. The pass is disabled when
+ * no culling shader was loaded, GPU_DRIVEN_RENDERING is off, the graphics queue cannot compute or
+ * the device lacks drawIndirectFirstInstance, SceneInterface then draws on the CPU.
+ */
+class CullPass final : public VulkanAbstractBase {
+    using super = VulkanAbstractBase;
+
+public:
+    CullPass() : super() {}
+    ~CullPass();
+
+    CullPass(const CullPass&)            = delete;
+    CullPass& operator=(const CullPass&) = delete;
+
+    // binding 0 is the frame data at a dynamic offset in the frame buffer, the others the whole
+    // buffer
+    void init(const vk::PipelineShaderStageCreateInfo& stage,
+              std::span<const vk::Buffer>              frameBuffers,
+              vk::DeviceSize                           frameDataSize);
+    void destroy() override;
+
+    // the device extensions the pass uses when the device has them
+    static std::vector<const char*> getOptionalExtensions(const vk::PhysicalDevice& phyDevice);
+
+    // one group row each, the smallest maxComputeWorkGroupCount[1] a device may have
+    static constexpr uint32_t maxClusterInstances = 65535;
+
+public:
+    bool isEnabled() const { return pipeline; }
+    bool hasDrawCount() const { return drawIndexedIndirectCount != nullptr; }
+
+    // the dispatches and the barriers that hand their results to the draws, outside a render pass
+    // maxMeshlets is the meshlet count of the largest mesh among the cluster instances
+    void record(const vk::CommandBuffer& cmdBuffer,
+                uint32_t                 frame,
+                uint32_t                 frameDataOffset,
+                CullParams               params,
+                const vk::Buffer&        meshletBuffer = {},
+                uint32_t                 maxMeshlets   = 0);
+
+    // draw the drawCount commands of one pool, packed and counted ones if the device reads counts
+    void drawIndirect(const vk::CommandBuffer& cmdBuffer,
+                      const vk::Buffer&        buffer,
+                      vk::DeviceSize           commandOffset,
+                      vk::DeviceSize           packedOffset,
+                      vk::DeviceSize           countOffset,
+                      uint32_t                 drawCount) const;
+
+private:
+    vk::DescriptorSetLayout setLayout{};
+    uint32_t                setTemplate{}; // of the descriptor allocator, writes a whole set
+    vk::PipelineLayout      layout{};
+    vk::Pipeline            pipeline{};
+    std::vector<vk::Buffer> frameBuffers{};
+    vk::DeviceSize          frameDataSize{};
+
+    PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount = nullptr;
+    bool                                 multiDraw                = false;
+};
+
+} // namespace TBE::Graphics
@@ -1,4 +1,9 @@
 #include "descriptor.hpp"
+#include "TBEngine/core/graphics/graphics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
 
 namespace TBE::Graphics {
 
@@ -9,54 +14,133 @@ Descriptor::~Descriptor() {
 void Descriptor::destroy() {
     static bool destroyed = false;
     if (!destroyed) {
-        device.destroy(pool);
-        device.destroy(layout);
+        // the layout belongs to the object cache, the sets to the descriptor allocator
+        layout      = nullptr;
+        tableLayout = nullptr;
+        sets.clear();
+        tableSets.clear();
         destroyed = true;
     }
 }
 
 void Descriptor::initLayout(const std::span<const vk::DescriptorSetLayoutBinding>& bindings) {
-    vk::DescriptorSetLayoutCreateInfo layoutInfo{
-        {}, static_cast<uint32_t>(bindings.size()), bindings.data()};
-    depackReturnValue(layout, device.createDescriptorSetLayout(layoutInfo));
+    layout = VulkanGraphics::objectCache.getSetLayout(bindings);
 }
 
-void Descriptor::initPool(uint32_t maxSets, const std::span<vk::DescriptorPoolSize> poolSizes) {
-    vk::DescriptorPoolCreateInfo poolInfo{{}, maxSets, poolSizes};
-    depackReturnValue(pool, device.createDescriptorPool(poolInfo));
+void Descriptor::initTableLayout(uint32_t                   tableSize,
+                                 vk::DescriptorBindingFlags bindingFlags,
+                                 bool                       updateAfterBind) {
+    vk::DescriptorSetLayoutBinding binding{};
+    binding.setBinding(0)
+        .setDescriptorType(vk::DescriptorType::eSampledImage)
+        .setDescriptorCount(tableSize)
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+    tableLayout = VulkanGraphics::objectCache.getSetLayout(
+        binding,
+        updateAfterBind ? vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool
+                        : vk::DescriptorSetLayoutCreateFlags{},
+        bindingFlags);
 }
 
-void Descriptor::initSets(const std::span<BufferResourceUniform> uniBuffers,
-                          const vk::Sampler&                     sampler,
-                          const vk::ImageView&                   sampleTarget) {
-    // the copy here is needed, because one layout is need to be specified for every descriptor set
-    auto                                 numSets = static_cast<uint32_t>(uniBuffers.size());
-    std::vector<vk::DescriptorSetLayout> layouts(numSets, layout);
-    vk::DescriptorSetAllocateInfo        allocInfo{pool, layouts};
+void Descriptor::initSets(const std::span<const vk::Buffer> frameBuffers,
+                          vk::DeviceSize                    frameDataSize,
+                          const vk::Sampler&                sampler,
+                          const vk::ImageView&              placeholder,
+                          uint32_t                          tableSize,
+                          bool                              partiallyBound) {
+    auto& allocator = VulkanGraphics::descriptorAllocator;
+    auto  numSets   = static_cast<uint32_t>(frameBuffers.size());
+
+    // bindings 0 to 4 come from one SetData, objects, instance ids and draws are all indexed in
+    // the whole buffer
+    struct SetData {
+        vk::DescriptorBufferInfo frame{};
+        vk::DescriptorImageInfo  sampler{};
+        vk::DescriptorBufferInfo ring{};
+    };
+    std::array<vk::DescriptorUpdateTemplateEntry, 5> entries{};
+    entries[0] = {0, 0, 1, vk::DescriptorType::eUniformBufferDynamic, offsetof(SetData, frame), 0};
+    entries[1] = {1, 0, 1, vk::DescriptorType::eSampler, offsetof(SetData, sampler), 0};
+    for (uint32_t binding = 2; binding < 5; binding++) {
+        entries[binding] = {
+            binding, 0, 1, vk::DescriptorType::eStorageBuffer, offsetof(SetData, ring), 0};
+    }
+    auto setTemplate = allocator.createTemplate(layout, entries);
+
+    // without partially bound every element of the table is written, the shader may index any of
+    // them, with it an element is written once a slot shows it, none is bound yet
+    auto shown = partiallyBound ? vk::ImageView{} : placeholder;
+    sets.resize(numSets);
+    tableSets.resize(numSets);
+    boundTextures.assign(numSets, std::vector<vk::ImageView>(tableSize, shown));
+    boundVersions.assign(numSets, 0);
 
-    depackReturnValue(sets, device.allocateDescriptorSets(allocInfo));
+    std::vector<vk::DescriptorImageInfo> tableInfos(
+        partiallyBound ? 0 : tableSize,
+        {nullptr, placeholder, vk::ImageLayout::eShaderReadOnlyOptimal});
     for (size_t i = 0; i < numSets; i++) {
-        vk::DescriptorBufferInfo bufferInfo{uniBuffers[i].buffer, 0, uniBuffers[i].size};
-        vk::DescriptorImageInfo  imageInfo{
-            sampler, sampleTarget, vk::ImageLayout::eShaderReadOnlyOptimal};
+        sets[i] = allocator.allocate(layout);
 
-        std::vector<vk::WriteDescriptorSet> desWrites(2, vk::WriteDescriptorSet{});
-        desWrites[0]
-            .setDstSet(sets[i])
+        SetData data{};
+        data.frame   = {frameBuffers[i], 0, frameDataSize};
+        data.sampler = {sampler, nullptr, {}};
+        data.ring    = {frameBuffers[i], 0, vk::WholeSize};
+        allocator.update(sets[i], setTemplate, &data);
+        tableSets[i] = allocator.allocateBindless(tableLayout);
+        if (tableInfos.empty()) {
+            continue;
+        }
+
+        vk::WriteDescriptorSet tableWrite{};
+        tableWrite.setDstSet(tableSets[i])
             .setDstBinding(0)
             .setDstArrayElement(0)
-            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-            .setDescriptorCount(1)
-            .setPBufferInfo(&bufferInfo);
-        desWrites[1]
-            .setDstSet(sets[i])
-            .setDstBinding(1)
-            .setDstArrayElement(0)
-            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-            .setDescriptorCount(1)
-            .setPImageInfo(&imageInfo);
-        device.updateDescriptorSets(desWrites, nullptr);
+            .setDescriptorType(vk::DescriptorType::eSampledImage)
+            .setImageInfo(tableInfos);
+        device.updateDescriptorSets(tableWrite, nullptr);
+    }
+}
+
+void Descriptor::updateTextures(size_t                         setIdx,
+                                std::span<const vk::ImageView> table,
+                                uint64_t                       version) {
+    if (boundVersions[setIdx] == version) {
+        return;
+    }
+    boundVersions[setIdx] = version;
+
+    auto& bound = boundTextures[setIdx];
+    auto  count = std::min(table.size(), bound.size());
+
+    // the infos of all runs stay alive until the one update call
+    std::vector<vk::DescriptorImageInfo> infos{};
+    std::vector<vk::WriteDescriptorSet>  desWrites{};
+    std::vector<size_t>                  runFirst{};
+    for (size_t i = 0; i < count;) {
+        if (bound[i] == table[i]) {
+            i++;
+            continue;
+        }
+        runFirst.push_back(infos.size());
+        auto& desWrite = desWrites.emplace_back();
+        desWrite.setDstSet(tableSets[setIdx])
+            .setDstBinding(0)
+            .setDstArrayElement(static_cast<uint32_t>(i))
+            .setDescriptorType(vk::DescriptorType::eSampledImage);
+        for (; i < count && bound[i] != table[i]; i++) {
+            infos.push_back({nullptr, table[i], vk::ImageLayout::eShaderReadOnlyOptimal});
+            bound[i] = table[i];
+        }
+    }
+    if (desWrites.empty()) {
+        return;
+    }
+    for (size_t run = 0; run < desWrites.size(); run++) {
+        auto end = run + 1 < runFirst.size() ? runFirst[run + 1] : infos.size();
+        desWrites[run].setPImageInfo(&infos[runFirst[run]]).setDescriptorCount(
+            static_cast<uint32_t>(end - runFirst[run]));
     }
+    device.updateDescriptorSets(desWrites, nullptr);
 }
 
 } // namespace TBE::Graphics
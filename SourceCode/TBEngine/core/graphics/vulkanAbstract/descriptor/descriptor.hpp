@@ -2,7 +2,6 @@
 
 #include "TBEngine/utils/includes/includeVulkan.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
-#include "TBEngine/core/graphics/vulkanAbstract/bufferResource/bufferResource.hpp"
 
 #include <vector>
 #include <span>
@@ -20,15 +19,37 @@ public:
 
 public:
     void initLayout(const std::span<const vk::DescriptorSetLayoutBinding>& bindings);
-    void initPool(uint32_t maxSets, const std::span<vk::DescriptorPoolSize> poolSizes);
-    void initSets(const std::span<BufferResourceUniform> uniBuffers,
-                  const vk::Sampler&                     sampler,
-                  const vk::ImageView&                   sampleTarget);
+    // the texture table is set 1, binding 0, tableSize sampled images of the fragment stage, a
+    // layout updated after bind must not hold the dynamic uniform buffer of set 0
+    void initTableLayout(uint32_t                   tableSize,
+                         vk::DescriptorBindingFlags bindingFlags,
+                         bool                       updateAfterBind);
+    // two sets per frame buffer from the descriptor allocator, binding 0 of the first is a dynamic
+    // uniform buffer of frameDataSize bytes in it, bindings 2 to 4 the whole buffer as storage
+    // buffers, binding 1 the sampler of every texture, the second the texture table, tableSize
+    // elements that all show placeholder, or none written while partiallyBound, updateTextures()
+    // then writes the elements of the table it is given
+    void initSets(const std::span<const vk::Buffer> frameBuffers,
+                  vk::DeviceSize                    frameDataSize,
+                  const vk::Sampler&                sampler,
+                  const vk::ImageView&              placeholder,
+                  uint32_t                          tableSize,
+                  bool                              partiallyBound);
+
+    // rewrite the elements of the texture table of one set that changed, runs of them at once,
+    // the set must not be in use by the GPU, nothing is compared while version is the one the set
+    // was last updated to
+    void updateTextures(size_t setIdx, std::span<const vk::ImageView> table, uint64_t version);
 
 public:
-    vk::DescriptorPool             pool{};
     vk::DescriptorSetLayout        layout{};
+    vk::DescriptorSetLayout        tableLayout{};
     std::vector<vk::DescriptorSet> sets{};
+    std::vector<vk::DescriptorSet> tableSets{};
+
+private:
+    std::vector<std::vector<vk::ImageView>> boundTextures{}; // per set, what its table shows
+    std::vector<uint64_t>                   boundVersions{}; // per set, the table version shown
 };
 
 } // namespace TBE::Graphics
@@ -0,0 +1,237 @@
+#include "descriptorAllocator.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/settings.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+
+static bool isImageDescriptor(vk::DescriptorType type) {
+    return type == vk::DescriptorType::eSampler ||
+           type == vk::DescriptorType::eCombinedImageSampler ||
+           type == vk::DescriptorType::eSampledImage || type == vk::DescriptorType::eStorageImage ||
+           type == vk::DescriptorType::eInputAttachment;
+}
+
+static bool isTexelDescriptor(vk::DescriptorType type) {
+    return type == vk::DescriptorType::eUniformTexelBuffer ||
+           type == vk::DescriptorType::eStorageTexelBuffer;
+}
+
+DescriptorAllocator::~DescriptorAllocator() {
+    destroy();
+}
+
+std::vector<const char*>
+DescriptorAllocator::getOptionalExtensions(const vk::PhysicalDevice& phyDevice) {
+    if (checkDeviceExtensionSupport(phyDevice, {vk::KHRDescriptorUpdateTemplateExtensionName})) {
+        return {vk::KHRDescriptorUpdateTemplateExtensionName};
+    }
+    return {};
+}
+
+void DescriptorAllocator::init(uint32_t           frameCount,
+                               const PoolProfile& persistentProfile,
+                               const PoolProfile& bindlessProfile,
+                               const PoolProfile& transientProfile) {
+    persistent.profile = persistentProfile;
+    bindless.profile   = bindlessProfile;
+    frames.assign(frameCount, PoolList{.profile = transientProfile});
+
+    if (!getOptionalExtensions(phyDevice).empty()) {
+        createUpdateTemplate = reinterpret_cast<PFN_vkCreateDescriptorUpdateTemplateKHR>(
+            device.getProcAddr("vkCreateDescriptorUpdateTemplateKHR"));
+        destroyUpdateTemplate = reinterpret_cast<PFN_vkDestroyDescriptorUpdateTemplateKHR>(
+            device.getProcAddr("vkDestroyDescriptorUpdateTemplateKHR"));
+        updateWithTemplate = reinterpret_cast<PFN_vkUpdateDescriptorSetWithTemplateKHR>(
+            device.getProcAddr("vkUpdateDescriptorSetWithTemplateKHR"));
+    }
+    logger->info(std::string("descriptor sets are written ") +
+                 (hasTemplates() ? "with update templates" : "with descriptor writes"));
+}
+
+// the lists are empty once destroyed, the device may already be gone when a static owner is
+// destructed
+void DescriptorAllocator::destroy() {
+    for (auto& templ : templates) {
+        if (templ.handle) {
+            destroyUpdateTemplate(device, templ.handle, nullptr);
+        }
+    }
+    templates.clear();
+
+    if (getPoolCount() > 0) {
+        logger->trace("descriptor allocator: " + std::to_string(getPoolCount()) + " pools");
+    }
+    for (auto* list : {&persistent, &bindless}) {
+        for (auto pool : list->pools) {
+            device.destroy(pool);
+        }
+        *list = {};
+    }
+    for (auto& frame : frames) {
+        for (auto pool : frame.pools) {
+            device.destroy(pool);
+        }
+    }
+    frames.clear();
+
+    createUpdateTemplate  = nullptr;
+    destroyUpdateTemplate = nullptr;
+    updateWithTemplate    = nullptr;
+}
+
+uint32_t DescriptorAllocator::getPoolCount() const {
+    auto count = persistent.pools.size() + bindless.pools.size();
+    for (const auto& frame : frames) {
+        count += frame.pools.size();
+    }
+    return static_cast<uint32_t>(count);
+}
+
+vk::DescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout layout) {
+    return allocateFrom(persistent, layout);
+}
+
+vk::DescriptorSet DescriptorAllocator::allocateBindless(vk::DescriptorSetLayout layout) {
+    return allocateFrom(bindless, layout);
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frame) {
+    currentFrame = frame;
+    auto& list   = frames[frame];
+    for (auto pool : list.pools) {
+        static_cast<void>(device.resetDescriptorPool(pool));
+    }
+    list.current = 0;
+}
+
+vk::DescriptorSet DescriptorAllocator::allocateTransient(vk::DescriptorSetLayout layout) {
+    return allocateFrom(frames[currentFrame], layout);
+}
+
+vk::DescriptorSet DescriptorAllocator::allocateFrom(PoolList&               list,
+                                                    vk::DescriptorSetLayout layout) {
+    while (true) {
+        bool added = false;
+        if (list.current == list.pools.size()) {
+            const auto& profile  = list.profile;
+            auto        shift    = std::min<size_t>(list.pools.size(), 31);
+            auto        setCount = std::min<uint64_t>(
+                uint64_t{profile.poolSets} << shift,
+                std::max(profile.poolSets, DESCRIPTOR_POOL_MAX_SETS));
+            std::vector<vk::DescriptorPoolSize> poolSizes(profile.setSizes);
+            for (auto& poolSize : poolSizes) {
+                poolSize.descriptorCount *= static_cast<uint32_t>(setCount);
+            }
+
+            vk::DescriptorPoolCreateInfo poolInfo{
+                profile.flags, static_cast<uint32_t>(setCount), poolSizes};
+            vk::DescriptorPool           pool{};
+            depackReturnValue(pool, device.createDescriptorPool(poolInfo));
+            list.pools.push_back(pool);
+            added = true;
+        }
+
+        vk::DescriptorSetAllocateInfo allocInfo{list.pools[list.current], layout};
+        vk::DescriptorSet             set{};
+        auto                          result = device.allocateDescriptorSets(&allocInfo, &set);
+        if (result == vk::Result::eSuccess) {
+            return set;
+        }
+        if (result != vk::Result::eErrorOutOfPoolMemory &&
+            result != vk::Result::eErrorFragmentedPool) {
+            logErrorMsg("failed to allocate a descriptor set: " + vk::to_string(result));
+        }
+        if (added) {
+            logErrorMsg("a descriptor set has more descriptors than the allocator was told of");
+        }
+        list.current++;
+    }
+}
+
+DescriptorAllocator::TemplateHandle
+DescriptorAllocator::createTemplate(vk::DescriptorSetLayout                            layout,
+                                    std::span<const vk::DescriptorUpdateTemplateEntry> entries) {
+    Template templ{};
+    templ.entries.assign(entries.begin(), entries.end());
+    for (const auto& entry : entries) {
+        templ.descriptorCount += entry.descriptorCount;
+    }
+
+    if (hasTemplates()) {
+        vk::DescriptorUpdateTemplateCreateInfo templateInfo{};
+        templateInfo.setDescriptorUpdateEntries(templ.entries)
+            .setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet)
+            .setDescriptorSetLayout(layout);
+
+        VkDescriptorUpdateTemplate handle = VK_NULL_HANDLE;
+        auto                       result = createUpdateTemplate(
+            device,
+            reinterpret_cast<const VkDescriptorUpdateTemplateCreateInfo*>(&templateInfo),
+            nullptr,
+            &handle);
+        if (result != VK_SUCCESS) {
+            logErrorMsg("failed to create a descriptor update template!");
+        }
+        templ.handle = handle;
+    }
+
+    templates.push_back(std::move(templ));
+    return static_cast<TemplateHandle>(templates.size() - 1);
+}
+
+void DescriptorAllocator::update(vk::DescriptorSet set,
+                                 TemplateHandle    handle,
+                                 const void*       data) const {
+    const auto& templ = templates[handle];
+    if (templ.handle) {
+        updateWithTemplate(device, set, templ.handle, data);
+        return;
+    }
+
+    // the infos are copied out of data, their stride is the one of the caller, and reserved so
+    // that the writes can point into them
+    const auto*                           bytes = static_cast<const std::byte*>(data);
+    std::vector<vk::DescriptorBufferInfo> bufferInfos{};
+    std::vector<vk::DescriptorImageInfo>  imageInfos{};
+    std::vector<vk::BufferView>           texelViews{};
+    std::vector<vk::WriteDescriptorSet>   desWrites{};
+    bufferInfos.reserve(templ.descriptorCount);
+    imageInfos.reserve(templ.descriptorCount);
+    texelViews.reserve(templ.descriptorCount);
+    desWrites.reserve(templ.entries.size());
+
+    for (const auto& entry : templ.entries) {
+        auto& desWrite = desWrites.emplace_back();
+        desWrite.setDstSet(set)
+            .setDstBinding(entry.dstBinding)
+            .setDstArrayElement(entry.dstArrayElement)
+            .setDescriptorType(entry.descriptorType)
+            .setDescriptorCount(entry.descriptorCount);
+
+        auto copyOut = [&](auto& infos) {
+            for (uint32_t i = 0; i < entry.descriptorCount; i++) {
+                auto& info = infos.emplace_back();
+                std::memcpy(&info, bytes + entry.offset + i * entry.stride, sizeof(info));
+            }
+            return &infos[infos.size() - entry.descriptorCount];
+        };
+        if (isImageDescriptor(entry.descriptorType)) {
+            desWrite.setPImageInfo(copyOut(imageInfos));
+        } else if (isTexelDescriptor(entry.descriptorType)) {
+            desWrite.setPTexelBufferView(copyOut(texelViews));
+        } else {
+            desWrite.setPBufferInfo(copyOut(bufferInfos));
+        }
+    }
+    device.updateDescriptorSets(desWrites, nullptr);
+}
+
+} // namespace TBE::Graphics
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace TBE::Graphics {
+
+/**
+ * @brief Descriptor sets from lists of pools that grow instead of running out, one list for sets
+ * that live until destroy(), one for the bindless sets that do as well and one per frame in flight
+ * for sets that only live for a frame.
+ *
+ * @details Every list has a profile of its own, a pool has room for a number of sets with at most
+ * the descriptors of every type the profile gives for one set, so the texture tables only take
+ * sampled images out of the pools of the bindless list. When allocating from the last pool of a
+ * list runs into eErrorOutOfPoolMemory or eErrorFragmentedPool a pool with room for twice as many
+ * sets is added.
+ * beginFrame() resets every pool of the frame at once, after the fence of that frame has
+ * signalled, and allocateTransient() starts over from its first pool, so once the pools of a frame
+ * have grown to what it needs allocating a set creates nothing. Sets are never freed one by one.
+ * Templates write every descriptor of a set from one struct of the caller, with a descriptor
+ * update template when the device has VK_KHR_descriptor_update_template and with the same entries
+ * turned into vkUpdateDescriptorSets writes otherwise.
+ */
+class DescriptorAllocator final : public VulkanAbstractBase {
+    using super = VulkanAbstractBase;
+
+public:
+    using TemplateHandle = uint32_t;
+
+    DescriptorAllocator() : super() {}
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&)            = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    // setSizes are the most descriptors of each type a single set of the list has, poolSets the
+    // sets its first pool has room for and flags those of its pools, eUpdateAfterBind for layouts
+    // that need it
+    struct PoolProfile {
+        std::vector<vk::DescriptorPoolSize> setSizes{};
+        uint32_t                            poolSets{};
+        vk::DescriptorPoolCreateFlags       flags{};
+    };
+
+    void init(uint32_t           frameCount,
+              const PoolProfile& persistentProfile,
+              const PoolProfile& bindlessProfile,
+              const PoolProfile& transientProfile);
+    void destroy() override;
+
+    // the device extensions the allocator uses when the device has them
+    static std::vector<const char*> getOptionalExtensions(const vk::PhysicalDevice& phyDevice);
+
+public:
+    vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+    vk::DescriptorSet allocateBindless(vk::DescriptorSetLayout layout);
+
+    // start recording frame, after its fence has signalled, its transient sets are gone then
+    void              beginFrame(uint32_t frame);
+    vk::DescriptorSet allocateTransient(vk::DescriptorSetLayout layout);
+
+    // entries give the offset and the stride of their infos in the data passed to update(), a
+    // vk::DescriptorBufferInfo, vk::DescriptorImageInfo or vk::BufferView per descriptor
+    TemplateHandle createTemplate(vk::DescriptorSetLayout                            layout,
+                                  std::span<const vk::DescriptorUpdateTemplateEntry> entries);
+    // the set must not be in use by the GPU
+    void           update(vk::DescriptorSet set, TemplateHandle handle, const void* data) const;
+
+    bool     hasTemplates() const { return createUpdateTemplate != nullptr; }
+    uint32_t getPoolCount() const;
+
+private:
+    struct PoolList {
+        std::vector<vk::DescriptorPool> pools{};
+        size_t                          current{}; // the pool sets are allocated from
+        PoolProfile                     profile{};
+    };
+
+    struct Template {
+        vk::DescriptorUpdateTemplate                  handle{}; // null without the extension
+        std::vector<vk::DescriptorUpdateTemplateEntry> entries{};
+        uint32_t                                       descriptorCount{};
+    };
+
+    vk::DescriptorSet allocateFrom(PoolList& list, vk::DescriptorSetLayout layout);
+
+private:
+    PoolList              persistent{};
+    PoolList              bindless{};
+    std::vector<PoolList> frames{};
+    uint32_t              currentFrame{};
+    std::vector<Template> templates{};
+
+    PFN_vkCreateDescriptorUpdateTemplateKHR  createUpdateTemplate  = nullptr;
+    PFN_vkDestroyDescriptorUpdateTemplateKHR destroyUpdateTemplate = nullptr;
+    PFN_vkUpdateDescriptorSetWithTemplateKHR updateWithTemplate    = nullptr;
+};
+
+} // namespace TBE::Graphics
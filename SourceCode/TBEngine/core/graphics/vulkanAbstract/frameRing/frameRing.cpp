@@ -0,0 +1,88 @@
+#include "frameRing.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+
+FrameRing::~FrameRing() {
+    destroy();
+}
+
+void FrameRing::init(uint32_t frameCount, vk::DeviceSize size_) {
+    size = size_;
+
+    const auto& limits = phyDevice.getProperties().limits;
+    minAlignment       = std::max<vk::DeviceSize>(
+        {1, limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment});
+
+    frames.resize(frameCount);
+    for (auto& frame : frames) {
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.setSize(size)
+            .setUsage(vk::BufferUsageFlagBits::eUniformBuffer |
+                      vk::BufferUsageFlagBits::eStorageBuffer |
+                      vk::BufferUsageFlagBits::eIndirectBuffer)
+            .setSharingMode(vk::SharingMode::eExclusive);
+        depackReturnValue(frame.buffer, device.createBuffer(bufferInfo));
+
+        frame.allocation = MemoryAllocator::get().allocate(
+            frame.buffer,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
+}
+
+// the handles are checked, the device may already be gone when a static owner is destructed
+void FrameRing::destroy() {
+    for (auto& frame : frames) {
+        if (frame.buffer) {
+            device.destroy(frame.buffer);
+            frame.buffer = nullptr;
+        }
+        MemoryAllocator::get().free(frame.allocation);
+    }
+    frames.clear();
+    head = 0;
+}
+
+void FrameRing::begin(uint32_t frame) {
+    current = frame;
+    head    = 0;
+}
+
+std::vector<vk::Buffer> FrameRing::getBuffers() const {
+    std::vector<vk::Buffer> buffers{};
+    for (const auto& frame : frames) {
+        buffers.push_back(frame.buffer);
+    }
+    return buffers;
+}
+
+FrameAllocation FrameRing::allocate(vk::DeviceSize allocSize, vk::DeviceSize alignment) {
+    alignment            = std::max(alignment, minAlignment);
+    vk::DeviceSize start = (head + alignment - 1) & ~(alignment - 1);
+    return take(start, allocSize);
+}
+
+FrameAllocation FrameRing::allocateArray(uint32_t count, vk::DeviceSize stride) {
+    vk::DeviceSize start = (head + stride - 1) / stride * stride;
+    return take(start, count * stride);
+}
+
+FrameAllocation FrameRing::take(vk::DeviceSize start, vk::DeviceSize allocSize) {
+    if (start + allocSize > size) {
+        Utils::Log::logErrorMsg("frame ring cannot hold another " + std::to_string(allocSize) +
+                                " bytes, raise FRAME_RING_SIZE");
+    }
+    head = start + allocSize;
+
+    auto& frame = frames[current];
+    return {static_cast<std::byte*>(frame.allocation.mapped) + start,
+            frame.buffer,
+            static_cast<uint32_t>(start)};
+}
+
+} // namespace TBE::Graphics
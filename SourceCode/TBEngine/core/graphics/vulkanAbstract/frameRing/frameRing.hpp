@@ -0,0 +1,75 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// a range of the buffer of the current frame, written by the CPU while the frame is recorded
+struct FrameAllocation {
+    void*      data = nullptr;
+    vk::Buffer buffer{};
+    uint32_t   offset{}; // dynamic offsets are 32 bit
+};
+
+/**
+ * @brief A mapped buffer per frame in flight, bump allocated while the frame is recorded.
+ *
+ * @details begin() hands the whole buffer of a frame back, it has to be called after the fence of
+ * that frame has been waited for, the GPU is done reading it then. Every allocation is aligned to
+ * the offset alignments of uniform and storage buffers, so any of them can be bound with a dynamic
+ * offset, per draw data then needs no descriptor update. The buffers are uniform and storage
+ * buffers at once, a frame may also bind its whole buffer and index into it. Indirect draws may
+ * read their commands from it too.
+ * Running out of room in a frame is an error, FRAME_RING_SIZE sets the size of each buffer.
+ */
+class FrameRing final : public VulkanAbstractBase {
+    using super = VulkanAbstractBase;
+
+public:
+    FrameRing() : super() {}
+    ~FrameRing();
+
+    FrameRing(const FrameRing&)            = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    void init(uint32_t frameCount, vk::DeviceSize size);
+    void destroy() override;
+
+public:
+    // start recording frame, after its fence has signalled
+    void            begin(uint32_t frame);
+    // alignment is a power of two, raised to the device minimum
+    FrameAllocation allocate(vk::DeviceSize size, vk::DeviceSize alignment = 0);
+    // count elements of any stride, the offset is a multiple of stride, so offset / stride indexes
+    // the first of them in the whole buffer
+    FrameAllocation allocateArray(uint32_t count, vk::DeviceSize stride);
+
+    uint32_t                getFrame() const { return current; }
+    uint32_t                getFrameCount() const { return static_cast<uint32_t>(frames.size()); }
+    const vk::Buffer&       getBuffer(uint32_t frame) const { return frames[frame].buffer; }
+    std::vector<vk::Buffer> getBuffers() const;
+    vk::DeviceSize          getSize() const { return size; }
+
+private:
+    struct FrameBuffer {
+        vk::Buffer       buffer{};
+        MemoryAllocation allocation{};
+    };
+
+private:
+    FrameAllocation take(vk::DeviceSize start, vk::DeviceSize allocSize);
+
+private:
+    std::vector<FrameBuffer> frames{};
+    vk::DeviceSize           size{};
+    vk::DeviceSize           minAlignment{1};
+    vk::DeviceSize           head{};
+    uint32_t                 current{};
+};
+
+} // namespace TBE::Graphics
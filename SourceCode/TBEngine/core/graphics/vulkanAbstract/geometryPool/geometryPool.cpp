@@ -0,0 +1,460 @@
+#include "geometryPool.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/core/graphics/graphics.hpp"
+#include "TBEngine/settings.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+using Math::DataFormat::Meshlet;
+using Math::DataFormat::VertexLayout;
+
+GeometryPool::~GeometryPool() {
+    destroy();
+}
+
+void GeometryPool::destroy() {
+    for (auto& pool : pools) {
+        destroyPool(pool);
+    }
+    if (meshletBuffer) {
+        device.destroy(meshletBuffer);
+        meshletBuffer = nullptr;
+    }
+    MemoryAllocator::get().free(meshletAllocation);
+    meshletRanges.reset();
+    meshes.clear();
+    freeHandles.clear();
+    pendingRemoves.clear();
+}
+
+GeometryPool::MeshHandle GeometryPool::add(const std::span<std::byte>        vertices,
+                                           const std::span<std::byte>        indices,
+                                           const std::span<std::byte>        meshlets,
+                                           const Math::DataFormat::MeshDesc& meshDesc,
+                                           UploadBatch&                      batch) {
+    auto     poolIdx      = getPoolIndex(meshDesc.vertexLayout, meshDesc.idxStride);
+    auto     stride       = Math::DataFormat::getVertexStride(meshDesc.vertexLayout);
+    uint64_t vertexCount  = vertices.size() / stride;
+    uint64_t indexCount   = meshDesc.idxCount;
+    uint64_t meshletCount = meshlets.size() / sizeof(Meshlet);
+    if (vertexCount == 0 || indexCount == 0 || indices.size() != indexCount * meshDesc.idxStride) {
+        Utils::Log::logErrorMsg("mesh data does not match its description");
+    }
+
+    if (!pools[poolIdx].vertBuffer) {
+        pools[poolIdx] = createPool(poolIdx,
+                                    std::max<uint64_t>(GEOMETRY_POOL_VERTICES, vertexCount * 2),
+                                    std::max<uint64_t>(GEOMETRY_POOL_INDICES, indexCount * 2));
+    }
+
+    auto* pool = &pools[poolIdx];
+    auto  vert = pool->vertRanges->allocate(vertexCount, 1);
+    auto  idx  = pool->idxRanges->allocate(indexCount, 1);
+    if (!vert || !idx) {
+        if (vert) {
+            pool->vertRanges->free(vert->node);
+        }
+        if (idx) {
+            pool->idxRanges->free(idx->node);
+        }
+        waitIdle();
+
+        // after the rebuild the free room is one range at the end, at least half of the pool
+        auto fit = [](const Tlsf& ranges, uint64_t extra) {
+            uint64_t live     = ranges.getSize() - ranges.getFreeBytes();
+            uint64_t capacity = ranges.getSize();
+            while ((live + extra) * 2 > capacity) {
+                capacity *= 2;
+            }
+            return capacity;
+        };
+        rebuild(poolIdx, fit(*pool->vertRanges, vertexCount), fit(*pool->idxRanges, indexCount));
+
+        pool = &pools[poolIdx];
+        vert = pool->vertRanges->allocate(vertexCount, 1);
+        idx  = pool->idxRanges->allocate(indexCount, 1);
+        if (!vert || !idx) {
+            Utils::Log::logErrorMsg("geometry pool has no room for the mesh after growing");
+        }
+    }
+
+    // the culling pass binds the meshlet buffer whether or not any mesh has meshlets
+    if (!meshletBuffer) {
+        rebuildMeshlets(std::max<uint64_t>(GEOMETRY_POOL_MESHLETS, meshletCount * 2));
+    }
+    std::optional<Tlsf::Range> meshletRange{};
+    if (meshletCount > 0) {
+        meshletRange = meshletRanges->allocate(meshletCount, 1);
+        if (!meshletRange) {
+            waitIdle();
+            uint64_t live     = meshletRanges->getSize() - meshletRanges->getFreeBytes();
+            uint64_t capacity = meshletRanges->getSize();
+            while ((live + meshletCount) * 2 > capacity) {
+                capacity *= 2;
+            }
+            rebuildMeshlets(capacity);
+            meshletRange = meshletRanges->allocate(meshletCount, 1);
+            if (!meshletRange) {
+                Utils::Log::logErrorMsg("geometry pool has no room for the meshlets after growing");
+            }
+        }
+    }
+
+    MeshHandle handle = static_cast<MeshHandle>(meshes.size());
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        meshes.emplace_back();
+    }
+    auto& mesh = meshes[handle];
+    mesh.pool  = poolIdx;
+    mesh.range = {.firstIndex   = static_cast<uint32_t>(idx->offset),
+                  .vertexOffset = static_cast<int32_t>(vert->offset),
+                  .indexCount   = static_cast<uint32_t>(indexCount),
+                  .vertexCount  = static_cast<uint32_t>(vertexCount),
+                  .firstMeshlet = meshletRange ? static_cast<uint32_t>(meshletRange->offset) : 0,
+                  .meshletCount = static_cast<uint32_t>(meshletCount)};
+    mesh.vertNode    = vert->node;
+    mesh.idxNode     = idx->node;
+    mesh.meshletNode = meshletRange ? meshletRange->node : Tlsf::nullNode;
+
+    // the buffers are shared by both families, the barrier closing the batch is all they need,
+    // each copy is recorded right after its stage(), a later stage() may flush the batch and
+    // retire the staging buffer of an earlier one
+    auto           vertStaging = batch.stage(vertices);
+    vk::BufferCopy vertCopy{};
+    vertCopy.setSrcOffset(vertStaging.offset)
+        .setDstOffset(vert->offset * stride)
+        .setSize(vertices.size());
+    batch.getCmdBuffer().copyBuffer(vertStaging.buffer, pool->vertBuffer, vertCopy);
+
+    auto           idxStaging = batch.stage(indices);
+    vk::BufferCopy idxCopy{};
+    idxCopy.setSrcOffset(idxStaging.offset)
+        .setDstOffset(idx->offset * meshDesc.idxStride)
+        .setSize(indices.size());
+    batch.getCmdBuffer().copyBuffer(idxStaging.buffer, pool->idxBuffer, idxCopy);
+
+    if (meshletRange) {
+        auto           meshletStaging = batch.stage(meshlets);
+        vk::BufferCopy meshletCopy{};
+        meshletCopy.setSrcOffset(meshletStaging.offset)
+            .setDstOffset(meshletRange->offset * sizeof(Meshlet))
+            .setSize(meshlets.size());
+        batch.getCmdBuffer().copyBuffer(meshletStaging.buffer, meshletBuffer, meshletCopy);
+    }
+    return handle;
+}
+
+void GeometryPool::remove(MeshHandle mesh) {
+    if (mesh >= meshes.size() || meshes[mesh].pool == UINT32_MAX) {
+        Utils::Log::logErrorMsg("geometry pool has no mesh " + std::to_string(mesh));
+    }
+    pendingRemoves.push_back({mesh, frame});
+}
+
+// a frame recorded at frame - MAX_FRAMES_IN_FLIGHT shared its fence with this one
+void GeometryPool::tick() {
+    frame++;
+    if (frame >= MAX_FRAMES_IN_FLIGHT) {
+        releasePending(frame - MAX_FRAMES_IN_FLIGHT);
+    }
+}
+
+void GeometryPool::compact() {
+    auto fragmented = [](const std::optional<Tlsf>& ranges) {
+        return ranges && ranges->getLargestFreeRange() != ranges->getFreeBytes();
+    };
+    bool waited = false;
+    for (uint32_t i = 0; i < pools.size(); i++) {
+        if (!fragmented(pools[i].vertRanges) && !fragmented(pools[i].idxRanges)) {
+            continue;
+        }
+        if (!waited) {
+            waitIdle();
+            waited = true;
+        }
+        rebuild(i, pools[i].vertRanges->getSize(), pools[i].idxRanges->getSize());
+    }
+}
+
+void GeometryPool::report() {
+    for (uint32_t i = 0; i < pools.size(); i++) {
+        const auto& pool = pools[i];
+        if (!pool.vertBuffer) {
+            continue;
+        }
+        auto meshCount = std::count_if(
+            meshes.begin(), meshes.end(), [i](const Mesh& mesh) { return mesh.pool == i; });
+        const auto& vert = *pool.vertRanges;
+        const auto& idx  = *pool.idxRanges;
+        logger->info(
+            "geometry pool " + std::to_string(i) + ": " + std::to_string(meshCount) + " meshes, " +
+            std::to_string(vert.getSize() - vert.getFreeBytes()) + " of " +
+            std::to_string(vert.getSize()) + " vertices, " +
+            std::to_string(idx.getSize() - idx.getFreeBytes()) + " of " +
+            std::to_string(idx.getSize()) + " indices, " +
+            std::to_string(vert.getFreeBytes() - vert.getLargestFreeRange()) +
+            " free vertices outside the largest range");
+    }
+    if (meshletRanges) {
+        logger->info("geometry meshlets: " +
+                     std::to_string(meshletRanges->getSize() - meshletRanges->getFreeBytes()) +
+                     " of " + std::to_string(meshletRanges->getSize()));
+    }
+}
+
+uint32_t GeometryPool::getPoolIndex(VertexLayout layout, uint32_t idxStride) {
+    return static_cast<uint32_t>(layout) * 2 + (idxStride == sizeof(uint32_t) ? 1 : 0);
+}
+
+vk::IndexType GeometryPool::getIdxType(uint32_t pool) const {
+    return getIdxStride(pool) == sizeof(uint32_t) ? vk::IndexType::eUint32
+                                                  : vk::IndexType::eUint16;
+}
+
+VertexLayout GeometryPool::getVertexLayout(uint32_t pool) {
+    return static_cast<VertexLayout>(pool / 2);
+}
+
+uint32_t GeometryPool::getIdxStride(uint32_t pool) {
+    return pool % 2 ? sizeof(uint32_t) : sizeof(uint16_t);
+}
+
+void GeometryPool::createBuffer(vk::DeviceSize       size,
+                                vk::BufferUsageFlags usage,
+                                vk::Buffer&          buffer,
+                                MemoryAllocation&    allocation) const {
+    auto families = VulkanGraphics::uploadContext.getQueueFamilies();
+
+    vk::BufferCreateInfo bufferInfo{};
+    bufferInfo.setSize(size).setUsage(usage | vk::BufferUsageFlagBits::eTransferSrc |
+                                      vk::BufferUsageFlagBits::eTransferDst);
+    if (families.size() > 1) {
+        bufferInfo.setSharingMode(vk::SharingMode::eConcurrent).setQueueFamilyIndices(families);
+    } else {
+        bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
+    }
+    depackReturnValue(buffer, device.createBuffer(bufferInfo));
+    allocation = MemoryAllocator::get().allocate(buffer, vk::MemoryPropertyFlagBits::eDeviceLocal);
+}
+
+GeometryPool::Pool GeometryPool::createPool(uint32_t pool,
+                                            uint64_t vertexCapacity,
+                                            uint64_t indexCapacity) const {
+    Pool created{};
+    createBuffer(vertexCapacity * Math::DataFormat::getVertexStride(getVertexLayout(pool)),
+                 vk::BufferUsageFlagBits::eVertexBuffer,
+                 created.vertBuffer,
+                 created.vertAllocation);
+    createBuffer(indexCapacity * getIdxStride(pool),
+                 vk::BufferUsageFlagBits::eIndexBuffer,
+                 created.idxBuffer,
+                 created.idxAllocation);
+    created.vertRanges.emplace(vertexCapacity);
+    created.idxRanges.emplace(indexCapacity);
+    return created;
+}
+
+void GeometryPool::destroyPool(Pool& pool) {
+    if (pool.vertBuffer) {
+        device.destroy(pool.vertBuffer);
+    }
+    if (pool.idxBuffer) {
+        device.destroy(pool.idxBuffer);
+    }
+    MemoryAllocator::get().free(pool.vertAllocation);
+    MemoryAllocator::get().free(pool.idxAllocation);
+    pool = {};
+}
+
+// the device has to be idle, see waitIdle()
+void GeometryPool::rebuild(uint32_t poolIdx, uint64_t vertexCapacity, uint64_t indexCapacity) {
+    auto& pool      = pools[poolIdx];
+    auto  stride    = Math::DataFormat::getVertexStride(getVertexLayout(poolIdx));
+    auto  idxStride = getIdxStride(poolIdx);
+
+    // place the meshes first, the size classes round requests up so a pool that is nearly full
+    // may need more room than it holds
+    std::vector<MeshHandle>  moved{};
+    std::vector<Tlsf::Range> vertPlaces{}, idxPlaces{};
+    std::optional<Tlsf>      vertRanges{}, idxRanges{};
+    while (true) {
+        vertRanges.emplace(vertexCapacity);
+        idxRanges.emplace(indexCapacity);
+        moved.clear();
+        vertPlaces.clear();
+        idxPlaces.clear();
+
+        bool fits = true;
+        for (MeshHandle handle = 0; handle < meshes.size() && fits; handle++) {
+            const auto& mesh = meshes[handle];
+            if (mesh.pool != poolIdx) {
+                continue;
+            }
+            auto vert = vertRanges->allocate(mesh.range.vertexCount, 1);
+            auto idx  = idxRanges->allocate(mesh.range.indexCount, 1);
+            fits      = vert && idx;
+            if (fits) {
+                moved.push_back(handle);
+                vertPlaces.push_back(*vert);
+                idxPlaces.push_back(*idx);
+            }
+        }
+        if (fits) {
+            break;
+        }
+        vertexCapacity *= 2;
+        indexCapacity *= 2;
+    }
+
+    auto rebuilt       = createPool(poolIdx, vertexCapacity, indexCapacity);
+    rebuilt.vertRanges = std::move(vertRanges);
+    rebuilt.idxRanges  = std::move(idxRanges);
+
+    std::vector<vk::BufferCopy> vertCopies{}, idxCopies{};
+    for (size_t i = 0; i < moved.size(); i++) {
+        auto& mesh  = meshes[moved[i]];
+        auto& range = mesh.range;
+
+        vertCopies.emplace_back(static_cast<vk::DeviceSize>(range.vertexOffset) * stride,
+                                vertPlaces[i].offset * stride,
+                                static_cast<vk::DeviceSize>(range.vertexCount) * stride);
+        idxCopies.emplace_back(static_cast<vk::DeviceSize>(range.firstIndex) * idxStride,
+                               idxPlaces[i].offset * idxStride,
+                               static_cast<vk::DeviceSize>(range.indexCount) * idxStride);
+
+        range.vertexOffset = static_cast<int32_t>(vertPlaces[i].offset);
+        range.firstIndex   = static_cast<uint32_t>(idxPlaces[i].offset);
+        mesh.vertNode      = vertPlaces[i].node;
+        mesh.idxNode       = idxPlaces[i].node;
+    }
+
+    if (!moved.empty()) {
+        disposableCommands([&](vk::CommandBuffer& cmdBuffer) {
+            cmdBuffer.copyBuffer(pool.vertBuffer, rebuilt.vertBuffer, vertCopies);
+            cmdBuffer.copyBuffer(pool.idxBuffer, rebuilt.idxBuffer, idxCopies);
+
+            vk::MemoryBarrier barrier{};
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead |
+                                  vk::AccessFlagBits::eIndexRead);
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                      vk::PipelineStageFlagBits::eVertexInput,
+                                      {},
+                                      barrier,
+                                      {},
+                                      {});
+        });
+    }
+
+    logger->info("geometry pool " + std::to_string(poolIdx) + " rebuilt for " +
+                 std::to_string(vertexCapacity) + " vertices and " +
+                 std::to_string(indexCapacity) + " indices");
+    destroyPool(pool);
+    pool = std::move(rebuilt);
+}
+
+void GeometryPool::rebuildMeshlets(uint64_t capacity) {
+    std::vector<MeshHandle>  moved{};
+    std::vector<Tlsf::Range> places{};
+    std::optional<Tlsf>      ranges{};
+    while (true) {
+        ranges.emplace(capacity);
+        moved.clear();
+        places.clear();
+
+        bool fits = true;
+        for (MeshHandle handle = 0; handle < meshes.size() && fits; handle++) {
+            const auto& mesh = meshes[handle];
+            if (mesh.meshletNode == Tlsf::nullNode) {
+                continue;
+            }
+            auto place = ranges->allocate(mesh.range.meshletCount, 1);
+            fits       = place.has_value();
+            if (fits) {
+                moved.push_back(handle);
+                places.push_back(*place);
+            }
+        }
+        if (fits) {
+            break;
+        }
+        capacity *= 2;
+    }
+
+    vk::Buffer       buffer{};
+    MemoryAllocation allocation{};
+    createBuffer(
+        capacity * sizeof(Meshlet), vk::BufferUsageFlagBits::eStorageBuffer, buffer, allocation);
+
+    std::vector<vk::BufferCopy> copies{};
+    for (size_t i = 0; i < moved.size(); i++) {
+        auto& mesh = meshes[moved[i]];
+        copies.emplace_back(static_cast<vk::DeviceSize>(mesh.range.firstMeshlet) * sizeof(Meshlet),
+                            places[i].offset * sizeof(Meshlet),
+                            static_cast<vk::DeviceSize>(mesh.range.meshletCount) * sizeof(Meshlet));
+        mesh.range.firstMeshlet = static_cast<uint32_t>(places[i].offset);
+        mesh.meshletNode        = places[i].node;
+    }
+
+    if (!copies.empty()) {
+        disposableCommands([&](vk::CommandBuffer& cmdBuffer) {
+            cmdBuffer.copyBuffer(meshletBuffer, buffer, copies);
+
+            vk::MemoryBarrier barrier{};
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                      vk::PipelineStageFlagBits::eComputeShader,
+                                      {},
+                                      barrier,
+                                      {},
+                                      {});
+        });
+    }
+
+    logger->info("geometry meshlet buffer rebuilt for " + std::to_string(capacity) + " meshlets");
+    if (meshletBuffer) {
+        device.destroy(meshletBuffer);
+    }
+    MemoryAllocator::get().free(meshletAllocation);
+    meshletBuffer     = buffer;
+    meshletAllocation = allocation;
+    meshletRanges     = std::move(ranges);
+}
+
+// the open upload batch may still copy into the buffers and frames may still draw from them
+void GeometryPool::waitIdle() {
+    auto& context = VulkanGraphics::uploadContext;
+    context.wait(context.getTicket());
+    while (device.waitIdle() == vk::Result::eTimeout) {
+        logger->warn("device waitIdle in GeometryPool: timeout.");
+    }
+    releasePending(frame);
+}
+
+void GeometryPool::release(MeshHandle handle) {
+    auto& mesh = meshes[handle];
+    auto& pool = pools[mesh.pool];
+    pool.vertRanges->free(mesh.vertNode);
+    pool.idxRanges->free(mesh.idxNode);
+    if (mesh.meshletNode != Tlsf::nullNode) {
+        meshletRanges->free(mesh.meshletNode);
+    }
+    mesh = {};
+    freeHandles.push_back(handle);
+}
+
+void GeometryPool::releasePending(uint64_t lastDoneFrame) {
+    while (!pendingRemoves.empty() && pendingRemoves.front().frame <= lastDoneFrame) {
+        release(pendingRemoves.front().mesh);
+        pendingRemoves.pop_front();
+    }
+}
+
+} // namespace TBE::Graphics
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/tlsf.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/uploadBatch/uploadBatch.hpp"
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// where a mesh lives in the buffers of its pool, the arguments of its drawIndexed
+struct GeometryRange {
+    uint32_t firstIndex{};
+    int32_t  vertexOffset{};
+    uint32_t indexCount{};
+    uint32_t vertexCount{};
+    uint32_t firstMeshlet{}; // in the meshlet buffer
+    uint32_t meshletCount{};
+};
+
+/**
+ * @brief Every mesh in a handful of device local vertex and index buffers.
+ *
+ * @details Meshes with the same vertex layout and index size share a pool, one vertex and one
+ * index buffer, so drawing all of them binds both once and passes the range of each mesh to
+ * drawIndexed. Ranges are counted in vertices and indices and handed out by a TLSF allocator. The
+ * ranges of a removed mesh are reused once the frames that may still draw it are done, tick()
+ * keeps count of them.
+ * A pool that has no room left is rebuilt: its meshes are copied to the front of new buffers,
+ * which are twice the size as long as they would be more than half full. compact() does the same
+ * at the current size. Rebuilding waits for the device, it is for the rare occasion, and moves the
+ * meshes, so a mesh is known by its handle and its range is looked up again for every draw.
+ * The meshlets of every pool live in one more storage buffer the culling pass reads, handed out
+ * the same way and grown the same way when it runs full.
+ * The buffers are shared by the upload and the graphics queue family, the copies into them need
+ * no ownership transfer.
+ */
+class GeometryPool final : public VulkanAbstractBase {
+    using super = VulkanAbstractBase;
+
+public:
+    using MeshHandle                     = uint32_t;
+    static constexpr MeshHandle nullMesh = UINT32_MAX;
+
+public:
+    GeometryPool() : super() {}
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool&)            = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    void destroy() override;
+
+public:
+    // stage the mesh and record its copies into batch, it may be drawn once batch is done
+    // meshlets holds Math::DataFormat::Meshlet and may be empty
+    [[nodiscard]] MeshHandle add(const std::span<std::byte>        vertices,
+                                 const std::span<std::byte>        indices,
+                                 const std::span<std::byte>        meshlets,
+                                 const Math::DataFormat::MeshDesc& meshDesc,
+                                 UploadBatch&                      batch);
+    // frames recorded from now on may not draw the mesh anymore
+    void                     remove(MeshHandle mesh);
+
+    // once per frame, after the fence of the frame about to be recorded has been waited for
+    void tick();
+    // move the meshes of every fragmented pool to the front of its buffers
+    void compact();
+
+    // log the meshes and the room used in every pool
+    void report();
+
+public:
+    static uint32_t getPoolIndex(Math::DataFormat::VertexLayout layout, uint32_t idxStride);
+    static uint32_t getPoolCount() { return Math::DataFormat::vertexLayoutCount * 2; }
+
+    // the pipeline a pool is drawn with is indexed by its vertex layout
+    static Math::DataFormat::VertexLayout getVertexLayout(uint32_t pool);
+
+    // null buffers for a pool nothing has been added to
+    const vk::Buffer&    getVertBuffer(uint32_t pool) const { return pools[pool].vertBuffer; }
+    const vk::Buffer&    getIdxBuffer(uint32_t pool) const { return pools[pool].idxBuffer; }
+    vk::IndexType        getIdxType(uint32_t pool) const;
+    uint32_t             getPool(MeshHandle mesh) const { return meshes[mesh].pool; }
+    const GeometryRange& getRange(MeshHandle mesh) const { return meshes[mesh].range; }
+    // created by the first add(), replaced when it grows
+    const vk::Buffer&    getMeshletBuffer() const { return meshletBuffer; }
+
+private:
+    struct Pool {
+        vk::Buffer          vertBuffer{};
+        vk::Buffer          idxBuffer{};
+        MemoryAllocation    vertAllocation{};
+        MemoryAllocation    idxAllocation{};
+        std::optional<Tlsf> vertRanges{};
+        std::optional<Tlsf> idxRanges{};
+    };
+
+    struct Mesh {
+        uint32_t      pool = UINT32_MAX; // UINT32_MAX for an unused handle
+        GeometryRange range{};
+        uint32_t      vertNode    = Tlsf::nullNode;
+        uint32_t      idxNode     = Tlsf::nullNode;
+        uint32_t      meshletNode = Tlsf::nullNode;
+    };
+
+    struct PendingRemove {
+        MeshHandle mesh{};
+        uint64_t   frame{}; // the last frame that may have drawn the mesh
+    };
+
+private:
+    static uint32_t getIdxStride(uint32_t pool);
+
+    void createBuffer(vk::DeviceSize       size,
+                      vk::BufferUsageFlags usage,
+                      vk::Buffer&          buffer,
+                      MemoryAllocation&    allocation) const;
+    Pool createPool(uint32_t pool, uint64_t vertexCapacity, uint64_t indexCapacity) const;
+    void destroyPool(Pool& pool);
+    // copy the meshes of the pool to the front of buffers of the given capacities
+    void rebuild(uint32_t pool, uint64_t vertexCapacity, uint64_t indexCapacity);
+    // the same for the meshlets of every mesh, the device has to be idle unless it is empty
+    void rebuildMeshlets(uint64_t capacity);
+    // wait until nothing uses the buffers, which releases every pending remove as well
+    void waitIdle();
+    void release(MeshHandle mesh);
+    void releasePending(uint64_t lastDoneFrame);
+
+private:
+    std::vector<Pool>         pools = std::vector<Pool>(getPoolCount());
+    vk::Buffer                meshletBuffer{};
+    MemoryAllocation          meshletAllocation{};
+    std::optional<Tlsf>       meshletRanges{};
+    std::vector<Mesh>         meshes{};
+    std::vector<MeshHandle>   freeHandles{};
+    std::deque<PendingRemove> pendingRemoves{};
+    uint64_t                  frame{};
+};
+
+} // namespace TBE::Graphics
@@ -3,22 +3,52 @@
 #include "TBEngine/utils/log/log.hpp"
 #include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
 
+#include <utility>
+
 namespace TBE::Graphics {
 using TBE::Utils::Log::logErrorMsg;
 using namespace TBE::Graphics::Detail;
 
+ImageResource::ImageResource(ImageResource&& other) noexcept
+    : VulkanAbstractBase()
+    , image(std::exchange(other.image, nullptr))
+    , imageView(std::exchange(other.imageView, nullptr))
+    , allocation(std::exchange(other.allocation, {}))
+    , width(std::exchange(other.width, 0))
+    , height(std::exchange(other.height, 0))
+    , format(other.format)
+    , mipLevels(std::exchange(other.mipLevels, 0)) {
+}
+
+ImageResource& ImageResource::operator=(ImageResource&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        image      = std::exchange(other.image, nullptr);
+        imageView  = std::exchange(other.imageView, nullptr);
+        allocation = std::exchange(other.allocation, {});
+        width      = std::exchange(other.width, 0);
+        height     = std::exchange(other.height, 0);
+        format     = other.format;
+        mipLevels  = std::exchange(other.mipLevels, 0);
+    }
+    return *this;
+}
+
 ImageResource::~ImageResource() {
     destroy();
 }
 
+// the handles are checked, the device may already be gone when a static owner is destructed
 void ImageResource::destroy() {
-    static bool destroyed = false;
-    if (!destroyed) {
+    if (imageView) {
         device.destroy(imageView);
+        imageView = nullptr;
+    }
+    if (image) {
         device.destroy(image);
-        device.free(memory);
-        destroyed = true;
+        image = nullptr;
     }
+    MemoryAllocator::get().free(allocation);
 }
 
 void ImageResource::init(ImageResourceType imgType) {
@@ -29,12 +59,10 @@ void ImageResource::init(ImageResourceType imgType) {
     vk::ImageCreateInfo     imgInfo{};
     vk::ImageViewCreateInfo viewInfo{};
 
-    uint32_t mipLevels{1};
-
     switch (imgType) {
         case ImageResourceType::eColor:
             std::tie(imgInfo, viewInfo) =
-                createImageInfos(mipLevels,
+                createImageInfos(1,
                                  getMaxUsableSampleCount(phyDevice),
                                  format,
                                  vk::ImageTiling::eOptimal,
@@ -44,7 +72,7 @@ void ImageResource::init(ImageResourceType imgType) {
             break;
         case ImageResourceType::eDepth:
             std::tie(imgInfo, viewInfo) =
-                createImageInfos(mipLevels,
+                createImageInfos(1,
                                  getMaxUsableSampleCount(phyDevice),
                                  format,
                                  vk::ImageTiling::eOptimal,
@@ -52,10 +80,16 @@ void ImageResource::init(ImageResourceType imgType) {
                                  vk::ImageAspectFlagBits::eDepth);
             break;
         case ImageResourceType::eTexture:
-            mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+            if (mipLevels == 0) {
+                mipLevels =
+                    static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+            }
+            if (!isSampledFormatSupported(format)) {
+                logErrorMsg("texture format " + vk::to_string(format) + " cannot be sampled");
+            }
             std::tie(imgInfo, viewInfo) = createImageInfos(mipLevels,
                                                            vk::SampleCountFlagBits::e1,
-                                                           vk::Format::eR8G8B8A8Srgb,
+                                                           format,
                                                            vk::ImageTiling::eOptimal,
                                                            vk::ImageUsageFlagBits::eTransferDst |
                                                                vk::ImageUsageFlagBits::eSampled,
@@ -67,30 +101,32 @@ void ImageResource::init(ImageResourceType imgType) {
             break;
     }
 
-    init(imgInfo,
-         viewInfo,
-         phyDevice.getMemoryProperties(),
-         vk::MemoryPropertyFlagBits::eDeviceLocal);
+    bool renderTarget =
+        imgType == ImageResourceType::eColor || imgType == ImageResourceType::eDepth;
+    init(imgInfo, viewInfo, vk::MemoryPropertyFlagBits::eDeviceLocal, renderTarget);
 }
 
 void ImageResource::setFormat(vk::Format format_) {
     format = format_;
 }
 
+void ImageResource::setMipLevels(uint32_t mipLevels_) {
+    mipLevels = mipLevels_;
+}
+
+bool ImageResource::isSampledFormatSupported(vk::Format format_) const {
+    auto properties = phyDevice.getFormatProperties(format_);
+    return static_cast<bool>(properties.optimalTilingFeatures &
+                             vk::FormatFeatureFlagBits::eSampledImage);
+}
+
 void ImageResource::setWH(uint32_t width_, uint32_t height_) {
     width  = width_;
     height = height_;
 }
 
-void ImageResource::createBuffer(const vk::PhysicalDeviceMemoryProperties& memPro,
-                                 const vk::MemoryPropertyFlags&            reqPro) {
-    auto                   memReq = device.getImageMemoryRequirements(image);
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.setAllocationSize(memReq.size)
-        .setMemoryTypeIndex(findMemoryType(memPro, memReq.memoryTypeBits, reqPro));
-
-    depackReturnValue(memory, device.allocateMemory(allocInfo));
-    handleVkResult(device.bindImageMemory(image, memory, 0));
+void ImageResource::createBuffer(const vk::MemoryPropertyFlags& reqPro, bool dedicated) {
+    allocation = MemoryAllocator::get().allocate(image, reqPro, dedicated);
 }
 
 void ImageResource::createImageView(vk::ImageViewCreateInfo& viewInfo) {
@@ -102,13 +138,13 @@ void ImageResource::createImage(const vk::ImageCreateInfo& imageInfo) {
     depackReturnValue(image, device.createImage(imageInfo));
 }
 
-void ImageResource::init(const vk::ImageCreateInfo&                imageInfo,
-                         vk::ImageViewCreateInfo&                  viewInfo,
-                         const vk::PhysicalDeviceMemoryProperties& memPro,
-                         const vk::MemoryPropertyFlags&            reqPro) {
+void ImageResource::init(const vk::ImageCreateInfo&     imageInfo,
+                         vk::ImageViewCreateInfo&       viewInfo,
+                         const vk::MemoryPropertyFlags& reqPro,
+                         bool                           dedicated) {
     setWH(imageInfo.extent.width, imageInfo.extent.height);
     createImage(imageInfo);
-    createBuffer(memPro, reqPro);
+    createBuffer(reqPro, dedicated);
     createImageView(viewInfo);
 }
 
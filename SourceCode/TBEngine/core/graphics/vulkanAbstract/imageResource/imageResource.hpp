@@ -2,41 +2,55 @@
 
 #include "TBEngine/utils/includes/includeVulkan.hpp"
 #include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
 #include "TBEngine/enums.hpp"
 
 namespace TBE::Graphics {
 
+// owns its image, view and memory, moving hands them over and leaves the source empty
 class ImageResource : public VulkanAbstractBase {
 public:
     ImageResource() : VulkanAbstractBase() {}
+    ImageResource(ImageResource&& other) noexcept;
+    ImageResource& operator=(ImageResource&& other) noexcept;
     ~ImageResource();
 
+    ImageResource(const ImageResource&)            = delete;
+    ImageResource& operator=(const ImageResource&) = delete;
+
 public:
     void init(ImageResourceType imgType);
 
     void setFormat(vk::Format format_);
     void setWH(uint32_t width_, uint32_t height_);
+    // levels of a texture, 0 for the whole chain down to 1x1
+    void setMipLevels(uint32_t mipLevels_);
     void createImage(const vk::ImageCreateInfo& imageInfo);
-    void createBuffer(const vk::PhysicalDeviceMemoryProperties& memPro,
-                      const vk::MemoryPropertyFlags&            reqPro);
+    // render targets get memory of their own, see MemoryAllocator
+    void createBuffer(const vk::MemoryPropertyFlags& reqPro, bool dedicated);
     void createImageView(vk::ImageViewCreateInfo& viewInfo);
 
     void destroy() override;
 
+    // whether a texture in format can be sampled with optimal tiling, BC formats need the
+    // textureCompressionBC feature
+    bool isSampledFormatSupported(vk::Format format_) const;
+
 public:
-    void init(const vk::ImageCreateInfo&                imageInfo,
-              vk::ImageViewCreateInfo&                  viewInfo,
-              const vk::PhysicalDeviceMemoryProperties& memPro,
-              const vk::MemoryPropertyFlags&            reqPro);
+    void init(const vk::ImageCreateInfo&     imageInfo,
+              vk::ImageViewCreateInfo&       viewInfo,
+              const vk::MemoryPropertyFlags& reqPro,
+              bool                           dedicated = false);
 
 public:
     vk::Image        image{};
     vk::ImageView    imageView{};
-    vk::DeviceMemory memory{};
+    MemoryAllocation allocation{};
 
     uint32_t   width{0};
     uint32_t   height{0};
     vk::Format format{vk::Format::eR8G8B8A8Srgb};
+    uint32_t   mipLevels{0};
 
 private:
     std::tuple<vk::ImageCreateInfo, vk::ImageViewCreateInfo>
@@ -0,0 +1,272 @@
+#include "memoryAllocator.hpp"
+#include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/settings.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+
+void MemoryAllocator::init() {
+    memProperties          = phyDevice.getMemoryProperties();
+    bufferImageGranularity = phyDevice.getProperties().limits.bufferImageGranularity;
+
+    pools.resize(memProperties.memoryTypeCount * 2);
+    for (uint32_t i = 0; i < pools.size(); i++) {
+        pools[i].memoryType = i / 2;
+    }
+    inited = true;
+}
+
+// linear and optimal resources only need blocks apart if the granularity could put them on a
+// shared page, otherwise both use the linear pool
+uint32_t MemoryAllocator::getPoolIndex(uint32_t memoryType, ResourceTiling tiling) const {
+    bool optimal = tiling == ResourceTiling::eOptimal && bufferImageGranularity > 1;
+    return memoryType * 2 + (optimal ? 1 : 0);
+}
+
+uint32_t MemoryAllocator::getHeapIndex(uint32_t memoryType) const {
+    return memProperties.memoryTypes[memoryType].heapIndex;
+}
+
+MemoryAllocation MemoryAllocator::allocate(const vk::MemoryRequirements& memReq,
+                                           vk::MemoryPropertyFlags       memPro,
+                                           ResourceTiling                tiling,
+                                           bool                          dedicated) {
+    std::lock_guard lock(mutex);
+    if (!inited) {
+        init();
+    }
+
+    uint32_t memoryType = findMemoryType(memProperties, memReq.memoryTypeBits, memPro);
+    if (dedicated || memReq.size > GPU_MEMORY_BLOCK_SIZE / 2) {
+        return allocateDedicated(memReq, memoryType);
+    }
+
+    uint32_t poolIndex = getPoolIndex(memoryType, tiling);
+    auto&    pool      = pools[poolIndex];
+
+    uint32_t                   blockIndex = 0;
+    std::optional<Tlsf::Range> range{};
+    for (; blockIndex < pool.blocks.size(); blockIndex++) {
+        const auto& block = pool.blocks[blockIndex];
+        if (block && (range = block->tlsf.allocate(memReq.size, memReq.alignment))) {
+            break;
+        }
+    }
+    if (!range) {
+        blockIndex = createBlock(pool, memReq.size + memReq.alignment);
+        if (blockIndex == UINT32_MAX) {
+            // the heap has no room for another block, the request may still fit on its own
+            return allocateDedicated(memReq, memoryType);
+        }
+        range = pool.blocks[blockIndex]->tlsf.allocate(memReq.size, memReq.alignment);
+    }
+    const auto& block = pool.blocks[blockIndex];
+
+    MemoryAllocation allocation{};
+    allocation.memory = block->memory;
+    allocation.offset = range->offset;
+    allocation.size   = memReq.size;
+    allocation.mapped = block->mapped ? static_cast<std::byte*>(block->mapped) + range->offset
+                                      : nullptr;
+    allocation.pool   = poolIndex;
+    allocation.block  = blockIndex;
+    allocation.node   = range->node;
+    return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate(vk::Buffer buffer, vk::MemoryPropertyFlags memPro) {
+    auto allocation =
+        allocate(device.getBufferMemoryRequirements(buffer), memPro, ResourceTiling::eLinear);
+    handleVkResult(device.bindBufferMemory(buffer, allocation.memory, allocation.offset));
+    return allocation;
+}
+
+// every image of the engine uses optimal tiling
+MemoryAllocation MemoryAllocator::allocate(vk::Image               image,
+                                           vk::MemoryPropertyFlags memPro,
+                                           bool                    dedicated) {
+    auto allocation = allocate(
+        device.getImageMemoryRequirements(image), memPro, ResourceTiling::eOptimal, dedicated);
+    handleVkResult(device.bindImageMemory(image, allocation.memory, allocation.offset));
+    return allocation;
+}
+
+void MemoryAllocator::free(MemoryAllocation& allocation) {
+    if (!allocation) {
+        return;
+    }
+    std::lock_guard lock(mutex);
+
+    // after destroy() the memory is already gone
+    if (!inited) {
+        allocation = {};
+        return;
+    }
+
+    if (allocation.pool == UINT32_MAX) {
+        auto record = std::find_if(
+            dedicatedAllocations.begin(),
+            dedicatedAllocations.end(),
+            [&allocation](const auto& other) { return other.memory == allocation.memory; });
+        if (record != dedicatedAllocations.end()) {
+            device.free(allocation.memory); // unmaps implicitly
+            dedicatedAllocations.erase(record);
+        }
+        allocation = {};
+        return;
+    }
+
+    auto& pool  = pools[allocation.pool];
+    auto& block = pool.blocks[allocation.block];
+    block->tlsf.free(allocation.node);
+    allocation = {};
+
+    // keep one empty block per pool around, a level load frees and allocates in bursts
+    if (block->tlsf.getAllocationCount() != 0) {
+        return;
+    }
+    bool otherEmpty = std::any_of(pool.blocks.begin(), pool.blocks.end(), [&block](const auto& b) {
+        return b && b != block && b->tlsf.getAllocationCount() == 0;
+    });
+    if (otherEmpty) {
+        device.free(block->memory);
+        block.reset();
+    }
+}
+
+MemoryAllocation MemoryAllocator::allocateDedicated(const vk::MemoryRequirements& memReq,
+                                                    uint32_t                      memoryType) {
+    vk::MemoryAllocateInfo allocInfo{};
+    allocInfo.setAllocationSize(memReq.size).setMemoryTypeIndex(memoryType);
+
+    MemoryAllocation allocation{};
+    depackReturnValueM(allocation.memory,
+                       device.allocateMemory(allocInfo),
+                       "failed to allocate " + std::to_string(memReq.size) + " bytes");
+    allocation.size   = memReq.size;
+    allocation.mapped = mapIfHostVisible(allocation.memory, memoryType);
+
+    dedicatedAllocations.push_back({allocation.memory, memReq.size, getHeapIndex(memoryType)});
+    return allocation;
+}
+
+// a block smaller than the preferred size is tried when the heap runs low, UINT32_MAX if even
+// one holding minSize does not fit
+uint32_t MemoryAllocator::createBlock(MemoryPool& pool, vk::DeviceSize minSize) {
+    auto heapSize  = memProperties.memoryHeaps[getHeapIndex(pool.memoryType)].size;
+    auto blockSize = std::min<vk::DeviceSize>(GPU_MEMORY_BLOCK_SIZE, heapSize / 8);
+    blockSize      = std::max(blockSize, minSize);
+
+    vk::DeviceMemory memory{};
+    while (true) {
+        vk::MemoryAllocateInfo allocInfo{};
+        allocInfo.setAllocationSize(blockSize).setMemoryTypeIndex(pool.memoryType);
+
+        auto [result, value] = device.allocateMemory(allocInfo);
+        if (result == vk::Result::eSuccess) {
+            memory = value;
+            break;
+        }
+        if (blockSize / 2 < minSize) {
+            return UINT32_MAX;
+        }
+        blockSize /= 2;
+    }
+
+    auto block    = std::make_unique<MemoryBlock>(MemoryBlock{memory, nullptr, Tlsf(blockSize)});
+    block->mapped = mapIfHostVisible(memory, pool.memoryType);
+
+    auto slot = std::find(pool.blocks.begin(), pool.blocks.end(), nullptr);
+    if (slot == pool.blocks.end()) {
+        pool.blocks.push_back(std::move(block));
+        return static_cast<uint32_t>(pool.blocks.size() - 1);
+    }
+    *slot = std::move(block);
+    return static_cast<uint32_t>(slot - pool.blocks.begin());
+}
+
+void* MemoryAllocator::mapIfHostVisible(vk::DeviceMemory memory, uint32_t memoryType) {
+    if (!(memProperties.memoryTypes[memoryType].propertyFlags &
+          vk::MemoryPropertyFlagBits::eHostVisible)) {
+        return nullptr;
+    }
+    void* mapped = nullptr;
+    depackReturnValue(mapped, device.mapMemory(memory, 0, vk::WholeSize));
+    return mapped;
+}
+
+std::vector<MemoryHeapStats> MemoryAllocator::getStats() {
+    std::lock_guard lock(mutex);
+
+    std::vector<MemoryHeapStats> stats(memProperties.memoryHeapCount);
+    for (const auto& pool : pools) {
+        auto& heap = stats[getHeapIndex(pool.memoryType)];
+        for (const auto& block : pool.blocks) {
+            if (!block) {
+                continue;
+            }
+            heap.blockBytes += block->tlsf.getSize();
+            heap.usedBytes += block->tlsf.getSize() - block->tlsf.getFreeBytes();
+            heap.freeBytes += block->tlsf.getFreeBytes();
+            heap.largestFreeRange =
+                std::max<vk::DeviceSize>(heap.largestFreeRange, block->tlsf.getLargestFreeRange());
+            heap.blockCount++;
+            heap.allocationCount += block->tlsf.getAllocationCount();
+        }
+    }
+    for (const auto& record : dedicatedAllocations) {
+        auto& heap = stats[record.heap];
+        heap.blockBytes += record.size;
+        heap.usedBytes += record.size;
+        heap.allocationCount++;
+        heap.dedicatedCount++;
+    }
+    return stats;
+}
+
+void MemoryAllocator::report() {
+    auto stats = getStats();
+    for (size_t i = 0; i < stats.size(); i++) {
+        const auto& heap = stats[i];
+        if (heap.blockBytes == 0) {
+            continue;
+        }
+        logger->info("gpu memory heap " + std::to_string(i) + ": " +
+                     std::to_string(heap.usedBytes >> 10) + " KiB used of " +
+                     std::to_string(heap.blockBytes >> 10) + " KiB in " +
+                     std::to_string(heap.blockCount) + " blocks, " +
+                     std::to_string(heap.allocationCount) + " allocations (" +
+                     std::to_string(heap.dedicatedCount) + " dedicated), fragmentation " +
+                     std::to_string(heap.getFragmentation()));
+    }
+}
+
+void MemoryAllocator::destroy() {
+    std::lock_guard lock(mutex);
+
+    uint32_t leaked = static_cast<uint32_t>(dedicatedAllocations.size());
+    for (auto& pool : pools) {
+        for (auto& block : pool.blocks) {
+            if (block) {
+                leaked += block->tlsf.getAllocationCount();
+                device.free(block->memory);
+            }
+        }
+    }
+    for (const auto& record : dedicatedAllocations) {
+        device.free(record.memory);
+    }
+    if (leaked != 0) {
+        logger->warn(std::to_string(leaked) + " gpu memory allocations still alive on destroy");
+    }
+
+    pools.clear();
+    dedicatedAllocations.clear();
+    inited = false;
+}
+
+} // namespace TBE::Graphics
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/tlsf.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// a range of device memory handed out by MemoryAllocator, give it back with free()
+struct MemoryAllocation {
+    vk::DeviceMemory memory{};
+    vk::DeviceSize   offset{};
+    vk::DeviceSize   size{};
+    void*            mapped = nullptr; // offset already applied, null unless host visible
+
+    uint32_t pool  = UINT32_MAX; // UINT32_MAX for a dedicated allocation
+    uint32_t block = UINT32_MAX;
+    uint32_t node  = Tlsf::nullNode;
+
+    explicit operator bool() const { return static_cast<bool>(memory); }
+};
+
+enum class ResourceTiling : uint32_t
+{
+    eLinear = 0, // buffers and linear images
+    eOptimal,    // optimal tiling images
+};
+
+struct MemoryHeapStats {
+    vk::DeviceSize blockBytes{}; // reserved by blocks and dedicated allocations
+    vk::DeviceSize usedBytes{};
+    vk::DeviceSize freeBytes{};        // free in blocks
+    vk::DeviceSize largestFreeRange{}; // largest free range in a single block
+    uint32_t       blockCount{};
+    uint32_t       allocationCount{};
+    uint32_t       dedicatedCount{};
+
+    // 0 when the free bytes are one range, towards 1 when they are scattered in small ones
+    double getFragmentation() const {
+        return freeBytes == 0 ? 0.0 : 1.0 - static_cast<double>(largestFreeRange) / freeBytes;
+    }
+};
+
+/**
+ * @brief Sub-allocates buffer and image memory out of large blocks, singleton.
+ *
+ * @details Every memory type gets its own blocks, split again into linear and optimal ones when
+ * the device asks for a bufferImageGranularity above 1, so buffers and optimal images never share
+ * a page and the granularity needs no per-allocation padding. Ranges in a block are handed out by
+ * a TLSF allocator. Requests larger than half a block and the render targets get memory of their
+ * own, the latter are recreated with the swap chain and would fragment the blocks.
+ * Host visible blocks stay mapped, mapping the same memory twice is not allowed so resources use
+ * MemoryAllocation::mapped instead of mapping themselves.
+ */
+class MemoryAllocator final : public VulkanAbstractBase {
+public:
+    static MemoryAllocator& get() {
+        static MemoryAllocator allocator = MemoryAllocator();
+        return allocator;
+    }
+
+    MemoryAllocator(const MemoryAllocator&)            = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+private:
+    MemoryAllocator() : VulkanAbstractBase() {}
+
+public:
+    [[nodiscard]] MemoryAllocation allocate(const vk::MemoryRequirements& memReq,
+                                            vk::MemoryPropertyFlags       memPro,
+                                            ResourceTiling                tiling,
+                                            bool                          dedicated = false);
+    // allocate the memory of a buffer or an image and bind it
+    [[nodiscard]] MemoryAllocation allocate(vk::Buffer buffer, vk::MemoryPropertyFlags memPro);
+    [[nodiscard]] MemoryAllocation allocate(vk::Image               image,
+                                            vk::MemoryPropertyFlags memPro,
+                                            bool                    dedicated = false);
+    // leaves allocation empty, nothing happens if it is already
+    void free(MemoryAllocation& allocation);
+
+    // one entry per memory heap
+    std::vector<MemoryHeapStats> getStats();
+    // log the stats of every heap in use
+    void report();
+
+    // free every block, the device must be idle, ranges still allocated are reported as leaked
+    void destroy() override;
+
+private:
+    struct MemoryBlock {
+        vk::DeviceMemory memory{};
+        void*            mapped = nullptr;
+        Tlsf             tlsf;
+    };
+
+    struct MemoryPool {
+        uint32_t                                  memoryType{};
+        std::vector<std::unique_ptr<MemoryBlock>> blocks{}; // null slots are reused
+    };
+
+private:
+    void init();
+
+    uint32_t getPoolIndex(uint32_t memoryType, ResourceTiling tiling) const;
+    uint32_t getHeapIndex(uint32_t memoryType) const;
+
+    MemoryAllocation allocateDedicated(const vk::MemoryRequirements& memReq, uint32_t memoryType);
+    // index of the new block in pool
+    uint32_t         createBlock(MemoryPool& pool, vk::DeviceSize minSize);
+    void*            mapIfHostVisible(vk::DeviceMemory memory, uint32_t memoryType);
+
+private:
+    std::mutex mutex{};
+    bool       inited = false;
+
+    vk::PhysicalDeviceMemoryProperties memProperties{};
+    vk::DeviceSize                     bufferImageGranularity{1};
+
+    std::vector<MemoryPool> pools{};
+
+    struct DedicatedRecord {
+        vk::DeviceMemory memory{};
+        vk::DeviceSize   size{};
+        uint32_t         heap{};
+    };
+    std::vector<DedicatedRecord> dedicatedAllocations{};
+};
+
+} // namespace TBE::Graphics
@@ -0,0 +1,197 @@
+#include "tlsf.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace TBE::Graphics {
+
+Tlsf::Tlsf(uint64_t size_) : size(size_) {
+    for (auto& row : heads) {
+        row.fill(nullNode);
+    }
+    auto  node  = newNode();
+    auto& whole = nodes[node];
+    whole.size  = size;
+    insertFree(node);
+    freeBytes = size;
+}
+
+// sizes below slCount get a class each, above it the 4 bits after the highest set one
+std::pair<uint32_t, uint32_t> Tlsf::mapping(uint64_t size) {
+    auto fl = static_cast<uint32_t>(std::bit_width(size) - 1);
+    if (fl < slBits) {
+        return {fl, static_cast<uint32_t>(size - (uint64_t{1} << fl))};
+    }
+    return {fl, static_cast<uint32_t>(size >> (fl - slBits)) & (slCount - 1)};
+}
+
+uint32_t Tlsf::findFree(uint64_t size) const {
+    // round up to the next class, every range in it or above is large enough
+    auto msb = static_cast<uint32_t>(std::bit_width(size) - 1);
+    if (msb >= slBits) {
+        size += (uint64_t{1} << (msb - slBits)) - 1;
+    }
+    auto [fl, sl] = mapping(size);
+
+    uint32_t slMap = slBitmaps[fl] & (~0u << sl);
+    if (slMap == 0) {
+        uint64_t flMap = fl + 1 < flCount ? flBitmap & (~uint64_t{0} << (fl + 1)) : 0;
+        if (flMap == 0) {
+            return nullNode;
+        }
+        fl    = static_cast<uint32_t>(std::countr_zero(flMap));
+        slMap = slBitmaps[fl];
+    }
+    return heads[fl][std::countr_zero(slMap)];
+}
+
+std::optional<Tlsf::Range> Tlsf::allocate(uint64_t size, uint64_t alignment) {
+    size      = std::max<uint64_t>(size, 1);
+    alignment = std::max<uint64_t>(alignment, 1);
+
+    auto node = findFree(size + alignment - 1);
+    if (node == nullNode) {
+        return std::nullopt;
+    }
+    removeFree(node);
+
+    uint64_t aligned = (nodes[node].offset + alignment - 1) & ~(alignment - 1);
+    if (aligned > nodes[node].offset) {
+        splitFront(node, aligned - nodes[node].offset);
+    }
+    if (nodes[node].size > size) {
+        splitBack(node, size);
+    }
+
+    nodes[node].free = false;
+    freeBytes -= size;
+    allocationCount++;
+    return Range{aligned, node};
+}
+
+void Tlsf::free(uint32_t node) {
+    freeBytes += nodes[node].size;
+    allocationCount--;
+    nodes[node].free = true;
+
+    // neighbours are never both free, so one merge on each side is enough
+    if (auto prev = nodes[node].prevPhys; prev != nullNode && nodes[prev].free) {
+        removeFree(prev);
+        nodes[prev].size += nodes[node].size;
+        nodes[prev].nextPhys = nodes[node].nextPhys;
+        if (nodes[node].nextPhys != nullNode) {
+            nodes[nodes[node].nextPhys].prevPhys = prev;
+        }
+        releaseNode(node);
+        node = prev;
+    }
+    if (auto next = nodes[node].nextPhys; next != nullNode && nodes[next].free) {
+        removeFree(next);
+        nodes[node].size += nodes[next].size;
+        nodes[node].nextPhys = nodes[next].nextPhys;
+        if (nodes[next].nextPhys != nullNode) {
+            nodes[nodes[next].nextPhys].prevPhys = node;
+        }
+        releaseNode(next);
+    }
+    insertFree(node);
+}
+
+uint64_t Tlsf::getLargestFreeRange() const {
+    if (flBitmap == 0) {
+        return 0;
+    }
+    auto     fl      = static_cast<uint32_t>(63 - std::countl_zero(flBitmap));
+    auto     sl      = static_cast<uint32_t>(31 - std::countl_zero(slBitmaps[fl]));
+    uint64_t largest = 0;
+    for (auto node = heads[fl][sl]; node != nullNode; node = nodes[node].nextFree) {
+        largest = std::max(largest, nodes[node].size);
+    }
+    return largest;
+}
+
+void Tlsf::insertFree(uint32_t node) {
+    auto [fl, sl] = mapping(nodes[node].size);
+
+    nodes[node].free     = true;
+    nodes[node].prevFree = nullNode;
+    nodes[node].nextFree = heads[fl][sl];
+    if (heads[fl][sl] != nullNode) {
+        nodes[heads[fl][sl]].prevFree = node;
+    }
+    heads[fl][sl] = node;
+    slBitmaps[fl] |= 1u << sl;
+    flBitmap |= uint64_t{1} << fl;
+}
+
+void Tlsf::removeFree(uint32_t node) {
+    auto [fl, sl] = mapping(nodes[node].size);
+    auto& n       = nodes[node];
+
+    if (n.prevFree != nullNode) {
+        nodes[n.prevFree].nextFree = n.nextFree;
+    } else {
+        heads[fl][sl] = n.nextFree;
+    }
+    if (n.nextFree != nullNode) {
+        nodes[n.nextFree].prevFree = n.prevFree;
+    }
+    n.prevFree = n.nextFree = nullNode;
+    n.free                  = false;
+
+    if (heads[fl][sl] == nullNode) {
+        slBitmaps[fl] &= ~(1u << sl);
+        if (slBitmaps[fl] == 0) {
+            flBitmap &= ~(uint64_t{1} << fl);
+        }
+    }
+}
+
+uint32_t Tlsf::newNode() {
+    if (!unusedNodes.empty()) {
+        auto node = unusedNodes.back();
+        unusedNodes.pop_back();
+        nodes[node] = {};
+        return node;
+    }
+    nodes.emplace_back();
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void Tlsf::releaseNode(uint32_t node) {
+    unusedNodes.push_back(node);
+}
+
+// the alignment padding in front stays free, its previous neighbour is in use
+void Tlsf::splitFront(uint32_t node, uint64_t frontSize) {
+    auto front = newNode(); // may reallocate nodes, index after this
+
+    nodes[front].offset   = nodes[node].offset;
+    nodes[front].size     = frontSize;
+    nodes[front].prevPhys = nodes[node].prevPhys;
+    nodes[front].nextPhys = node;
+    if (nodes[node].prevPhys != nullNode) {
+        nodes[nodes[node].prevPhys].nextPhys = front;
+    }
+    nodes[node].prevPhys = front;
+    nodes[node].offset += frontSize;
+    nodes[node].size -= frontSize;
+    insertFree(front);
+}
+
+void Tlsf::splitBack(uint32_t node, uint64_t keepSize) {
+    auto back = newNode();
+
+    nodes[back].offset   = nodes[node].offset + keepSize;
+    nodes[back].size     = nodes[node].size - keepSize;
+    nodes[back].prevPhys = node;
+    nodes[back].nextPhys = nodes[node].nextPhys;
+    if (nodes[node].nextPhys != nullNode) {
+        nodes[nodes[node].nextPhys].prevPhys = back;
+    }
+    nodes[node].nextPhys = back;
+    nodes[node].size     = keepSize;
+    insertFree(back);
+}
+
+} // namespace TBE::Graphics
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace TBE::Graphics {
+
+/**
+ * @brief Two-level segregated fit allocator over the offsets of one memory block.
+ *
+ * @details Free ranges are kept in 64 * 16 size classes, the first level is the highest set bit
+ * of the size and the second level the next 4 bits. Allocation rounds the size up to the next
+ * class, so the head of any non-empty class at or above it fits, found by two bit scans. Freed
+ * ranges are merged with their free neighbours right away. Only the bookkeeping lives here, the
+ * memory itself is never touched.
+ */
+class Tlsf {
+public:
+    static constexpr uint32_t nullNode = UINT32_MAX;
+
+    struct Range {
+        uint64_t offset{};
+        uint32_t node = nullNode; // hand back to free()
+    };
+
+public:
+    explicit Tlsf(uint64_t size);
+
+    // return nothing if no free range can hold size bytes at the alignment, a power of two
+    std::optional<Range> allocate(uint64_t size, uint64_t alignment);
+    void                 free(uint32_t node);
+
+public:
+    uint64_t getSize() const { return size; }
+    uint64_t getFreeBytes() const { return freeBytes; }
+    uint32_t getAllocationCount() const { return allocationCount; }
+    uint64_t getLargestFreeRange() const;
+
+private:
+    static constexpr uint32_t slBits  = 4;
+    static constexpr uint32_t slCount = 1 << slBits;
+    static constexpr uint32_t flCount = 64;
+
+    struct Node {
+        uint64_t offset{};
+        uint64_t size{};
+        uint32_t prevPhys = nullNode;
+        uint32_t nextPhys = nullNode;
+        uint32_t prevFree = nullNode;
+        uint32_t nextFree = nullNode;
+        bool     free     = false;
+    };
+
+    std::vector<Node>     nodes{};
+    std::vector<uint32_t> unusedNodes{};
+
+    uint64_t                                           flBitmap{};
+    std::array<uint32_t, flCount>                      slBitmaps{};
+    std::array<std::array<uint32_t, slCount>, flCount> heads{};
+
+    uint64_t size{};
+    uint64_t freeBytes{};
+    uint32_t allocationCount{};
+
+private:
+    static std::pair<uint32_t, uint32_t> mapping(uint64_t size);
+
+    uint32_t findFree(uint64_t size) const;
+    void     insertFree(uint32_t node);
+    void     removeFree(uint32_t node);
+    uint32_t newNode();
+    void     releaseNode(uint32_t node);
+    // cut the given bytes off the front or the back of node into a new free node
+    void     splitFront(uint32_t node, uint64_t frontSize);
+    void     splitBack(uint32_t node, uint64_t keepSize);
+};
+
+} // namespace TBE::Graphics
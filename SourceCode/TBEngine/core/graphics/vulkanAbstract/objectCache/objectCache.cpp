@@ -0,0 +1,191 @@
+#include "objectCache.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/utils/hash/hash.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <type_traits>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+
+// every field is widened or split into 32 bit words, so padding never ends up in a key
+template <typename T>
+static void pushWord(std::vector<uint32_t>& key, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        key.push_back(std::bit_cast<uint32_t>(value));
+    } else {
+        key.push_back(static_cast<uint32_t>(value));
+    }
+}
+
+template <typename Handle>
+static void pushHandle(std::vector<uint32_t>& key, Handle handle) {
+    auto raw = std::bit_cast<uint64_t>(static_cast<typename Handle::CType>(handle));
+    key.push_back(static_cast<uint32_t>(raw));
+    key.push_back(static_cast<uint32_t>(raw >> 32));
+}
+
+ObjectCache::~ObjectCache() {
+    destroy();
+}
+
+// the tables are empty once destroyed, the device may already be gone when a static owner is
+// destructed
+void ObjectCache::destroy() {
+    for (auto& [hash, bucket] : samplers) {
+        for (auto& [key, sampler] : bucket) {
+            device.destroy(sampler);
+        }
+    }
+    for (auto& [hash, bucket] : pipelineLayouts) {
+        for (auto& [key, layout] : bucket) {
+            device.destroy(layout);
+        }
+    }
+    for (auto& [hash, bucket] : setLayouts) {
+        for (auto& [key, layout] : bucket) {
+            device.destroy(layout);
+        }
+    }
+    if (count > 0) {
+        logger->trace("object cache: " + std::to_string(count) + " objects created, " +
+                      std::to_string(hits) + " lookups shared one");
+    }
+    samplers.clear();
+    pipelineLayouts.clear();
+    setLayouts.clear();
+    hits = count = 0;
+}
+
+template <typename Handle, typename Create>
+Handle ObjectCache::lookup(Table<Handle>& table, const Key& key, Create&& create) {
+    auto& bucket = table[Utils::hashBytes(key.data(), key.size() * sizeof(uint32_t))];
+    for (const auto& [entryKey, handle] : bucket) {
+        if (entryKey == key) {
+            hits++;
+            return handle;
+        }
+    }
+    Handle handle = create();
+    bucket.emplace_back(key, handle);
+    count++;
+    return handle;
+}
+
+vk::Sampler ObjectCache::getSampler(const vk::SamplerCreateInfo& info) {
+    if (info.pNext) {
+        Utils::Log::logErrorMsg("cached samplers cannot have a pNext chain");
+    }
+
+    Key key{};
+    pushWord(key, static_cast<VkSamplerCreateFlags>(info.flags));
+    pushWord(key, info.magFilter);
+    pushWord(key, info.minFilter);
+    pushWord(key, info.mipmapMode);
+    pushWord(key, info.addressModeU);
+    pushWord(key, info.addressModeV);
+    pushWord(key, info.addressModeW);
+    pushWord(key, info.mipLodBias);
+    pushWord(key, info.anisotropyEnable);
+    pushWord(key, info.maxAnisotropy);
+    pushWord(key, info.compareEnable);
+    pushWord(key, info.compareOp);
+    pushWord(key, info.minLod);
+    pushWord(key, info.maxLod);
+    pushWord(key, info.borderColor);
+    pushWord(key, info.unnormalizedCoordinates);
+
+    return lookup(samplers, key, [&]() {
+        vk::Sampler sampler{};
+        depackReturnValue(sampler, device.createSampler(info));
+        return sampler;
+    });
+}
+
+vk::DescriptorSetLayout
+ObjectCache::getSetLayout(vk::ArrayProxy<const vk::DescriptorSetLayoutBinding> bindings,
+                          vk::DescriptorSetLayoutCreateFlags                   flags,
+                          vk::ArrayProxy<const vk::DescriptorBindingFlags>     bindingFlags) {
+    if (!bindingFlags.empty() && bindingFlags.size() != bindings.size()) {
+        Utils::Log::logErrorMsg("a set layout needs binding flags for all of its bindings or none");
+    }
+
+    // the flags of a binding move with it
+    std::vector<uint32_t> order(bindings.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return bindings.data()[a].binding < bindings.data()[b].binding;
+    });
+    std::vector<vk::DescriptorSetLayoutBinding> sorted{};
+    std::vector<vk::DescriptorBindingFlags>     sortedFlags{};
+    for (auto i : order) {
+        sorted.push_back(bindings.data()[i]);
+        if (!bindingFlags.empty()) {
+            sortedFlags.push_back(bindingFlags.data()[i]);
+        }
+    }
+
+    Key key{};
+    pushWord(key, static_cast<VkDescriptorSetLayoutCreateFlags>(flags));
+    pushWord(key, !sortedFlags.empty());
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const auto& binding = sorted[i];
+        pushWord(key, binding.binding);
+        pushWord(key, binding.descriptorType);
+        pushWord(key, binding.descriptorCount);
+        pushWord(key, static_cast<VkShaderStageFlags>(binding.stageFlags));
+        pushWord(key, binding.pImmutableSamplers != nullptr);
+        if (binding.pImmutableSamplers) {
+            for (uint32_t j = 0; j < binding.descriptorCount; j++) {
+                pushHandle(key, binding.pImmutableSamplers[j]);
+            }
+        }
+        if (!sortedFlags.empty()) {
+            pushWord(key, static_cast<VkDescriptorBindingFlags>(sortedFlags[i]));
+        }
+    }
+
+    return lookup(setLayouts, key, [&]() {
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{sortedFlags};
+        vk::DescriptorSetLayoutCreateInfo             layoutInfo{flags, sorted};
+        if (!sortedFlags.empty()) {
+            layoutInfo.setPNext(&flagsInfo);
+        }
+        vk::DescriptorSetLayout layout{};
+        depackReturnValue(layout, device.createDescriptorSetLayout(layoutInfo));
+        return layout;
+    });
+}
+
+vk::PipelineLayout
+ObjectCache::getPipelineLayout(vk::ArrayProxy<const vk::DescriptorSetLayout> layouts,
+                               vk::ArrayProxy<const vk::PushConstantRange>   pushConstants) {
+    Key key{};
+    pushWord(key, layouts.size());
+    for (const auto& setLayout : layouts) {
+        pushHandle(key, setLayout);
+    }
+    for (const auto& range : pushConstants) {
+        pushWord(key, static_cast<VkShaderStageFlags>(range.stageFlags));
+        pushWord(key, range.offset);
+        pushWord(key, range.size);
+    }
+
+    return lookup(pipelineLayouts, key, [&]() {
+        vk::PipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.setSetLayoutCount(layouts.size())
+            .setPSetLayouts(layouts.data())
+            .setPushConstantRangeCount(pushConstants.size())
+            .setPPushConstantRanges(pushConstants.data());
+        vk::PipelineLayout layout{};
+        depackReturnValue(layout, device.createPipelineLayout(layoutInfo));
+        return layout;
+    });
+}
+
+} // namespace TBE::Graphics
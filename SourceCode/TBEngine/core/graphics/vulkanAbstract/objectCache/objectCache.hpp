@@ -0,0 +1,70 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TBE::Graphics {
+
+/**
+ * @brief Samplers, descriptor set layouts and pipeline layouts shared by everything that asks for
+ * them with the same create info.
+ *
+ * @details A lookup packs the contents of the create info into a key of 32 bit words, hashes it
+ * and only creates the object if no entry with an equal key exists. The cache owns every handle it
+ * hands out until destroy(), callers never destroy them, so two equal handles always mean equal
+ * contents and comparing layouts, e.g. to sort draws by state, is one comparison. The order of
+ * the bindings of a set layout is not part of its key, their binding flags are kept with them.
+ * Other pNext chains are not supported. Lookups are made from the thread that records the frames.
+ */
+class ObjectCache final : public VulkanAbstractBase {
+    using super = VulkanAbstractBase;
+
+public:
+    ObjectCache() : super() {}
+    ~ObjectCache();
+
+    ObjectCache(const ObjectCache&)            = delete;
+    ObjectCache& operator=(const ObjectCache&) = delete;
+
+    void destroy() override;
+
+public:
+    // array proxies, so a single binding, layout or range can be passed as it is
+    vk::Sampler getSampler(const vk::SamplerCreateInfo& info);
+
+    // bindingFlags are empty or one per binding, in the order of bindings
+    vk::DescriptorSetLayout
+    getSetLayout(vk::ArrayProxy<const vk::DescriptorSetLayoutBinding> bindings,
+                 vk::DescriptorSetLayoutCreateFlags                   flags        = {},
+                 vk::ArrayProxy<const vk::DescriptorBindingFlags>     bindingFlags = nullptr);
+
+    vk::PipelineLayout
+    getPipelineLayout(vk::ArrayProxy<const vk::DescriptorSetLayout> layouts,
+                      vk::ArrayProxy<const vk::PushConstantRange>   pushConstants = nullptr);
+
+    // lookups that found their object already, and objects created
+    uint32_t getHits() const { return hits; }
+    uint32_t getCount() const { return count; }
+
+private:
+    using Key = std::vector<uint32_t>;
+    template <typename Handle>
+    using Table = std::unordered_map<uint64_t, std::vector<std::pair<Key, Handle>>>;
+
+    template <typename Handle, typename Create>
+    Handle lookup(Table<Handle>& table, const Key& key, Create&& create);
+
+private:
+    Table<vk::Sampler>             samplers{};
+    Table<vk::DescriptorSetLayout> setLayouts{};
+    Table<vk::PipelineLayout>      pipelineLayouts{};
+    uint32_t                       hits{};
+    uint32_t                       count{};
+};
+
+} // namespace TBE::Graphics
@@ -0,0 +1,44 @@
+#include "uploadBatch.hpp"
+#include "TBEngine/core/graphics/graphics.hpp"
+
+namespace TBE::Graphics {
+
+const vk::CommandBuffer& UploadBatch::getCmdBuffer() const {
+    return VulkanGraphics::uploadContext.getCmdBuffer();
+}
+
+StagingRange UploadBatch::stage(const std::span<std::byte>& inData) {
+    return VulkanGraphics::uploadContext.stage(inData);
+}
+
+void UploadBatch::handOver(vk::Buffer buffer) {
+    VulkanGraphics::uploadContext.handOver(buffer);
+}
+
+void UploadBatch::uploadImage(vk::Image                        image,
+                              uint32_t                         mipLevels,
+                              const StagingRange&              source,
+                              std::vector<vk::BufferImageCopy> regions) {
+    VulkanGraphics::uploadContext.uploadImage(image, mipLevels, source, std::move(regions));
+}
+
+// the context may have flushed in between, the batch open now is the last one holding a copy
+void UploadBatch::submit() {
+    if (submitted) {
+        Utils::Log::logErrorMsg("upload batch submitted twice");
+    }
+    ticket    = VulkanGraphics::uploadContext.getTicket();
+    submitted = true;
+}
+
+bool UploadBatch::isDone() {
+    return submitted && VulkanGraphics::uploadContext.isDone(ticket);
+}
+
+void UploadBatch::wait() {
+    if (submitted) {
+        VulkanGraphics::uploadContext.wait(ticket);
+    }
+}
+
+} // namespace TBE::Graphics
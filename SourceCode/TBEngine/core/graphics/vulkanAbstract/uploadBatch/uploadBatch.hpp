@@ -0,0 +1,47 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/uploadContext/uploadContext.hpp"
+
+#include <span>
+#include <vector>
+
+namespace TBE::Graphics {
+
+/**
+ * @brief The uploads of one asset, recorded into the shared UploadContext.
+ *
+ * @details Copies are recorded into getCmdBuffer() or queued with uploadImage() between
+ * construction and submit(), the data given to stage() is copied into the staging ring right away.
+ * submit() only closes the batch, the commands go out with the next flush of the context, at the
+ * latest right before the next frame is drawn, which is then guaranteed to see them. isDone()
+ * tells when the copies have finished, wait() flushes and blocks until then. Everything here must
+ * happen on the thread that owns the command pool.
+ */
+class UploadBatch {
+public:
+    UploadBatch() = default;
+
+    UploadBatch(const UploadBatch&)            = delete;
+    UploadBatch& operator=(const UploadBatch&) = delete;
+
+public:
+    const vk::CommandBuffer& getCmdBuffer() const;
+    StagingRange             stage(const std::span<std::byte>& inData);
+    // see UploadContext::handOver and UploadContext::uploadImage
+    void                     handOver(vk::Buffer buffer);
+    void                     uploadImage(vk::Image                        image,
+                                         uint32_t                         mipLevels,
+                                         const StagingRange&              source,
+                                         std::vector<vk::BufferImageCopy> regions);
+
+    void submit();
+    bool isDone();
+    void wait();
+
+private:
+    UploadContext::Ticket ticket{};
+    bool                  submitted = false;
+};
+
+} // namespace TBE::Graphics
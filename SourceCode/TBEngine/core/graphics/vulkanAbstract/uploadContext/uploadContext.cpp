@@ -0,0 +1,346 @@
+#include "uploadContext.hpp"
+#include "TBEngine/core/graphics/detail/graphicsDetail.hpp"
+#include "TBEngine/core/graphics/graphics.hpp"
+#include "TBEngine/settings.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace TBE::Graphics {
+using namespace TBE::Graphics::Detail;
+
+UploadContext::~UploadContext() {
+    destroy();
+}
+
+void UploadContext::init() {
+    separateQueue = static_cast<bool>(VulkanGraphics::transferQueue);
+    queue         = VulkanGraphics::graphicsQueue;
+    pool          = VulkanGraphics::commandPool;
+    if (separateQueue) {
+        queue = VulkanGraphics::transferQueue;
+        pool  = VulkanGraphics::transferCommandPool;
+    }
+    ringSize = STAGING_RING_SIZE;
+
+    vk::BufferCreateInfo bufferInfo{};
+    bufferInfo.setSize(ringSize)
+        .setUsage(vk::BufferUsageFlagBits::eTransferSrc)
+        .setSharingMode(vk::SharingMode::eExclusive);
+    depackReturnValue(ringBuffer, device.createBuffer(bufferInfo));
+
+    ringAllocation = MemoryAllocator::get().allocate(ringBuffer,
+                                                     vk::MemoryPropertyFlagBits::eHostVisible |
+                                                         vk::MemoryPropertyFlagBits::eHostCoherent);
+}
+
+// the handles are checked, the device may already be gone when a static owner is destructed
+void UploadContext::destroy() {
+    if (recording) {
+        handleVkResult(recording->cmdBuffer.end());
+        if (recording->acquireCmdBuffer) {
+            handleVkResult(recording->acquireCmdBuffer.end());
+        }
+        freeBatches.emplace_back(std::move(*recording));
+        recording.reset();
+    }
+    while (!inFlight.empty()) {
+        freeBatches.emplace_back(std::move(inFlight.front()));
+        inFlight.pop_front();
+    }
+    for (auto& batch : freeBatches) {
+        device.free(pool, 1, &batch.cmdBuffer);
+        if (batch.acquireCmdBuffer) {
+            device.free(VulkanGraphics::commandPool, 1, &batch.acquireCmdBuffer);
+            device.destroy(batch.copied);
+        }
+        device.destroy(batch.fence);
+    }
+    freeBatches.clear();
+
+    if (ringBuffer) {
+        device.destroy(ringBuffer);
+        ringBuffer = nullptr;
+    }
+    MemoryAllocator::get().free(ringAllocation);
+    head = tail = 0;
+}
+
+StagingRange UploadContext::stage(const std::span<std::byte>& inData, vk::DeviceSize alignment) {
+    vk::DeviceSize size = inData.size();
+
+    if (size > ringSize / 2) {
+        auto& batch   = open();
+        auto& staging = *batch.overflow.emplace_back(std::make_unique<StagingBuffer>(inData));
+        batch.stagedBytes += size;
+        return {staging.buffer, 0};
+    }
+
+    // smaller batches let the GPU start on the first copies while the rest is staged
+    if (recording && recording->stagedBytes + size > ringSize / 4) {
+        flush();
+    }
+    auto offset = reserve(size, alignment);
+    std::memcpy(static_cast<std::byte*>(ringAllocation.mapped) + offset, inData.data(), size);
+
+    open().stagedBytes += size;
+    return {ringBuffer, offset};
+}
+
+const vk::CommandBuffer& UploadContext::getCmdBuffer() {
+    return open().cmdBuffer;
+}
+
+const vk::CommandBuffer& UploadContext::getGraphicsCmdBuffer() {
+    auto& batch = open();
+    return separateQueue ? batch.acquireCmdBuffer : batch.cmdBuffer;
+}
+
+UploadContext::Ticket UploadContext::getTicket() const {
+    return recording ? recording->ticket : nextTicket - 1;
+}
+
+std::vector<uint32_t> UploadContext::getQueueFamilies() const {
+    if (!separateQueue) {
+        return {VulkanGraphics::graphicsQueueFamily};
+    }
+    return {VulkanGraphics::graphicsQueueFamily, VulkanGraphics::transferQueueFamily};
+}
+
+void UploadContext::handOver(vk::Buffer buffer) {
+    open().bufferHandOvers.push_back(buffer);
+}
+
+void UploadContext::uploadImage(vk::Image                        image,
+                                uint32_t                         mipLevels,
+                                const StagingRange&              source,
+                                std::vector<vk::BufferImageCopy> regions) {
+    for (auto& region : regions) {
+        region.bufferOffset += source.offset;
+    }
+    open().imageUploads.push_back({image, mipLevels, source.buffer, std::move(regions)});
+}
+
+// the images are new, the tracked layouts start at eUndefined and are dropped again afterwards
+void UploadContext::recordPending(Batch& batch) {
+    for (const auto& upload : batch.imageUploads) {
+        barriers.transition(
+            upload.image, 0, upload.mipLevels, vk::ImageLayout::eTransferDstOptimal);
+    }
+    barriers.record(batch.cmdBuffer);
+
+    for (const auto& upload : batch.imageUploads) {
+        batch.cmdBuffer.copyBufferToImage(
+            upload.source, upload.image, vk::ImageLayout::eTransferDstOptimal, upload.regions);
+    }
+
+    auto srcFamily = VulkanGraphics::transferQueueFamily;
+    auto dstFamily = VulkanGraphics::graphicsQueueFamily;
+    for (const auto& upload : batch.imageUploads) {
+        if (separateQueue) {
+            barriers.release(upload.image,
+                             0,
+                             upload.mipLevels,
+                             vk::ImageLayout::eShaderReadOnlyOptimal,
+                             srcFamily,
+                             dstFamily,
+                             acquireBarriers);
+        } else {
+            barriers.transition(
+                upload.image, 0, upload.mipLevels, vk::ImageLayout::eShaderReadOnlyOptimal);
+        }
+    }
+    if (separateQueue) {
+        for (auto buffer : batch.bufferHandOvers) {
+            barriers.release(buffer, srcFamily, dstFamily, acquireBarriers);
+        }
+    } else {
+        // one queue, every copy of the batch is visible to whatever comes after it
+        barriers.memory(vk::PipelineStageFlagBits::eTransfer,
+                        vk::AccessFlagBits::eTransferWrite,
+                        vk::PipelineStageFlagBits::eAllCommands,
+                        vk::AccessFlagBits::eMemoryRead);
+    }
+    barriers.record(batch.cmdBuffer);
+    acquireBarriers.record(batch.acquireCmdBuffer);
+
+    barriers.reset();
+    batch.imageUploads.clear();
+    batch.bufferHandOvers.clear();
+}
+
+void UploadContext::flush() {
+    if (!recording) {
+        return;
+    }
+    auto& batch = *recording;
+    recordPending(batch);
+
+    if (separateQueue) {
+        handleVkResult(batch.cmdBuffer.end());
+        handleVkResult(batch.acquireCmdBuffer.end());
+
+        vk::SubmitInfo copyInfo{};
+        copyInfo.setCommandBuffers(batch.cmdBuffer).setSignalSemaphores(batch.copied);
+        handleVkResult(queue.submit(copyInfo));
+
+        vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+        vk::SubmitInfo         acquireInfo{};
+        acquireInfo.setWaitSemaphores(batch.copied)
+            .setWaitDstStageMask(waitStage)
+            .setCommandBuffers(batch.acquireCmdBuffer);
+        handleVkResult(VulkanGraphics::graphicsQueue.submit(acquireInfo, batch.fence));
+    } else {
+        handleVkResult(batch.cmdBuffer.end());
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setCommandBuffers(batch.cmdBuffer);
+        handleVkResult(queue.submit(submitInfo, batch.fence));
+    }
+
+    batch.submitTime = Clock::now();
+    batch.ringEnd    = head;
+    inFlight.emplace_back(std::move(batch));
+    recording.reset();
+
+    retireFinished();
+}
+
+bool UploadContext::isDone(Ticket ticket) {
+    retireFinished();
+    if (recording && recording->ticket <= ticket) {
+        return false;
+    }
+    return inFlight.empty() || inFlight.front().ticket > ticket;
+}
+
+void UploadContext::wait(Ticket ticket) {
+    if (recording && recording->ticket <= ticket) {
+        flush();
+    }
+    while (!inFlight.empty() && inFlight.front().ticket <= ticket) {
+        retireOldest();
+    }
+}
+
+UploadContext::Batch& UploadContext::open() {
+    if (recording) {
+        return *recording;
+    }
+
+    if (freeBatches.empty()) {
+        Batch batch{};
+
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.setLevel(vk::CommandBufferLevel::ePrimary)
+            .setCommandPool(pool)
+            .setCommandBufferCount(1);
+        std::vector<vk::CommandBuffer> cmdBuffers{};
+        depackReturnValue(cmdBuffers, device.allocateCommandBuffers(allocInfo));
+        batch.cmdBuffer = cmdBuffers[0];
+
+        if (separateQueue) {
+            allocInfo.setCommandPool(VulkanGraphics::commandPool);
+            depackReturnValue(cmdBuffers, device.allocateCommandBuffers(allocInfo));
+            batch.acquireCmdBuffer = cmdBuffers[0];
+
+            vk::SemaphoreCreateInfo semaphoreInfo{};
+            depackReturnValue(batch.copied, device.createSemaphore(semaphoreInfo));
+        }
+
+        vk::FenceCreateInfo fenceInfo{};
+        depackReturnValue(batch.fence, device.createFence(fenceInfo));
+
+        freeBatches.emplace_back(std::move(batch));
+    }
+    recording.emplace(std::move(freeBatches.back()));
+    freeBatches.pop_back();
+
+    recording->ticket      = nextTicket++;
+    recording->stagedBytes = 0;
+    recording->imageUploads.clear();
+    recording->bufferHandOvers.clear();
+
+    // the pools reset the command buffers on begin
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    handleVkResult(recording->cmdBuffer.begin(beginInfo));
+    if (separateQueue) {
+        handleVkResult(recording->acquireCmdBuffer.begin(beginInfo));
+    }
+    return *recording;
+}
+
+// a range that would run past the end of the ring starts over at its beginning instead
+uint64_t UploadContext::reserve(vk::DeviceSize size, vk::DeviceSize alignment) {
+    while (true) {
+        if (head == tail) {
+            // nothing is in use, start at the beginning again
+            head = tail = (head + ringSize - 1) / ringSize * ringSize;
+        }
+
+        uint64_t pos   = head % ringSize;
+        uint64_t start = (pos + alignment - 1) & ~(alignment - 1);
+        uint64_t need  = start - pos + size;
+        if (start + size > ringSize) {
+            start = 0;
+            need  = ringSize - pos + size;
+        }
+        if (head + need - tail <= ringSize) {
+            head += need;
+            return start;
+        }
+
+        if (!inFlight.empty()) {
+            retireOldest();
+        } else if (recording) {
+            flush();
+        } else {
+            Utils::Log::logErrorMsg("staging ring cannot hold " + std::to_string(size) + " bytes");
+        }
+    }
+}
+
+void UploadContext::retireFinished() {
+    while (!inFlight.empty() &&
+           device.getFenceStatus(inFlight.front().fence) == vk::Result::eSuccess) {
+        retireOldest();
+    }
+}
+
+void UploadContext::retireOldest() {
+    auto& batch = inFlight.front();
+    while (device.waitForFences(batch.fence, vk::True, std::numeric_limits<uint64_t>::max()) ==
+           vk::Result::eTimeout) {
+        logger->warn("wait for upload fence: timeout.");
+    }
+    handleVkResult(device.resetFences(batch.fence));
+
+    retiredBatches++;
+    uploadedBytes += batch.stagedBytes;
+    latencyMs += std::chrono::duration<double, std::chrono::milliseconds::period>(
+                     Clock::now() - batch.submitTime)
+                     .count();
+
+    // the ring was rewound while this batch was in flight when its end lies behind the tail
+    tail = std::max(tail, batch.ringEnd);
+    batch.overflow.clear();
+    freeBatches.emplace_back(std::move(batch));
+    inFlight.pop_front();
+}
+
+// the latency is seen from the CPU, a batch is only noticed as done when the context is polled
+void UploadContext::report() {
+    if (retiredBatches == 0) {
+        return;
+    }
+    logger->info("uploads: " + std::to_string(retiredBatches) + " batches on the " +
+                 (separateQueue ? "transfer" : "graphics") + " queue, " +
+                 std::to_string(uploadedBytes >> 20) + " MiB, " +
+                 std::to_string(latencyMs / retiredBatches) +
+                 " ms from submit to completion on average");
+}
+
+} // namespace TBE::Graphics
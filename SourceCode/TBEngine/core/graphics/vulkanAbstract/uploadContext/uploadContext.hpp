@@ -0,0 +1,153 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeVulkan.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/barrierBatch/barrierBatch.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/base/vulkanAbstractBase.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/bufferResource/stagingBuffer.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace TBE::Graphics {
+
+// where stage() put the data, the source of the copies recorded for it
+struct StagingRange {
+    vk::Buffer     buffer{};
+    vk::DeviceSize offset{};
+};
+
+/**
+ * @brief Records every upload into one shared command buffer, staged through a persistent ring.
+ *
+ * @details stage() copies the data into a persistently mapped ring buffer, the copies out of it
+ * are recorded into the batch that is open, getCmdBuffer(). flush() submits that batch with a
+ * fence, it runs once per frame before the frame is drawn and whenever the ring or the batch is
+ * full, so loading hundreds of assets takes a handful of submits. Batches retire in submit order
+ * once their fence has signalled, which hands their part of the ring back.
+ * When the device has a transfer only queue family the copies run there and overlap rendering.
+ * Every buffer and image written by a batch is then released to the graphics family, a second
+ * command buffer on the graphics queue waits on the semaphore of the copies and acquires them.
+ * Without that family everything runs on the graphics queue and the batch ends in a barrier
+ * instead. Either way an upload may be drawn from as soon as it is flushed.
+ * Images are only queued by uploadImage(), flush() records them all at once: one barrier taking
+ * every image to eTransferDstOptimal, the copies, one barrier releasing or transitioning them to
+ * eShaderReadOnlyOptimal together with the buffers handed over, and one acquiring them.
+ * Data larger than half the ring gets a staging buffer of its own, released with its batch.
+ * Everything here must happen on the thread that owns the command pools.
+ */
+class UploadContext : public VulkanAbstractBase {
+    using super = VulkanAbstractBase;
+
+public:
+    using Ticket = uint64_t;
+
+public:
+    UploadContext() : super() {}
+    ~UploadContext();
+
+    UploadContext(const UploadContext&)            = delete;
+    UploadContext& operator=(const UploadContext&) = delete;
+
+    // after the command pool is created
+    void init();
+    // the queue has to be idle
+    void destroy() override;
+
+public:
+    // may flush and wait for older batches to make room, alignment is a power of two
+    StagingRange             stage(const std::span<std::byte>& inData,
+                                   vk::DeviceSize              alignment = 16);
+    // commands for the upload queue, copies only when it is a transfer queue
+    const vk::CommandBuffer& getCmdBuffer();
+    // commands for the graphics queue, run after the copies of the same batch
+    const vk::CommandBuffer& getGraphicsCmdBuffer();
+    // the batch getCmdBuffer() records into, the last one submitted if none is open
+    Ticket                   getTicket() const;
+    // the families resources written by both queues are shared between, one without a transfer
+    // queue
+    std::vector<uint32_t>    getQueueFamilies() const;
+
+    // after the last copy into a buffer, the barrier is recorded with the others on flush()
+    void handOver(vk::Buffer buffer);
+    // copy the levels of a freshly created image out of source, regions are relative to it, the
+    // image ends up in eShaderReadOnlyOptimal and has to live until the batch is flushed
+    void uploadImage(vk::Image                        image,
+                     uint32_t                         mipLevels,
+                     const StagingRange&              source,
+                     std::vector<vk::BufferImageCopy> regions);
+
+    // submit the open batch, nothing happens if there is none
+    void flush();
+    // whether the batch of ticket and every one before it has finished
+    bool isDone(Ticket ticket);
+    void wait(Ticket ticket);
+
+    // log the number of batches, the bytes uploaded and the time from submit to completion
+    void report();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct ImageUpload {
+        vk::Image                        image{};
+        uint32_t                         mipLevels{};
+        vk::Buffer                       source{};
+        std::vector<vk::BufferImageCopy> regions{};
+    };
+
+    struct Batch {
+        vk::CommandBuffer cmdBuffer{};
+        // only with a transfer queue, acquires what cmdBuffer released
+        vk::CommandBuffer acquireCmdBuffer{};
+        vk::Semaphore     copied{};
+        vk::Fence         fence{};
+
+        Ticket                                      ticket{};
+        uint64_t                                    ringEnd{}; // ring head when submitted
+        vk::DeviceSize                              stagedBytes{};
+        Clock::time_point                           submitTime{};
+        std::vector<std::unique_ptr<StagingBuffer>> overflow{};
+        std::vector<ImageUpload>                    imageUploads{};
+        std::vector<vk::Buffer>                     bufferHandOvers{};
+    };
+
+private:
+    Batch&   open();
+    // the image uploads and hand overs queued into batch, right before it is ended
+    void     recordPending(Batch& batch);
+    uint64_t reserve(vk::DeviceSize size, vk::DeviceSize alignment);
+    void     retireFinished();
+    void     retireOldest();
+
+private:
+    bool            separateQueue = false;
+    vk::Queue       queue{};
+    vk::CommandPool pool{};
+
+    vk::Buffer       ringBuffer{};
+    MemoryAllocation ringAllocation{};
+    vk::DeviceSize   ringSize{};
+    // bytes ever reserved and released, the offset in the ring is taken modulo its size
+    uint64_t         head{};
+    uint64_t         tail{};
+
+    std::optional<Batch> recording{};
+    std::deque<Batch>    inFlight{};
+    std::vector<Batch>   freeBatches{};
+    Ticket               nextTicket = 1;
+
+    BarrierBatch barriers{};
+    BarrierBatch acquireBarriers{};
+
+    uint64_t retiredBatches{};
+    uint64_t uploadedBytes{};
+    double   latencyMs{};
+};
+
+} // namespace TBE::Graphics
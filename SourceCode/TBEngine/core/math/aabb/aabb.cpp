@@ -0,0 +1,61 @@
+#include "aabb.hpp"
+
+#include <algorithm>
+
+namespace TBE::Math {
+
+Aabb transformAabb(const glm::mat4& model, const Aabb& box) {
+    if (box.isEmpty()) {
+        return box;
+    }
+
+    // the extent along every world axis is the sum of the absolute rotated extents
+    glm::vec3 center = glm::vec3(model * glm::vec4(box.center(), 1.0f));
+    glm::vec3 half   = (box.max - box.min) * 0.5f;
+    glm::vec3 extent = glm::abs(glm::vec3(model[0])) * half.x +
+                       glm::abs(glm::vec3(model[1])) * half.y +
+                       glm::abs(glm::vec3(model[2])) * half.z;
+    return {center - extent, center + extent};
+}
+
+Containment aabbInFrustum(const FrustumPlanes& planes, const Aabb& box) {
+    if (box.isEmpty()) {
+        return Containment::eOutside;
+    }
+
+    glm::vec3 center = box.center();
+    glm::vec3 half   = (box.max - box.min) * 0.5f;
+    auto      result = Containment::eInside;
+    for (const auto& plane : planes) {
+        glm::vec3 normal   = glm::vec3(plane);
+        float     distance = glm::dot(normal, center) + plane.w;
+        float     radius   = glm::dot(glm::abs(normal), half);
+        if (distance < -radius) {
+            return Containment::eOutside;
+        }
+        if (distance < radius) {
+            result = Containment::eIntersecting;
+        }
+    }
+    return result;
+}
+
+float intersectRay(const glm::vec3& origin,
+                   const glm::vec3& invDirection,
+                   const Aabb&      box,
+                   float            maxDistance) {
+    if (box.isEmpty()) {
+        return -1.0f;
+    }
+
+    glm::vec3 t1    = (box.min - origin) * invDirection;
+    glm::vec3 t2    = (box.max - origin) * invDirection;
+    glm::vec3 tNear = glm::min(t1, t2);
+    glm::vec3 tFar  = glm::max(t1, t2);
+
+    float enter = std::max({tNear.x, tNear.y, tNear.z, 0.0f});
+    float exit  = std::min({tFar.x, tFar.y, tFar.z, maxDistance});
+    return enter <= exit ? enter : -1.0f;
+}
+
+} // namespace TBE::Math
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "TBEngine/core/math/frustum/frustum.hpp"
+
+#include <cfloat>
+
+namespace TBE::Math {
+
+// an axis aligned box, empty until grown, an empty box overlaps and contains nothing
+struct Aabb {
+    glm::vec3 min{FLT_MAX};
+    glm::vec3 max{-FLT_MAX};
+
+    bool      isEmpty() const { return min.x > max.x; }
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+
+    // half the surface area, the SAH only needs ratios of it
+    float halfArea() const {
+        if (isEmpty()) {
+            return 0.0f;
+        }
+        glm::vec3 size = max - min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    void grow(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    void grow(const Aabb& box) {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+
+    bool overlaps(const Aabb& box) const {
+        return glm::all(glm::lessThanEqual(min, box.max)) &&
+               glm::all(glm::lessThanEqual(box.min, max));
+    }
+    bool operator==(const Aabb& box) const { return min == box.min && max == box.max; }
+};
+
+enum class Containment
+{
+    eOutside,
+    eIntersecting,
+    eInside
+};
+
+// the box around the transformed corners of box
+Aabb transformAabb(const glm::mat4& model, const Aabb& box);
+
+// eInside if the box is inside every plane, eOutside if it is completely outside one
+Containment aabbInFrustum(const FrustumPlanes& planes, const Aabb& box);
+
+// the distance along the ray where it enters the box, 0 if it starts inside, negative if it misses
+// the box before maxDistance, invDirection is 1 / direction per axis
+float intersectRay(const glm::vec3& origin,
+                   const glm::vec3& invDirection,
+                   const Aabb&      box,
+                   float            maxDistance);
+
+} // namespace TBE::Math
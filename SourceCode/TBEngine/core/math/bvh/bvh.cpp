@@ -0,0 +1,659 @@
+#include "bvh.hpp"
+#include "TBEngine/core/math/frustum/frustumCuller.hpp"
+#include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/utils/threadPool/threadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <string>
+
+extern const TBE::Utils::Log::Logger* logger;
+
+namespace TBE::Math {
+
+static constexpr uint32_t noNode        = UINT32_MAX;
+static constexpr uint32_t binCount      = 16;
+static constexpr uint32_t maxLeafSize   = 8; // larger leaves are split even if the SAH disagrees
+static constexpr uint32_t maxDepth      = 64;
+static constexpr float    traversalCost = 1.0f; // of an inner node, relative to testing an item
+
+static constexpr size_t   syncBuildLimit    = 4096; // smaller trees are built right away
+static constexpr float    rebuildCostRatio  = 1.5f;
+static constexpr uint32_t rebuildInterval   = 600; // updates, about ten seconds
+static constexpr uint32_t costCheckInterval = 16;  // updates between two SAH cost checks
+
+// the box and center of an item are copied next to its id, the build partitions them in place
+// and reads every range front to back instead of jumping through the ids
+struct BuildItem {
+    Aabb      box{};
+    glm::vec3 center{};
+    uint32_t  item{};
+};
+
+// top down binned SAH, every subtree owns a contiguous range of the items
+struct TreeBuilder {
+    std::vector<BvhNode>&  nodes;
+    std::vector<uint32_t>& parents;
+    std::vector<BuildItem> items{};
+
+    uint32_t build(uint32_t begin, uint32_t end, uint32_t parent, uint32_t depth) {
+        auto node = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        parents.push_back(parent);
+
+        Aabb bounds{}, centerBounds{};
+        for (uint32_t i = begin; i < end; i++) {
+            bounds.grow(items[i].box);
+            centerBounds.grow(items[i].center);
+        }
+        uint32_t count = end - begin;
+        if (count <= 2 || depth >= maxDepth) {
+            nodes[node] = {bounds.min, begin, bounds.max, count};
+            return node;
+        }
+
+        glm::vec3 extent = centerBounds.max - centerBounds.min;
+        auto      binOf  = [&](const glm::vec3& center, int axis) {
+            float offset = (center[axis] - centerBounds.min[axis]) * binCount / extent[axis];
+            return std::min(binCount - 1, static_cast<uint32_t>(offset));
+        };
+
+        float    bestCost  = FLT_MAX;
+        int      bestAxis  = -1;
+        uint32_t bestSplit = 0; // the first bin of the right child
+        for (int axis = 0; axis < 3; axis++) {
+            if (extent[axis] <= 0.0f) {
+                continue;
+            }
+            std::array<Aabb, binCount>     binBoxes{};
+            std::array<uint32_t, binCount> binCounts{};
+            for (uint32_t i = begin; i < end; i++) {
+                auto bin = binOf(items[i].center, axis);
+                binCounts[bin]++;
+                binBoxes[bin].grow(items[i].box);
+            }
+
+            std::array<float, binCount>    rightArea{};
+            std::array<uint32_t, binCount> rightCount{};
+            Aabb                           right{};
+            uint32_t                       n = 0;
+            for (uint32_t bin = binCount - 1; bin > 0; bin--) {
+                right.grow(binBoxes[bin]);
+                n += binCounts[bin];
+                rightArea[bin]  = right.halfArea();
+                rightCount[bin] = n;
+            }
+            Aabb left{};
+            n = 0;
+            for (uint32_t bin = 0; bin + 1 < binCount; bin++) {
+                left.grow(binBoxes[bin]);
+                n += binCounts[bin];
+                if (n == 0 || rightCount[bin + 1] == 0) {
+                    continue;
+                }
+                float cost = left.halfArea() * n + rightArea[bin + 1] * rightCount[bin + 1];
+                if (cost < bestCost) {
+                    bestCost  = cost;
+                    bestAxis  = axis;
+                    bestSplit = bin + 1;
+                }
+            }
+        }
+
+        uint32_t mid = begin + count / 2; // every split is as good when the centers coincide
+        if (bestAxis >= 0) {
+            float area      = bounds.halfArea();
+            float splitCost = traversalCost + (area > 0.0f ? bestCost / area : 0.0f);
+            if (splitCost >= static_cast<float>(count) && count <= maxLeafSize) {
+                nodes[node] = {bounds.min, begin, bounds.max, count};
+                return node;
+            }
+            auto split = std::partition(
+                items.begin() + begin, items.begin() + end, [&](const BuildItem& item) {
+                    return binOf(item.center, bestAxis) < bestSplit;
+                });
+            mid = static_cast<uint32_t>(split - items.begin());
+        } else if (count <= maxLeafSize) {
+            nodes[node] = {bounds.min, begin, bounds.max, count};
+            return node;
+        }
+
+        build(begin, mid, node, depth + 1);
+        uint32_t right = build(mid, end, node, depth + 1);
+        nodes[node]    = {bounds.min, right, bounds.max, 0};
+        return node;
+    }
+};
+
+Bvh::Bvh() = default;
+
+// joins the worker, a build still queued is dropped
+Bvh::~Bvh() = default;
+
+void Bvh::set(uint32_t item, const Aabb& box) {
+    if (item >= boxes.size()) {
+        boxes.resize(item + 1);
+        leafOf.resize(item + 1, noNode);
+        alive.resize(item + 1, 0);
+    }
+
+    boxes[item] = box;
+    if (!alive[item]) {
+        alive[item] = 1;
+        itemCount++;
+        if (leafOf[item] == noNode) {
+            loose.push_back(item);
+        } else {
+            removedInTree--;
+        }
+    }
+    if (leafOf[item] != noNode) {
+        moved.push_back(leafOf[item]);
+    }
+    changedSinceBuild = true;
+}
+
+void Bvh::remove(uint32_t item) {
+    if (item >= alive.size() || !alive[item]) {
+        return;
+    }
+
+    alive[item] = 0;
+    boxes[item] = {};
+    itemCount--;
+    if (leafOf[item] == noNode) {
+        std::erase(loose, item);
+    } else {
+        removedInTree++;
+        moved.push_back(leafOf[item]);
+    }
+    changedSinceBuild = true;
+}
+
+void Bvh::clear() {
+    pending.reset();
+    tree = {};
+    boxes.clear();
+    leafOf.clear();
+    alive.clear();
+    loose.clear();
+    moved.clear();
+    itemCount         = 0;
+    removedInTree     = 0;
+    builtCost         = 0.0f;
+    updatesSinceBuild = 0;
+    changedSinceBuild = false;
+}
+
+void Bvh::update() {
+    if (pending && pending->done) {
+        install(std::move(pending->tree));
+        pending.reset();
+    }
+
+    // a pass over every node is cheaper than walking up from most of the leaves
+    if (moved.size() > tree.nodes.size() / 4) {
+        refitAll();
+    } else {
+        for (auto leaf : moved) {
+            refitLeaf(leaf);
+        }
+    }
+    moved.clear();
+
+    updatesSinceBuild++;
+    if (!tree.nodes.empty() && updatesSinceBuild % costCheckInterval == 0) {
+        tree.cost = computeCost(tree);
+    }
+    if (pending || !changedSinceBuild) {
+        return;
+    }
+
+    bool degraded = loose.size() > std::max<size_t>(64, itemCount / 8) ||
+                    removedInTree > tree.refs.size() / 4 ||
+                    tree.cost > builtCost * rebuildCostRatio;
+    bool stale    = updatesSinceBuild >= rebuildInterval;
+    if (tree.nodes.empty() || degraded || stale) {
+        startRebuild();
+    }
+}
+
+void Bvh::rebuild() {
+    pending.reset();
+    changedSinceBuild = false;
+
+    std::vector<uint32_t> items{};
+    items.reserve(itemCount);
+    for (uint32_t item = 0; item < alive.size(); item++) {
+        if (alive[item]) {
+            items.push_back(item);
+        }
+    }
+    install(buildTree(std::move(items), boxes));
+}
+
+// the worker builds from a copy of the boxes, whatever moves meanwhile is refit by install()
+void Bvh::startRebuild() {
+    if (itemCount <= syncBuildLimit) {
+        rebuild();
+        return;
+    }
+
+    std::vector<uint32_t> items{};
+    items.reserve(itemCount);
+    for (uint32_t item = 0; item < alive.size(); item++) {
+        if (alive[item]) {
+            items.push_back(item);
+        }
+    }
+    if (!worker) {
+        worker = std::make_unique<Utils::ThreadPool>(1);
+    }
+    pending = std::make_shared<PendingBuild>();
+    worker->submit([build = pending, items = std::move(items), boxes = boxes]() mutable {
+        build->tree = buildTree(std::move(items), boxes);
+        build->done = true;
+    });
+    changedSinceBuild = false;
+}
+
+Bvh::Tree Bvh::buildTree(std::vector<uint32_t> items, const std::vector<Aabb>& boxes) {
+    Tree tree{};
+    tree.refs = std::move(items);
+    if (tree.refs.empty()) {
+        return tree;
+    }
+
+    TreeBuilder builder{tree.nodes, tree.parents};
+    builder.items.reserve(tree.refs.size());
+    for (auto item : tree.refs) {
+        builder.items.push_back({boxes[item], boxes[item].center(), item});
+    }
+    tree.nodes.reserve(tree.refs.size());
+    tree.parents.reserve(tree.refs.size());
+    builder.build(0, static_cast<uint32_t>(tree.refs.size()), noNode, 0);
+    for (size_t i = 0; i < tree.refs.size(); i++) {
+        tree.refs[i] = builder.items[i].item;
+    }
+    tree.cost = computeCost(tree);
+    return tree;
+}
+
+float Bvh::computeCost(const Tree& tree) {
+    if (tree.nodes.empty()) {
+        return 0.0f;
+    }
+    float rootArea = Aabb{tree.nodes[0].boxMin, tree.nodes[0].boxMax}.halfArea();
+    if (rootArea <= 0.0f) {
+        return 0.0f;
+    }
+
+    float cost = 0.0f;
+    for (const auto& node : tree.nodes) {
+        float area = Aabb{node.boxMin, node.boxMax}.halfArea();
+        cost += area * (node.count > 0 ? static_cast<float>(node.count) : traversalCost);
+    }
+    return cost / rootArea;
+}
+
+void Bvh::install(Tree&& built) {
+    tree = std::move(built);
+
+    std::fill(leafOf.begin(), leafOf.end(), noNode);
+    removedInTree = 0;
+    for (uint32_t node = 0; node < tree.nodes.size(); node++) {
+        const auto& leaf = tree.nodes[node];
+        for (uint32_t i = leaf.first; leaf.count > 0 && i < leaf.first + leaf.count; i++) {
+            leafOf[tree.refs[i]] = node;
+            removedInTree += alive[tree.refs[i]] ? 0 : 1;
+        }
+    }
+
+    // added while the worker was building
+    loose.clear();
+    for (uint32_t item = 0; item < alive.size(); item++) {
+        if (alive[item] && leafOf[item] == noNode) {
+            loose.push_back(item);
+        }
+    }
+
+    moved.clear();
+    refitAll();
+    tree.cost         = computeCost(tree);
+    builtCost         = tree.cost;
+    updatesSinceBuild = 0;
+}
+
+// walk up until a box stays the same, the ones above it are still right
+void Bvh::refitLeaf(uint32_t node) {
+    Aabb        box{};
+    const auto& leaf = tree.nodes[node];
+    for (uint32_t i = leaf.first; i < leaf.first + leaf.count; i++) {
+        box.grow(boxes[tree.refs[i]]);
+    }
+
+    while (true) {
+        auto& current = tree.nodes[node];
+        if (current.boxMin == box.min && current.boxMax == box.max) {
+            return;
+        }
+        current.boxMin = box.min;
+        current.boxMax = box.max;
+
+        node = tree.parents[node];
+        if (node == noNode) {
+            return;
+        }
+        const auto& left  = tree.nodes[node + 1];
+        const auto& right = tree.nodes[tree.nodes[node].first];
+        box = {glm::min(left.boxMin, right.boxMin), glm::max(left.boxMax, right.boxMax)};
+    }
+}
+
+// children come after their parent, so a backwards pass sees them first
+void Bvh::refitAll() {
+    for (size_t node = tree.nodes.size(); node-- > 0;) {
+        auto& current = tree.nodes[node];
+        Aabb  box{};
+        if (current.count > 0) {
+            for (uint32_t i = current.first; i < current.first + current.count; i++) {
+                box.grow(boxes[tree.refs[i]]);
+            }
+        } else {
+            const auto& left  = tree.nodes[node + 1];
+            const auto& right = tree.nodes[current.first];
+            box = {glm::min(left.boxMin, right.boxMin), glm::max(left.boxMax, right.boxMax)};
+        }
+        current.boxMin = box.min;
+        current.boxMax = box.max;
+    }
+}
+
+void Bvh::queryFrustum(const FrustumPlanes& planes, std::vector<uint32_t>& items) const {
+    for (auto item : loose) {
+        if (aabbInFrustum(planes, boxes[item]) != Containment::eOutside) {
+            items.push_back(item);
+        }
+    }
+    if (tree.nodes.empty()) {
+        return;
+    }
+    // serial, the query runs every frame and is cheaper than handing subtrees to threads
+    collectFrustum(0, planes, items);
+}
+
+void Bvh::collectFrustum(uint32_t               root,
+                         const FrustumPlanes&   planes,
+                         std::vector<uint32_t>& items) const {
+    std::array<uint32_t, maxDepth + 2> stack{};
+    size_t                             top = 0;
+    stack[top++]                           = root;
+    while (top > 0) {
+        auto        index = stack[--top];
+        const auto& node  = tree.nodes[index];
+        auto        test  = aabbInFrustum(planes, {node.boxMin, node.boxMax});
+        if (test == Containment::eOutside) {
+            continue;
+        }
+        if (test == Containment::eInside) {
+            collectSubtree(index, items);
+        } else if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                auto item = tree.refs[i];
+                if (alive[item] && aabbInFrustum(planes, boxes[item]) != Containment::eOutside) {
+                    items.push_back(item);
+                }
+            }
+        } else {
+            stack[top++] = node.first;
+            stack[top++] = index + 1;
+        }
+    }
+}
+
+// the references of a subtree run from the first of its leftmost leaf to its rightmost leaf
+void Bvh::collectSubtree(uint32_t root, std::vector<uint32_t>& items) const {
+    uint32_t leftmost = root, rightmost = root;
+    while (tree.nodes[leftmost].count == 0) {
+        leftmost++;
+    }
+    while (tree.nodes[rightmost].count == 0) {
+        rightmost = tree.nodes[rightmost].first;
+    }
+
+    uint32_t end = tree.nodes[rightmost].first + tree.nodes[rightmost].count;
+    for (uint32_t i = tree.nodes[leftmost].first; i < end; i++) {
+        if (alive[tree.refs[i]]) {
+            items.push_back(tree.refs[i]);
+        }
+    }
+}
+
+void Bvh::queryAabb(const Aabb& box, std::vector<uint32_t>& items) const {
+    for (auto item : loose) {
+        if (boxes[item].overlaps(box)) {
+            items.push_back(item);
+        }
+    }
+    if (tree.nodes.empty()) {
+        return;
+    }
+
+    std::array<uint32_t, maxDepth + 2> stack{};
+    size_t                             top = 0;
+    stack[top++]                           = 0;
+    while (top > 0) {
+        auto        index = stack[--top];
+        const auto& node  = tree.nodes[index];
+        if (!Aabb{node.boxMin, node.boxMax}.overlaps(box)) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                auto item = tree.refs[i];
+                if (alive[item] && boxes[item].overlaps(box)) {
+                    items.push_back(item);
+                }
+            }
+        } else {
+            stack[top++] = node.first;
+            stack[top++] = index + 1;
+        }
+    }
+}
+
+// the nearer child is visited first, so the hits found early cut off most of the far subtrees
+BvhHit Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
+    glm::vec3 invDirection = 1.0f / direction;
+
+    BvhHit hit{};
+    float  nearest  = maxDistance;
+    auto   testItem = [&](uint32_t item) {
+        float distance = intersectRay(origin, invDirection, boxes[item], nearest);
+        if (distance >= 0.0f && (hit.item == UINT32_MAX || distance < nearest)) {
+            nearest = distance;
+            hit     = {item, distance};
+        }
+    };
+    auto getBox = [this](uint32_t node) {
+        return Aabb{tree.nodes[node].boxMin, tree.nodes[node].boxMax};
+    };
+    for (auto item : loose) {
+        testItem(item);
+    }
+    if (tree.nodes.empty()) {
+        return hit;
+    }
+
+    std::array<uint32_t, maxDepth + 2> stack{};
+    size_t                             top = 0;
+    stack[top++]                           = 0;
+    while (top > 0) {
+        auto        index = stack[--top];
+        const auto& node  = tree.nodes[index];
+        if (intersectRay(origin, invDirection, getBox(index), nearest) < 0.0f) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                if (alive[tree.refs[i]]) {
+                    testItem(tree.refs[i]);
+                }
+            }
+            continue;
+        }
+
+        auto  closer = index + 1, further = node.first;
+        float tCloser  = intersectRay(origin, invDirection, getBox(closer), nearest);
+        float tFurther = intersectRay(origin, invDirection, getBox(further), nearest);
+        if (tFurther >= 0.0f && (tCloser < 0.0f || tFurther < tCloser)) {
+            std::swap(closer, further);
+            std::swap(tCloser, tFurther);
+        }
+        if (tFurther >= 0.0f) {
+            stack[top++] = further;
+        }
+        if (tCloser >= 0.0f) {
+            stack[top++] = closer;
+        }
+    }
+    return hit;
+}
+
+static double toUs(std::chrono::high_resolution_clock::duration duration) {
+    return std::chrono::duration<double, std::chrono::microseconds::period>(duration).count();
+}
+
+// the fastest of runs calls of func in us
+template <typename Func>
+static double timeBest(size_t runs, Func&& func) {
+    double best = std::numeric_limits<double>::max();
+    for (size_t run = 0; run < runs; run++) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        func();
+        best = std::min(best, toUs(std::chrono::high_resolution_clock::now() - startTime));
+    }
+    return best;
+}
+
+void Bvh::benchmark() {
+    // the same camera and cube of objects as FrustumCuller::benchmark()
+    auto proj   = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    auto view   = glm::lookAt(
+        glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    auto planes = extractFrustumPlanes(proj * view);
+
+    std::mt19937                          random{20};
+    std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+    std::uniform_real_distribution<float> size{0.1f, 2.0f};
+    std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+
+    constexpr size_t rayCount = 256, boxCount = 256;
+    for (size_t objectCount : {size_t{10'000}, size_t{100'000}, size_t{1'000'000}}) {
+        std::vector<Aabb> objects(objectCount);
+        FrustumCuller     culler{};
+        culler.reset(objectCount);
+        for (size_t i = 0; i < objectCount; i++) {
+            glm::vec3 center = {position(random), position(random), position(random)};
+            glm::vec3 half   = glm::vec3(size(random), size(random), size(random)) * 0.5f;
+            objects[i]       = {center - half, center + half};
+            culler.set(i, glm::vec4(center, glm::length(half)));
+        }
+
+        Bvh  bvh{};
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < objectCount; i++) {
+            bvh.set(i, objects[i]);
+        }
+        bvh.rebuild();
+        double buildMs = toUs(std::chrono::high_resolution_clock::now() - startTime) / 1000.0;
+        logger->info("BVH of " + std::to_string(objectCount) + " boxes: " +
+                     std::to_string(bvh.tree.nodes.size()) + " nodes built in " +
+                     std::to_string(buildMs) + " ms, SAH cost " + std::to_string(bvh.tree.cost));
+
+        // frustum, against culling every sphere with the SIMD scan
+        std::vector<uint32_t> items{};
+        size_t                runs = std::max<size_t>(3, 1'000'000 / objectCount);
+
+        double treeUs = timeBest(runs, [&] {
+            items.clear();
+            bvh.queryFrustum(planes, items);
+        });
+        size_t treeFound = items.size();
+        double scanUs    = timeBest(runs, [&] { culler.cull(planes, items); });
+        logger->info("  frustum: BVH " + std::to_string(treeUs) + " us, scan " +
+                     std::to_string(scanUs) + " us, " + std::to_string(treeFound) + " and " +
+                     std::to_string(items.size()) + " visible");
+
+        // rays from the middle, against testing every box
+        std::vector<glm::vec3> directions(rayCount);
+        for (auto& direction : directions) {
+            direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+        }
+        size_t treeHits = 0, scanHits = 0;
+        treeUs = timeBest(3, [&] {
+            treeHits = 0;
+            for (const auto& direction : directions) {
+                treeHits += bvh.raycast(glm::vec3(0.0f), direction).item != UINT32_MAX;
+            }
+        });
+        scanUs = timeBest(1, [&] {
+            for (const auto& direction : directions) {
+                glm::vec3 invDirection = 1.0f / direction;
+                float     nearest      = FLT_MAX;
+                for (const auto& object : objects) {
+                    float distance = intersectRay(glm::vec3(0.0f), invDirection, object, nearest);
+                    nearest        = distance >= 0.0f ? distance : nearest;
+                }
+                scanHits += nearest < FLT_MAX;
+            }
+        });
+        logger->info("  ray: BVH " + std::to_string(treeUs / rayCount) + " us, scan " +
+                     std::to_string(scanUs / rayCount) + " us, " + std::to_string(treeHits) +
+                     " and " + std::to_string(scanHits) + " hits");
+
+        // boxes a tenth of the cube wide, against testing every box
+        std::vector<Aabb> queries(boxCount);
+        for (auto& query : queries) {
+            glm::vec3 center = {position(random), position(random), position(random)};
+            query            = {center - glm::vec3(10.0f), center + glm::vec3(10.0f)};
+        }
+        treeUs = timeBest(3, [&] {
+            items.clear();
+            for (const auto& query : queries) {
+                bvh.queryAabb(query, items);
+            }
+        });
+        treeFound = items.size();
+        scanUs    = timeBest(1, [&] {
+            items.clear();
+            for (const auto& query : queries) {
+                for (uint32_t i = 0; i < objectCount; i++) {
+                    if (objects[i].overlaps(query)) {
+                        items.push_back(i);
+                    }
+                }
+            }
+        });
+        logger->info("  box: BVH " + std::to_string(treeUs / boxCount) + " us, scan " +
+                     std::to_string(scanUs / boxCount) + " us, " + std::to_string(treeFound) +
+                     " and " + std::to_string(items.size()) + " overlaps");
+
+        // a hundredth of the objects moves a little every update
+        treeUs = timeBest(3, [&] {
+            for (uint32_t i = 0; i < objectCount; i += 100) {
+                objects[i].min += glm::vec3(0.1f);
+                objects[i].max += glm::vec3(0.1f);
+                bvh.set(i, objects[i]);
+            }
+            bvh.update();
+        });
+        logger->info("  refit of " + std::to_string(objectCount / 100) + " moved boxes: " +
+                     std::to_string(treeUs) + " us");
+    }
+}
+
+} // namespace TBE::Math
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "TBEngine/core/math/aabb/aabb.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace TBE::Utils {
+class ThreadPool;
+}
+
+namespace TBE::Math {
+
+// depth first, the left child of an inner node is the node right after it
+struct BvhNode {
+    glm::vec3 boxMin{};
+    uint32_t  first{}; // the first item reference of a leaf, the right child of an inner node
+    glm::vec3 boxMax{};
+    uint32_t  count{}; // item references of a leaf, 0 for an inner node
+};
+static_assert(sizeof(BvhNode) == 32);
+
+struct BvhHit {
+    uint32_t item = UINT32_MAX; // UINT32_MAX if nothing was hit
+    float    distance{};
+};
+
+/**
+ * @brief Bounding volume hierarchy over the boxes of items with small integer ids.
+ *
+ * @details The tree is built top down with binned SAH splits and kept as one flat array of 32
+ * byte nodes in depth first order. Moving an item only refits the boxes on the path from its
+ * leaf to the root in update(), so the tree keeps working but slowly gets worse. Items added
+ * since the last build are kept in a loose list every query scans, removed ones keep an empty box
+ * in their leaf. Once the loose or removed items pile up, the SAH cost has grown by half or a
+ * while has passed with items moving, update() builds a new tree, on a worker thread when the
+ * scene is large, and swaps it in on a later update(). Frustum queries of large trees split the
+ * subtrees over worker threads.
+ */
+class Bvh {
+public:
+    Bvh();
+    ~Bvh();
+
+    Bvh(const Bvh&)            = delete;
+    Bvh& operator=(const Bvh&) = delete;
+
+public:
+    // add the item or move it to box
+    void set(uint32_t item, const Aabb& box);
+    void remove(uint32_t item);
+    void clear();
+
+    // refit the moved items and start or take a rebuild, once per frame before the queries
+    void update();
+    // build the tree of every item on the calling thread
+    void rebuild();
+
+public:
+    // items are appended in no particular order
+    void queryFrustum(const FrustumPlanes& planes, std::vector<uint32_t>& items) const;
+    void queryAabb(const Aabb& box, std::vector<uint32_t>& items) const;
+    // the item whose box the ray enters first
+    BvhHit raycast(const glm::vec3& origin,
+                   const glm::vec3& direction,
+                   float            maxDistance = FLT_MAX) const;
+
+    size_t size() const { return itemCount; }
+
+public:
+    // log the queries against scanning every item, for 10k to 1M random boxes
+    static void benchmark();
+
+private:
+    struct Tree {
+        std::vector<BvhNode>  nodes{};
+        std::vector<uint32_t> refs{};    // the items of the leaves
+        std::vector<uint32_t> parents{}; // per node, UINT32_MAX for the root
+        float                 cost{};    // SAH cost relative to the root box
+    };
+
+    // shared with the worker, which may still run when the tree is cleared or destructed
+    struct PendingBuild {
+        Tree              tree{};
+        std::atomic<bool> done = false;
+    };
+
+private:
+    static Tree buildTree(std::vector<uint32_t> items, const std::vector<Aabb>& boxes);
+    static float computeCost(const Tree& tree);
+
+    void startRebuild();
+    void install(Tree&& built);
+    void refitLeaf(uint32_t node);
+    void refitAll();
+
+    void collectFrustum(uint32_t               root,
+                        const FrustumPlanes&   planes,
+                        std::vector<uint32_t>& items) const;
+    void collectSubtree(uint32_t root, std::vector<uint32_t>& items) const;
+
+private:
+    Tree tree{};
+
+    std::vector<Aabb>     boxes{};  // per item id, empty for removed ones
+    std::vector<uint32_t> leafOf{}; // per item id, the leaf referencing it or UINT32_MAX
+    std::vector<uint8_t>  alive{};
+    std::vector<uint32_t> loose{};  // added since the tree was built
+    std::vector<uint32_t> moved{};  // leaves to refit, may hold duplicates
+    size_t                itemCount{};
+    size_t                removedInTree{};
+    float                 builtCost{}; // tree.cost right after the build
+    uint32_t              updatesSinceBuild{};
+    bool                  changedSinceBuild = false;
+
+    std::shared_ptr<PendingBuild>      pending{};
+    std::unique_ptr<Utils::ThreadPool> worker{}; // created by the first background build
+};
+
+} // namespace TBE::Math
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "TBEngine/utils/includes/includeGLM.hpp"
+#include "TBEngine/utils/hash/hash.hpp"
+
+#include <array>
+#include <cstdint>
 
 namespace TBE::Math::DataFormat {
 
@@ -16,11 +20,125 @@ struct Vertex {
     }
 };
 
-struct UniformBufferObject {
-    alignas(16) glm::mat4 model{};
+// hash of the raw component bits, -0.0 is folded into +0.0 so that equal vertices hash equally
+inline uint64_t hashVertex(const Vertex& vertex) {
+    std::array<float, 8> key = {vertex.pos.x,
+                                vertex.pos.y,
+                                vertex.pos.z,
+                                vertex.color.x,
+                                vertex.color.y,
+                                vertex.color.z,
+                                vertex.texCoord.x,
+                                vertex.texCoord.y};
+    for (auto& component : key) {
+        component += 0.0f;
+    }
+    return Utils::hashBytes(key.data(), sizeof(key));
+}
+
+// vertex layouts a mesh can be uploaded with, each one gets its own pipeline
+enum class VertexLayout : uint32_t
+{
+    eFloat,  // Vertex, full precision floats
+    ePacked, // PackedVertex, quantized against the bounds of the mesh
+};
+constexpr size_t vertexLayoutCount = 2;
+
+// 12 bytes per vertex, snorm16 position and unorm16 uv relative to MeshQuantization
+struct PackedVertex {
+    std::array<int16_t, 4>  pos{}; // w is padding, 3 component 16 bit formats are rarely supported
+    std::array<uint16_t, 2> texCoord{};
+};
+static_assert(sizeof(PackedVertex) == 12);
+
+constexpr uint32_t getVertexStride(VertexLayout layout) {
+    return layout == VertexLayout::ePacked ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+// part of DrawData, turns the normalized attributes of a packed vertex back into model space
+// identity for VertexLayout::eFloat
+struct MeshQuantization {
+    glm::vec4 posScale{1.0f, 1.0f, 1.0f, 0.0f};
+    glm::vec4 posOffset{0.0f};
+    glm::vec4 uvScaleOffset{1.0f, 1.0f, 0.0f, 0.0f}; // xy scale, zw offset
+};
+static_assert(sizeof(MeshQuantization) == 48);
+
+// levels of detail a mesh can have, the full mesh included
+constexpr uint32_t maxLodCount = 5;
+
+// a level of detail, a range of the index blob that draws the same vertices with fewer triangles
+struct MeshLod {
+    uint32_t firstIndex{};
+    uint32_t indexCount{};
+    float    error{}; // how far the surface moved from the full mesh at most, in model space
+};
+
+// a cluster of the full mesh, a contiguous run of its triangles that is culled on its own
+struct Meshlet {
+    glm::vec4 sphere{}; // model space, xyz center and w radius
+    glm::vec4 cone{};   // xyz the axis the triangles face along, w the cutoff, 1 if it never culls
+    uint32_t  firstIndex{};
+    uint32_t  indexCount{};
+    uint32_t  vertexCount{};
+    uint32_t  padding{};
+};
+static_assert(sizeof(Meshlet) == 48);
+
+// describe the vertex and index blobs of a mesh
+struct MeshDesc {
+    VertexLayout     vertexLayout = VertexLayout::eFloat;
+    uint32_t         idxStride    = sizeof(IdxType); // 2 or 4
+    size_t           idxCount{};                     // of every level together
+    MeshQuantization quantization{};
+    glm::vec4        bounds{}; // model space sphere, xyz center and w radius
+    glm::vec3        boxMin{}; // model space bounding box
+    glm::vec3        boxMax{};
+    uint32_t         lodCount = 1; // lods[0] is the full mesh, the others have fewer triangles
+    std::array<MeshLod, maxLodCount> lods{};
+};
+
+// once per frame, a dynamic uniform buffer in the frame ring
+struct FrameData {
     alignas(16) glm::mat4 view{};
     alignas(16) glm::mat4 proj{};
+    alignas(16) std::array<glm::vec4, 6> frustum{}; // Math::FrustumPlanes of proj * view
+};
+
+// once per drawn instance, an array in the frame ring the vertex shader reads at gl_InstanceIndex
+struct ObjectData {
+    alignas(16) glm::mat4 model{1.0f};
+    alignas(16) glm::vec4 tint{1.0f}; // multiplies the sampled color
+    uint32_t slot = UINT32_MAX;       // the model slot, UINT32_MAX for the room between two slots
+    uint32_t lod{};                   // the level of detail it is drawn with, set every frame
+    uint32_t cluster = UINT32_MAX;    // its ClusterInstance when its meshlets are culled one by one
+};
+static_assert(sizeof(ObjectData) == 96);
+
+// once per instance whose meshlets are culled one by one, an array in the frame ring
+struct ClusterInstance {
+    glm::vec4 eye{};    // the camera in the model space of the instance, w unused
+    uint32_t  object{}; // its ObjectData, counted from the start of the frame ring
+    uint32_t  id{};     // the id slot every meshlet of it is drawn with as firstInstance
+    uint32_t  padding0{};
+    uint32_t  padding1{};
+};
+static_assert(sizeof(ClusterInstance) == 32);
+
+// once per model slot, what the culling pass and the vertex shader need of its mesh
+struct DrawData {
+    MeshQuantization quantization{};
+    glm::vec4        bounds{};
+    uint32_t         command = UINT32_MAX; // the first indirect command of the slot, one per level
+    uint32_t         pool{};               // the geometry pool the mesh lives in
+    uint32_t         poolFirst{};          // the first packed command of that pool
+    uint32_t         lodCount{};           // commands of the slot
+    uint32_t         firstMeshlet{};       // in the meshlet buffer of the geometry pools
+    uint32_t         meshletCount{};       // 0 if the mesh has none
+    uint32_t         texture{};            // its element in the texture table
+    uint32_t         padding0{};
 };
+static_assert(sizeof(DrawData) == 96);
 
 } // namespace TBE::Math::DataFormat
 
@@ -28,8 +146,7 @@ namespace std {
 template <>
 struct hash<TBE::Math::DataFormat::Vertex> {
     size_t operator()(TBE::Math::DataFormat::Vertex const& vertex) const {
-        return ((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-               (hash<glm::vec2>()(vertex.texCoord) << 1);
+        return static_cast<size_t>(TBE::Math::DataFormat::hashVertex(vertex));
     }
 };
 } // namespace std
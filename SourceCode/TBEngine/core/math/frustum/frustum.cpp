@@ -0,0 +1,49 @@
+#include "frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TBE::Math {
+
+FrustumPlanes extractFrustumPlanes(const glm::mat4& viewProj) {
+    // rows of the matrix, glm stores columns
+    auto row = [&viewProj](int i) {
+        return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+    };
+    FrustumPlanes planes = {row(3) + row(0),
+                            row(3) - row(0),
+                            row(3) + row(1),
+                            row(3) - row(1),
+                            row(2), // GLM_FORCE_DEPTH_ZERO_TO_ONE
+                            row(3) - row(2)};
+    for (auto& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return planes;
+}
+
+glm::vec4 transformSphere(const glm::mat4& model, const glm::vec4& sphere) {
+    glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+    float     scale  = std::sqrt(std::max({glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                           glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                           glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))}));
+    return glm::vec4(center, sphere.w * scale);
+}
+
+bool sphereInFrustum(const FrustumPlanes& planes, const glm::vec4& sphere) {
+    for (const auto& plane : planes) {
+        if (glm::dot(glm::vec3(plane), glm::vec3(sphere)) + plane.w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the eye has to be outside the cone of view directions that see a front face somewhere in the
+// sphere, which the radius widens
+bool meshletBackfacing(const glm::vec4& sphere, const glm::vec4& cone, const glm::vec3& eye) {
+    auto toCenter = glm::vec3(sphere) - eye;
+    return glm::dot(toCenter, glm::vec3(cone)) >= cone.w * glm::length(toCenter) + sphere.w;
+}
+
+} // namespace TBE::Math
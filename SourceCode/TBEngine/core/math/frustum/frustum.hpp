@@ -0,0 +1,25 @@
+#pragma once
+
+#include "TBEngine/utils/includes/includeGLM.hpp"
+
+#include <array>
+
+namespace TBE::Math {
+
+// spheres are xyz center and w radius, planes are xyz normal pointing inwards and w distance
+using FrustumPlanes = std::array<glm::vec4, 6>;
+
+// left, right, bottom, top, near, far of a projection with depth in 0..1, normalized
+FrustumPlanes extractFrustumPlanes(const glm::mat4& viewProj);
+
+// the sphere around the transformed sphere, scaled by the largest axis of model
+glm::vec4 transformSphere(const glm::mat4& model, const glm::vec4& sphere);
+
+// false only if the sphere is completely outside one of the planes
+bool sphereInFrustum(const FrustumPlanes& planes, const glm::vec4& sphere);
+
+// true if the eye is behind every triangle of a meshlet, sphere and cone as in
+// Math::DataFormat::Meshlet, everything in the model space of the meshlet
+bool meshletBackfacing(const glm::vec4& sphere, const glm::vec4& cone, const glm::vec3& eye);
+
+} // namespace TBE::Math
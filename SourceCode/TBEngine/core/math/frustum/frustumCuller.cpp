@@ -0,0 +1,239 @@
+#include "frustumCuller.hpp"
+#include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/utils/simd/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cfloat>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <string>
+
+extern const TBE::Utils::Log::Logger* logger;
+
+namespace TBE::Math {
+
+static constexpr size_t batchSize = 8; // the arrays are padded to whole AVX2 batches
+
+// the padding and the spheres not set yet, their test against any plane fails
+static constexpr float noRadius = -FLT_MAX;
+
+struct SphereArrays {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* r;
+    size_t       count; // padded
+};
+
+// every kernel writes the visible indices to the front of visible, which holds count of them,
+// and returns how many it wrote, the slots after them may be overwritten
+using CullFunc = size_t (*)(const SphereArrays&, const FrustumPlanes&, uint32_t*);
+
+// the same test as sphereInFrustum(), every index is written and only the visible ones counted
+static size_t cullScalar(const SphereArrays&  spheres,
+                         const FrustumPlanes& planes,
+                         uint32_t*            visible) {
+    size_t n = 0;
+    for (size_t i = 0; i < spheres.count; i++) {
+        bool inside = true;
+        for (const auto& plane : planes) {
+            float distance = plane.x * spheres.x[i] + plane.y * spheres.y[i] +
+                             plane.z * spheres.z[i] + plane.w;
+            inside = inside && !(distance < -spheres.r[i]);
+        }
+        visible[n] = static_cast<uint32_t>(i);
+        n += inside;
+    }
+    return n;
+}
+
+#if defined(TBE_SIMD_X86)
+
+static size_t cullSse(const SphereArrays& spheres, const FrustumPlanes& planes, uint32_t* visible) {
+    __m128 px[6]{}, py[6]{}, pz[6]{}, pw[6]{};
+    for (size_t p = 0; p < planes.size(); p++) {
+        px[p] = _mm_set1_ps(planes[p].x);
+        py[p] = _mm_set1_ps(planes[p].y);
+        pz[p] = _mm_set1_ps(planes[p].z);
+        pw[p] = _mm_set1_ps(planes[p].w);
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < spheres.count; i += 4) {
+        __m128 x    = _mm_loadu_ps(spheres.x + i);
+        __m128 y    = _mm_loadu_ps(spheres.y + i);
+        __m128 z    = _mm_loadu_ps(spheres.z + i);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.r + i));
+
+        int mask = 0xF;
+        for (size_t p = 0; p < planes.size(); p++) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, px[p]), _mm_mul_ps(y, py[p])),
+                                         _mm_add_ps(_mm_mul_ps(z, pz[p]), pw[p]));
+            mask &= _mm_movemask_ps(_mm_cmpnlt_ps(distance, negR));
+        }
+        auto bits = static_cast<uint32_t>(mask);
+        while (bits) {
+            visible[n++] = static_cast<uint32_t>(i + std::countr_zero(bits));
+            bits &= bits - 1;
+        }
+    }
+    return n;
+}
+
+// the lanes of every 8 bit mask that are set, moved to the front
+using CompactTable = std::array<std::array<uint32_t, batchSize>, 256>;
+
+static const CompactTable& getCompactTable() {
+    static const CompactTable table = [] {
+        CompactTable lanes{};
+        for (uint32_t mask = 0; mask < lanes.size(); mask++) {
+            uint32_t n = 0;
+            for (uint32_t lane = 0; lane < batchSize; lane++) {
+                if (mask & (1u << lane)) {
+                    lanes[mask][n++] = lane;
+                }
+            }
+        }
+        return lanes;
+    }();
+    return table;
+}
+
+// the indices of a batch are permuted by its mask and stored as a whole, then only the visible
+// ones are counted, which needs no branch per sphere
+TBE_TARGET_AVX2 static size_t cullAvx2(const SphereArrays&  spheres,
+                                       const FrustumPlanes& planes,
+                                       uint32_t*            visible) {
+    __m256 px[6]{}, py[6]{}, pz[6]{}, pw[6]{};
+    for (size_t p = 0; p < planes.size(); p++) {
+        px[p] = _mm256_set1_ps(planes[p].x);
+        py[p] = _mm256_set1_ps(planes[p].y);
+        pz[p] = _mm256_set1_ps(planes[p].z);
+        pw[p] = _mm256_set1_ps(planes[p].w);
+    }
+
+    const auto& compact = getCompactTable();
+    __m256i     indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i     step    = _mm256_set1_epi32(static_cast<int>(batchSize));
+
+    size_t n = 0;
+    for (size_t i = 0; i < spheres.count; i += batchSize) {
+        __m256 x    = _mm256_loadu_ps(spheres.x + i);
+        __m256 y    = _mm256_loadu_ps(spheres.y + i);
+        __m256 z    = _mm256_loadu_ps(spheres.z + i);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.r + i));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t p = 0; p < planes.size(); p++) {
+            __m256 distance = _mm256_fmadd_ps(
+                x, px[p], _mm256_fmadd_ps(y, py[p], _mm256_fmadd_ps(z, pz[p], pw[p])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negR, _CMP_NLT_UQ));
+        }
+
+        auto    mask  = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+        __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compact[mask].data()));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(visible + n),
+                            _mm256_permutevar8x32_epi32(indices, lanes));
+        n += std::popcount(mask);
+        indices = _mm256_add_epi32(indices, step);
+    }
+    return n;
+}
+
+#endif
+
+struct CullKernel {
+    const char* name;
+    CullFunc    cull;
+};
+
+// every kernel the CPU can run, the fastest last
+static std::vector<CullKernel> getCullKernels() {
+    std::vector<CullKernel> kernels = {{"scalar", cullScalar}};
+#if defined(TBE_SIMD_X86)
+    kernels.push_back({"SSE2", cullSse});
+    if (Utils::getCpuFeatures().avx2) {
+        kernels.push_back({"AVX2", cullAvx2});
+    }
+#endif
+    return kernels;
+}
+
+void FrustumCuller::reset(size_t sphereCount) {
+    size_t padded = (sphereCount + batchSize - 1) / batchSize * batchSize;
+    centerX.assign(padded, 0.0f);
+    centerY.assign(padded, 0.0f);
+    centerZ.assign(padded, 0.0f);
+    radius.assign(padded, noRadius);
+    count = sphereCount;
+}
+
+void FrustumCuller::set(size_t idx, const glm::vec4& sphere) {
+    centerX[idx] = sphere.x;
+    centerY[idx] = sphere.y;
+    centerZ[idx] = sphere.z;
+    radius[idx]  = sphere.w;
+}
+
+void FrustumCuller::cull(const FrustumPlanes& planes, std::vector<uint32_t>& visible) const {
+    static const CullFunc kernel = getCullKernels().back().cull;
+
+    SphereArrays spheres{
+        centerX.data(), centerY.data(), centerZ.data(), radius.data(), centerX.size()};
+    visible.resize(spheres.count);
+    visible.resize(kernel(spheres, planes, visible.data()));
+}
+
+static double toNs(std::chrono::high_resolution_clock::duration duration) {
+    return std::chrono::duration<double, std::chrono::nanoseconds::period>(duration).count();
+}
+
+void FrustumCuller::benchmark() {
+    // a camera in the middle of a cube of spheres, about one in twenty of them is visible
+    auto proj   = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    auto view   = glm::lookAt(
+        glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    auto planes = extractFrustumPlanes(proj * view);
+
+    std::mt19937                          random{19};
+    std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+    std::uniform_real_distribution<float> size{0.1f, 2.0f};
+
+    auto kernels = getCullKernels();
+    for (size_t objectCount : {size_t{10'000}, size_t{100'000}, size_t{1'000'000}}) {
+        FrustumCuller culler{};
+        culler.reset(objectCount);
+        for (size_t i = 0; i < objectCount; i++) {
+            float x = position(random), y = position(random), z = position(random);
+            culler.set(i, glm::vec4(x, y, z, size(random)));
+        }
+
+        SphereArrays spheres{culler.centerX.data(),
+                             culler.centerY.data(),
+                             culler.centerZ.data(),
+                             culler.radius.data(),
+                             culler.centerX.size()};
+        std::vector<uint32_t> visible(spheres.count);
+
+        // every kernel culls about ten million spheres, the fastest run counts
+        size_t runs = std::max<size_t>(10'000'000 / objectCount, 3);
+        for (const auto& kernel : kernels) {
+            double bestNs       = std::numeric_limits<double>::max();
+            size_t visibleCount = 0;
+            for (size_t run = 0; run < runs; run++) {
+                auto startTime = std::chrono::high_resolution_clock::now();
+                visibleCount   = kernel.cull(spheres, planes, visible.data());
+                auto endTime   = std::chrono::high_resolution_clock::now();
+                bestNs         = std::min(bestNs, toNs(endTime - startTime));
+            }
+            logger->info("frustum culling " + std::to_string(objectCount) + " spheres, " +
+                         kernel.name + ": " + std::to_string(objectCount / bestNs) +
+                         " objects/ns, " + std::to_string(visibleCount) + " visible");
+        }
+    }
+}
+
+} // namespace TBE::Math
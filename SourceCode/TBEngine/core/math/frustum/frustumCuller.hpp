@@ -0,0 +1,42 @@
+#pragma once
+
+#include "frustum.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TBE::Math {
+
+/**
+ * @brief World space bounding spheres kept as structure of arrays and culled in batches.
+ *
+ * @details The centers and radii live in four float arrays padded to a multiple of eight, so a
+ * batch of spheres is tested against every plane with a few vector instructions, eight per
+ * iteration on AVX2, four on SSE2 and one at a time elsewhere. Spheres that were never set and
+ * the padding have a radius of -FLT_MAX and are never visible. The visible ones come out
+ * as a compact list of indices in increasing order, the same ones sphereInFrustum() keeps.
+ */
+class FrustumCuller {
+public:
+    // count spheres, none of them visible until set
+    void reset(size_t sphereCount);
+    void set(size_t idx, const glm::vec4& sphere);
+    size_t size() const { return count; }
+
+    // replace visible with the indices of the spheres that are not outside a plane
+    void cull(const FrustumPlanes& planes, std::vector<uint32_t>& visible) const;
+
+public:
+    // log objects per nanosecond of every kernel the CPU has, for 10k to 1M random spheres
+    static void benchmark();
+
+private:
+    std::vector<float> centerX{};
+    std::vector<float> centerY{};
+    std::vector<float> centerZ{};
+    std::vector<float> radius{};
+    size_t             count{};
+};
+
+} // namespace TBE::Math
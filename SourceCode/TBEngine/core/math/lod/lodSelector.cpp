@@ -0,0 +1,46 @@
+#include "lodSelector.hpp"
+#include "TBEngine/core/math/frustum/frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TBE::Math {
+
+void LodSelector::setView(const glm::mat4& view,
+                          const glm::mat4& proj,
+                          float            screenHeight,
+                          float            pixelError,
+                          float            hysteresis) {
+    eye = glm::vec3(glm::inverse(view)[3]);
+    // proj[1][1] is the cotangent of half the vertical field of view, negative for Vulkan
+    errorScale   = std::abs(proj[1][1]) * screenHeight * 0.5f / std::max(pixelError, 1e-3f);
+    coarsenLimit = 1.0f - std::clamp(hysteresis, 0.0f, 0.9f);
+}
+
+uint32_t LodSelector::select(std::span<const DataFormat::MeshLod> lods,
+                             const glm::mat4&                     model,
+                             const glm::vec4&                     bounds,
+                             uint32_t                             current) const {
+    if (lods.size() <= 1) {
+        return 0;
+    }
+
+    // the eye inside the sphere gets the full mesh
+    auto  sphere   = transformSphere(model, bounds);
+    float distance = glm::length(glm::vec3(sphere) - eye) - sphere.w;
+    if (distance <= 0.0f) {
+        return 0;
+    }
+    float scale    = bounds.w > 0.0f ? sphere.w / bounds.w : 1.0f;
+    auto  onScreen = [&](uint32_t lod) { return lods[lod].error * scale * errorScale / distance; };
+    auto  lod      = std::min(current, static_cast<uint32_t>(lods.size() - 1));
+    while (lod > 0 && onScreen(lod) > 1.0f) {
+        lod--;
+    }
+    while (lod + 1 < lods.size() && onScreen(lod + 1) <= coarsenLimit) {
+        lod++;
+    }
+    return lod;
+}
+
+} // namespace TBE::Math
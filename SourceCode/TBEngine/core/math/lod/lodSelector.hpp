@@ -0,0 +1,39 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+
+namespace TBE::Math {
+
+/**
+ * @brief Picks the level of detail of an instance from how large its error is on the screen.
+ *
+ * @details The error of a level is projected at the point of the bounding sphere nearest to the
+ * eye, a level is good enough while that covers at most pixelError pixels. Switching has some
+ * hysteresis: a coarser level is only taken once its error is below the limit by the margin, a
+ * finer one as soon as the current level is above it, so an instance resting right at a limit
+ * does not pop between two levels every frame.
+ */
+class LodSelector {
+public:
+    // once per frame, screenHeight in pixels, hysteresis is the margin as a fraction of pixelError
+    void setView(const glm::mat4& view,
+                 const glm::mat4& proj,
+                 float            screenHeight,
+                 float            pixelError,
+                 float            hysteresis);
+
+    // the level to draw the instance with, current is the one it was drawn with last time
+    uint32_t select(std::span<const DataFormat::MeshLod> lods,
+                    const glm::mat4&                     model,
+                    const glm::vec4&                     bounds,
+                    uint32_t                             current) const;
+
+private:
+    glm::vec3 eye{};
+    float     errorScale{}; // error over distance times this is the error in units of pixelError
+    float     coarsenLimit{};
+};
+
+} // namespace TBE::Math
@@ -1,6 +1,8 @@
 #include "editor.hpp"
 #include "imgui.h"
 
+#include <algorithm>
+
 namespace TBE::Editor {
 using TBE::Editor::DelegateManager::KeyStateMap;
 
@@ -41,6 +43,22 @@ void Editor::tickCPU() {
     if (keyMap != (KeyStateMap)KeyBit::eNull) { // key on capture list is pressed
         boardcast(keyMap);
     }
+
+    // the mouse goes to the scene only while it is not over a window of the ui
+    const auto& io = ImGui::GetIO();
+    if (io.WantCaptureMouse || !ImGui::IsMousePosValid()) {
+        return;
+    }
+    // imgui reports the cursor in window coordinates, the scene works in framebuffer pixels
+    auto x = std::max(0.0f, io.MousePos.x * io.DisplayFramebufferScale.x);
+    auto y = std::max(0.0f, io.MousePos.y * io.DisplayFramebufferScale.y);
+    boardcast(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+    if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+        boardcast(false);
+    }
+    if (ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
+        boardcast(true);
+    }
 }
 
 } // namespace TBE::Editor
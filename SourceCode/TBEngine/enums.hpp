@@ -9,6 +9,7 @@ enum class ShaderType
     eUnknown = 0,
     eVertex,
     eFrag,
+    eCompute, // not part of the graphics pipeline, see ShaderInterface::computeStageInfos
 };
 
 enum class InputType
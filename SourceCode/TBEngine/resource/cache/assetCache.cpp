@@ -0,0 +1,192 @@
+#include "assetCache.hpp"
+#include "TBEngine/settings.hpp"
+#include "TBEngine/utils/hash/hash.hpp"
+#include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/utils/mappedFile/mappedFile.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace TBE::Resource::Cache {
+
+using KindStrings = std::array<const char*, assetKindCount>;
+
+static constexpr KindStrings kindDirs  = {"mesh", "texture"};
+static constexpr KindStrings kindExts  = {".tbmesh", ".tbtex"};
+static constexpr KindStrings kindNames = {"meshes", "textures"};
+
+static constexpr const char* indexFileName = "index.txt";
+
+static std::string toHex(uint64_t value) {
+    char buffer[17]{};
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+    return buffer;
+}
+
+AssetCache::AssetCache() : root(ASSET_CACHE_DIR) {
+    std::error_code ec{};
+    std::filesystem::create_directories(root, ec);
+    if (ec) {
+        logger->warn("failed to create the asset cache directory: " + root.string());
+    }
+    loadIndex();
+}
+
+std::filesystem::path AssetCache::getEntryPath(AssetKind                    kind,
+                                               const std::filesystem::path& source,
+                                               uint64_t                     settingsHash) {
+    std::error_code ec{};
+    if (!std::filesystem::is_regular_file(source, ec)) {
+        return {};
+    }
+    uint64_t contentHash = hashSource(source);
+
+    auto kindIdx = static_cast<size_t>(kind);
+    auto dir     = root / kindDirs[kindIdx];
+    std::filesystem::create_directories(dir, ec);
+
+    return dir / (toHex(contentHash) + toHex(settingsHash) + kindExts[kindIdx]);
+}
+
+void AssetCache::recordHit(AssetKind kind, const std::filesystem::path& entryPath, double loadMs) {
+    std::lock_guard lock(mutex);
+
+    auto& kindStats = stats[static_cast<size_t>(kind)];
+    kindStats.hits++;
+    if (auto it = importCosts.find(entryPath.filename().string()); it != importCosts.end()) {
+        kindStats.savedMs += std::max(it->second - loadMs, 0.0);
+    }
+}
+
+void AssetCache::recordMiss(AssetKind                    kind,
+                            const std::filesystem::path& entryPath,
+                            double                       importMs) {
+    std::lock_guard lock(mutex);
+
+    stats[static_cast<size_t>(kind)].misses++;
+    importCosts[entryPath.filename().string()] = importMs;
+    indexDirty                                 = true;
+}
+
+void AssetCache::report() {
+    std::lock_guard lock(mutex);
+
+    uint32_t hits = 0, misses = 0;
+    double   savedMs = 0.0;
+    for (size_t i = 0; i < assetKindCount; i++) {
+        const auto& kindStats = stats[i];
+        if (kindStats.hits + kindStats.misses == 0) {
+            continue;
+        }
+        logger->info(std::string("asset cache, ") + kindNames[i] + ": " +
+                     std::to_string(kindStats.hits) + " hits, " + std::to_string(kindStats.misses) +
+                     " misses, " + std::to_string(kindStats.savedMs) + " ms saved");
+        hits += kindStats.hits;
+        misses += kindStats.misses;
+        savedMs += kindStats.savedMs;
+    }
+    logger->info("asset cache: " + std::to_string(hits) + " hits, " + std::to_string(misses) +
+                 " misses, " + std::to_string(savedMs) + " ms saved in total");
+
+    if (indexDirty) {
+        saveIndex();
+    }
+}
+
+// the content hash is reused while the size and the write time of the source are unchanged
+// the lock is only held for the records, streaming workers hash their sources in parallel
+uint64_t AssetCache::hashSource(const std::filesystem::path& source) {
+    std::error_code ec{};
+    auto            key  = std::filesystem::absolute(source, ec).lexically_normal().string();
+    uint64_t        size = std::filesystem::file_size(source, ec);
+    int64_t writeTime    = std::filesystem::last_write_time(source, ec).time_since_epoch().count();
+
+    {
+        std::lock_guard lock(mutex);
+        if (auto it = sources.find(key); it != sources.end()) {
+            if (it->second.size == size && it->second.writeTime == writeTime) {
+                return it->second.contentHash;
+            }
+        }
+    }
+
+    uint64_t          contentHash = 0;
+    Utils::MappedFile file{};
+    if (file.open(source)) {
+        auto bytes  = file.bytes();
+        contentHash = Utils::hashBytes(bytes.data(), bytes.size());
+    }
+
+    std::lock_guard lock(mutex);
+    sources[key] = {size, writeTime, contentHash};
+    indexDirty   = true;
+    return contentHash;
+}
+
+// one record per line, paths go last so they can contain spaces
+// source <size> <write time> <content hash> <path>
+// cost <import ms> <entry file name>
+void AssetCache::loadIndex() {
+    std::ifstream in(root / indexFileName);
+    if (!in.is_open()) {
+        return;
+    }
+
+    std::string line{};
+    while (std::getline(in, line)) {
+        std::istringstream stream(line);
+        std::string        type{};
+        stream >> type;
+        if (type == "source") {
+            SourceRecord record{};
+            std::string  hash{}, path{};
+            stream >> record.size >> record.writeTime >> hash;
+            std::getline(stream >> std::ws, path);
+            if (stream.fail() || path.empty()) {
+                continue;
+            }
+            record.contentHash = std::stoull(hash, nullptr, 16);
+            sources[path]      = record;
+        } else if (type == "cost") {
+            double      ms{};
+            std::string name{};
+            stream >> ms;
+            std::getline(stream >> std::ws, name);
+            if (!name.empty()) {
+                importCosts[name] = ms;
+            }
+        }
+    }
+}
+
+void AssetCache::saveIndex() {
+    auto indexPath = root / indexFileName;
+    auto tmpPath   = indexPath;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out.is_open()) {
+            logger->warn("failed to save the asset cache index: " + indexPath.string());
+            return;
+        }
+        for (const auto& [path, record] : sources) {
+            out << "source " << record.size << ' ' << record.writeTime << ' '
+                << toHex(record.contentHash) << ' ' << path << '\n';
+        }
+        for (const auto& [name, ms] : importCosts) {
+            out << "cost " << ms << ' ' << name << '\n';
+        }
+    }
+
+    std::error_code ec{};
+    std::filesystem::rename(tmpPath, indexPath, ec);
+    if (ec) {
+        logger->warn("failed to save the asset cache index: " + ec.message());
+        return;
+    }
+    indexDirty = false;
+}
+
+} // namespace TBE::Resource::Cache
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace TBE::Resource::Cache {
+
+enum class AssetKind : uint32_t
+{
+    eMesh = 0, // cooked .tbmesh
+    eTexture,  // cooked .tbtex, RGBA8 with the whole mip chain
+};
+constexpr size_t assetKindCount = 2;
+
+/**
+ * @brief Content addressed cache of imported assets, singleton.
+ *
+ * @details An entry is named after the hash of the source bytes and the hash of the import
+ * settings, so editing, moving or re-importing a source with other settings never returns stale
+ * data. The content hash of a source is remembered together with its size and write time, an
+ * unchanged source is not hashed again on the next start.
+ * The import time of every entry is remembered too, report() uses it to estimate the time the
+ * hits saved.
+ */
+class AssetCache final {
+public:
+    static AssetCache& get() {
+        static AssetCache cache = AssetCache();
+        return cache;
+    }
+
+    AssetCache(const AssetCache&)            = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+private:
+    AssetCache();
+
+public:
+    // path of the entry holding the source imported with the settings, it might not exist yet
+    // empty if the source cannot be read
+    std::filesystem::path getEntryPath(AssetKind                    kind,
+                                       const std::filesystem::path& source,
+                                       uint64_t                     settingsHash);
+
+    // loadMs is the time spent on reading the entry
+    void recordHit(AssetKind kind, const std::filesystem::path& entryPath, double loadMs);
+    // importMs is the time spent on importing the source and writing the entry
+    void recordMiss(AssetKind kind, const std::filesystem::path& entryPath, double importMs);
+
+    // log hit and miss counts and the time saved, then save the index
+    void report();
+
+private:
+    struct SourceRecord {
+        uint64_t size{};
+        int64_t  writeTime{};
+        uint64_t contentHash{};
+    };
+
+    struct KindStats {
+        uint32_t hits{};
+        uint32_t misses{};
+        double   savedMs{};
+    };
+
+private:
+    uint64_t hashSource(const std::filesystem::path& source);
+    void     loadIndex();
+    void     saveIndex();
+
+private:
+    std::mutex                                    mutex{};
+    std::filesystem::path                         root{};
+    std::unordered_map<std::string, SourceRecord> sources{};
+    std::unordered_map<std::string, double>       importCosts{}; // entry file name -> ms
+    std::array<KindStats, assetKindCount>         stats{};
+    bool                                          indexDirty{};
+};
+
+} // namespace TBE::Resource::Cache
@@ -0,0 +1,168 @@
+#include "cookedMesh.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <fstream>
+#include <cstring>
+
+namespace TBE::Resource::File {
+
+using Math::DataFormat::MeshDesc;
+using Math::DataFormat::Meshlet;
+using Math::DataFormat::MeshQuantization;
+using Math::DataFormat::VertexLayout;
+
+static_assert(sizeof(MeshQuantization) == sizeof(CookedMeshHeader::quantization));
+static_assert(sizeof(MeshDesc::lods) == sizeof(CookedMeshHeader::lods));
+
+static constexpr uint64_t alignUp(uint64_t value) {
+    return (value + cookedMeshAlignment - 1) & ~(cookedMeshAlignment - 1);
+}
+
+// count elements of stride bytes at offset fit in size bytes, divides instead of multiplying so
+// that a corrupted header cannot overflow past the check, stride is not 0
+static constexpr bool fitsIn(uint64_t offset, uint64_t count, uint64_t stride, uint64_t size) {
+    return offset <= size && count <= (size - offset) / stride;
+}
+
+bool CookedMesh::open(const std::filesystem::path& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    auto bytes = file.bytes();
+    if (bytes.size() < sizeof(CookedMeshHeader)) {
+        logger->warn("cooked mesh too small: " + path.string());
+        close();
+        return false;
+    }
+
+    CookedMeshHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    const auto layout = static_cast<VertexLayout>(header.vertexLayout);
+
+    bool ok = header.magic == CookedMeshHeader::magicValue &&
+              header.version == CookedMeshHeader::versionValue &&
+              header.vertexLayout < Math::DataFormat::vertexLayoutCount &&
+              header.vertexStride == Math::DataFormat::getVertexStride(layout) &&
+              (header.indexStride == sizeof(uint16_t) || header.indexStride == sizeof(uint32_t)) &&
+              header.vertexOffset % cookedMeshAlignment == 0 &&
+              header.indexOffset % cookedMeshAlignment == 0 &&
+              fitsIn(header.vertexOffset, header.vertexCount, header.vertexStride, bytes.size()) &&
+              fitsIn(header.indexOffset, header.indexCount, header.indexStride, bytes.size()) &&
+              header.meshletOffset % cookedMeshAlignment == 0 &&
+              fitsIn(header.meshletOffset, header.meshletCount, sizeof(Meshlet), bytes.size()) &&
+              header.lodCount >= 1 && header.lodCount <= Math::DataFormat::maxLodCount;
+    // the products cannot overflow once the counts fit in the file
+    const uint64_t vertBytes    = ok ? header.vertexCount * header.vertexStride : 0;
+    const uint64_t idxBytes     = ok ? header.indexCount * header.indexStride : 0;
+    const uint64_t meshletBytes = ok ? header.meshletCount * sizeof(Meshlet) : 0;
+    if (ok) {
+        std::memcpy(meshDesc.lods.data(), header.lods.data(), sizeof(header.lods));
+        for (uint32_t lod = 0; lod < header.lodCount; lod++) {
+            const auto& range = meshDesc.lods[lod];
+            ok = ok && uint64_t{range.firstIndex} + range.indexCount <= header.indexCount;
+        }
+    }
+    if (ok) {
+        meshletsByte = bytes.subspan(header.meshletOffset, meshletBytes);
+        for (uint64_t i = 0; i < header.meshletCount; i++) {
+            Meshlet meshlet{};
+            std::memcpy(&meshlet, meshletsByte.data() + i * sizeof(Meshlet), sizeof(Meshlet));
+            ok = ok && uint64_t{meshlet.firstIndex} + meshlet.indexCount <= header.indexCount;
+        }
+    }
+    if (!ok) {
+        logger->warn("cooked mesh is stale or corrupted: " + path.string());
+        close();
+        return false;
+    }
+
+    verticesByte = bytes.subspan(header.vertexOffset, vertBytes);
+    indicesByte  = bytes.subspan(header.indexOffset, idxBytes);
+    flags        = header.flags;
+
+    meshDesc.vertexLayout = layout;
+    meshDesc.idxStride    = header.indexStride;
+    meshDesc.idxCount     = header.indexCount;
+    std::memcpy(&meshDesc.quantization, header.quantization.data(), sizeof(MeshQuantization));
+    meshDesc.bounds   = {header.bounds[0], header.bounds[1], header.bounds[2], header.bounds[3]};
+    meshDesc.boxMin   = {header.box[0], header.box[1], header.box[2]};
+    meshDesc.boxMax   = {header.box[3], header.box[4], header.box[5]};
+    meshDesc.lodCount = header.lodCount;
+    return true;
+}
+
+void CookedMesh::close() {
+    file.close();
+    verticesByte = {};
+    indicesByte  = {};
+    meshletsByte = {};
+    meshDesc     = {};
+    flags        = 0;
+}
+
+void CookedMesh::write(const std::filesystem::path& path,
+                       std::span<const std::byte>   verticesByte,
+                       std::span<const std::byte>   indicesByte,
+                       std::span<const std::byte>   meshletsByte,
+                       const MeshDesc&              meshDesc,
+                       uint32_t                     flags) {
+    CookedMeshHeader header{};
+    header.vertexStride = Math::DataFormat::getVertexStride(meshDesc.vertexLayout);
+    header.indexStride  = meshDesc.idxStride;
+    header.vertexCount  = verticesByte.size() / header.vertexStride;
+    header.indexCount   = meshDesc.idxCount;
+    header.vertexOffset = alignUp(sizeof(CookedMeshHeader));
+    header.indexOffset  = alignUp(header.vertexOffset + verticesByte.size());
+    header.flags        = flags;
+    header.vertexLayout = static_cast<uint32_t>(meshDesc.vertexLayout);
+    std::memcpy(header.quantization.data(), &meshDesc.quantization, sizeof(MeshQuantization));
+    header.bounds = {meshDesc.bounds.x, meshDesc.bounds.y, meshDesc.bounds.z, meshDesc.bounds.w};
+    header.box    = {meshDesc.boxMin.x,
+                     meshDesc.boxMin.y,
+                     meshDesc.boxMin.z,
+                     meshDesc.boxMax.x,
+                     meshDesc.boxMax.y,
+                     meshDesc.boxMax.z};
+    header.lodCount = meshDesc.lodCount;
+    std::memcpy(header.lods.data(), meshDesc.lods.data(), sizeof(header.lods));
+    header.meshletCount  = meshletsByte.size() / sizeof(Meshlet);
+    header.meshletOffset = alignUp(header.indexOffset + indicesByte.size());
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Utils::Log::logErrorMsg("failed to create cooked mesh: " + tmpPath.string());
+        }
+
+        const char zeros[cookedMeshAlignment]{};
+        auto       pad = [&out, &zeros](uint64_t target) {
+            auto cur = static_cast<uint64_t>(out.tellp());
+            out.write(zeros, static_cast<std::streamsize>(target - cur));
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad(header.vertexOffset);
+        out.write(reinterpret_cast<const char*>(verticesByte.data()),
+                  static_cast<std::streamsize>(verticesByte.size()));
+        pad(header.indexOffset);
+        out.write(reinterpret_cast<const char*>(indicesByte.data()),
+                  static_cast<std::streamsize>(indicesByte.size()));
+        pad(header.meshletOffset);
+        out.write(reinterpret_cast<const char*>(meshletsByte.data()),
+                  static_cast<std::streamsize>(meshletsByte.size()));
+
+        if (!out.good()) {
+            Utils::Log::logErrorMsg("failed to write cooked mesh: " + tmpPath.string());
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path);
+}
+
+} // namespace TBE::Resource::File
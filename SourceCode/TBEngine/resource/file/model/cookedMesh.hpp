@@ -0,0 +1,101 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+#include "TBEngine/utils/mappedFile/mappedFile.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace TBE::Resource::File {
+
+// file extension of the cooked binary mesh container
+inline constexpr std::string_view cookedMeshExt = ".tbmesh";
+
+// every blob in a cooked mesh starts at a multiple of this, so the mapped views can be used as
+// vertex / index arrays directly
+inline constexpr uint64_t cookedMeshAlignment = 64;
+
+/**
+ * @brief Header at the beginning of a .tbmesh file.
+ *
+ * @details Layout of the file:
+ * | header | padding | vertex blob | padding | index blob | padding | meshlet blob |
+ * The blobs are stored exactly as they are uploaded, in the recorded vertex layout and with 16 or
+ * 32 bit indices. The index blob holds every level of detail, lods records the range of each. The
+ * meshlet blob is empty unless the mesh was split into meshlets.
+ * The strides are recorded too, so a file cooked with another struct layout is rejected instead
+ * of misread.
+ */
+struct CookedMeshHeader {
+    static constexpr std::array<char, 4> magicValue   = {'T', 'B', 'M', 'S'};
+    static constexpr uint32_t            versionValue = 7;
+
+    // flags
+    static constexpr uint32_t flagVertexCacheOptimized = 1u << 0;
+
+    std::array<char, 4>   magic        = magicValue;
+    uint32_t              version      = versionValue;
+    uint32_t              vertexStride = sizeof(Math::DataFormat::Vertex);
+    uint32_t              indexStride  = sizeof(Math::DataFormat::IdxType);
+    uint64_t              vertexCount{};
+    uint64_t              indexCount{};
+    uint64_t              vertexOffset{};
+    uint64_t              indexOffset{};
+    uint32_t              flags{};
+    uint32_t              vertexLayout{}; // Math::DataFormat::VertexLayout
+    std::array<float, 12> quantization{}; // Math::DataFormat::MeshQuantization
+    std::array<float, 4>  bounds{};       // Math::DataFormat::MeshDesc::bounds
+    std::array<float, 6>  box{};          // MeshDesc::boxMin and boxMax
+
+    // MeshDesc::lodCount and lods, the first index, index count and error bits of every level
+    uint32_t                                                lodCount{};
+    std::array<uint32_t, 3 * Math::DataFormat::maxLodCount> lods{};
+
+    // Math::DataFormat::Meshlet, the ranges count from the start of the index blob
+    uint64_t meshletCount{};
+    uint64_t meshletOffset{};
+};
+static_assert(sizeof(CookedMeshHeader) == 224, "CookedMeshHeader is part of the file format");
+
+/**
+ * @brief A .tbmesh file mapped into memory.
+ *
+ * @details open() only validates the header, the vertex and index views point straight into the
+ * mapping, nothing is parsed or copied.
+ */
+class CookedMesh {
+public:
+    // return false if the file is missing, truncated or was cooked with another layout
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+public:
+    std::span<std::byte>              getVerticesByte() const { return verticesByte; }
+    std::span<std::byte>              getIndicesByte() const { return indicesByte; }
+    std::span<std::byte>              getMeshletsByte() const { return meshletsByte; }
+    const Math::DataFormat::MeshDesc& getMeshDesc() const { return meshDesc; }
+    uint32_t                          getFlags() const { return flags; }
+
+public:
+    // write a cooked mesh, the file is written beside the target and renamed when complete
+    static void write(const std::filesystem::path&      path,
+                      std::span<const std::byte>        verticesByte,
+                      std::span<const std::byte>        indicesByte,
+                      std::span<const std::byte>        meshletsByte,
+                      const Math::DataFormat::MeshDesc& meshDesc,
+                      uint32_t                          flags = 0);
+
+private:
+    Utils::MappedFile          file{};
+    std::span<std::byte>       verticesByte{};
+    std::span<std::byte>       indicesByte{};
+    std::span<std::byte>       meshletsByte{};
+    Math::DataFormat::MeshDesc meshDesc{};
+    uint32_t                   flags{};
+};
+
+} // namespace TBE::Resource::File
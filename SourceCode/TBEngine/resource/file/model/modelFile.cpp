@@ -1,5 +1,15 @@
 #include "modelFile.hpp"
+#include "objParser.hpp"
+#include "TBEngine/resource/mesh/weld/vertexWeld.hpp"
+#include "TBEngine/resource/mesh/optimize/meshOptimize.hpp"
+#include "TBEngine/resource/mesh/quantize/vertexQuantize.hpp"
+#include "TBEngine/resource/mesh/bounds/meshBounds.hpp"
+#include "TBEngine/resource/mesh/simplify/meshSimplify.hpp"
+#include "TBEngine/resource/mesh/meshlet/meshletBuilder.hpp"
+#include "TBEngine/resource/cache/assetCache.hpp"
+#include "TBEngine/utils/hash/hash.hpp"
 #include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/utils/mappedFile/mappedFile.hpp"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
@@ -7,63 +17,405 @@
 #include <string>
 #include <filesystem>
 #include <algorithm>
-#include <unordered_map>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
 
 namespace TBE::Resource::File {
 
 using Math::DataFormat::IdxType;
+using Math::DataFormat::PackedVertex;
 using Math::DataFormat::Vertex;
+using Math::DataFormat::VertexLayout;
 
 std::vector<std::string> ModelFile::supportedShaderTypes = {};
 
+template <typename T>
+static std::span<std::byte> toBytes(std::vector<T>& vec) {
+    return std::span<std::byte>(static_cast<std::byte*>(static_cast<void*>(vec.data())),
+                                vec.size() * sizeof(T));
+}
+
+template <typename T>
+static std::span<T> fromBytes(std::span<std::byte> bytes) {
+    return std::span<T>(static_cast<T*>(static_cast<void*>(bytes.data())),
+                        bytes.size() / sizeof(T));
+}
+
+static double toMs(std::chrono::high_resolution_clock::duration duration) {
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(duration).count();
+}
+
 ModelFile::ModelFile(std::string_view filePath_) : super(filePath_) {
     if (supportedShaderTypes.empty()) {
         supportedShaderTypes.emplace_back(".obj");
+        supportedShaderTypes.emplace_back(cookedMeshExt);
     }
     valid = checkPathValid();
 }
 
 void ModelFile::read() {
-    if (!vertices.empty()) {
+    if (!verticesByte.empty()) {
         logger->warn("Model data already exist.");
         return;
     }
 
+    if (filePath.extension() == cookedMeshExt) {
+        if (!readCooked(filePath)) {
+            Utils::Log::logErrorMsg("failed to read cooked mesh: " + filePath.string());
+        }
+        // there is no source to import again from
+        if (!matchesImportSettings()) {
+            logger->warn("cooked mesh was imported with other settings, using it as is: " +
+                         filePath.string());
+        }
+        return;
+    }
+
+    auto& cache     = Cache::AssetCache::get();
+    auto  startTime = std::chrono::high_resolution_clock::now();
+    auto  entryPath = cache.getEntryPath(Cache::AssetKind::eMesh, filePath, hashImportSettings());
+    if (!entryPath.empty() && std::filesystem::exists(entryPath) && readCooked(entryPath)) {
+        cache.recordHit(Cache::AssetKind::eMesh,
+                        entryPath,
+                        toMs(std::chrono::high_resolution_clock::now() - startTime));
+        return;
+    }
+
+    readObj();
+    if (importSettings.optimize) {
+        optimize();
+    }
+    generateLods();
+    buildMeshlets();
+    pack();
+
+    if (entryPath.empty()) {
+        return;
+    }
+    try {
+        CookedMesh::write(entryPath,
+                          verticesByte,
+                          indicesByte,
+                          meshletsByte,
+                          meshDesc,
+                          optimized ? CookedMeshHeader::flagVertexCacheOptimized : 0);
+        cache.recordMiss(Cache::AssetKind::eMesh,
+                         entryPath,
+                         toMs(std::chrono::high_resolution_clock::now() - startTime));
+        logger->info("cooked " + filePath.string() + " into " + entryPath.string());
+    } catch (const std::exception& e) {
+        logger->warn(std::string("failed to cook mesh, will parse the obj again next time: ") +
+                     e.what());
+    }
+}
+
+void ModelFile::free() {
+    vertices.clear();
+    indices.clear();
+    packedVertices.clear();
+    shortIndices.clear();
+    meshlets.clear();
+    cookedMesh.close();
+    verticesByte = {};
+    indicesByte  = {};
+    meshletsByte = {};
+    meshDesc     = {};
+    optimized    = false;
+}
+
+void ModelFile::optimize() {
+    if (optimized || verticesByte.empty()) {
+        return;
+    }
+    // the optimizer works on the import layout, packing comes after it
+    if (meshDesc.vertexLayout != VertexLayout::eFloat || meshDesc.idxStride != sizeof(IdxType)) {
+        logger->warn("cannot optimize a packed mesh: " + filePath.string());
+        return;
+    }
+
+    // works in place on either the parsed vectors or the copy-on-write mapping
+    auto meshVertices = fromBytes<Vertex>(verticesByte);
+    auto meshIndices  = fromBytes<IdxType>(indicesByte);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto before    = Mesh::analyzeVertexCache(meshIndices, meshVertices.size());
+
+    Mesh::optimizeVertexCache(meshIndices, meshVertices.size());
+    Mesh::optimizeVertexFetch(meshVertices, meshIndices);
+
+    auto after   = Mesh::analyzeVertexCache(meshIndices, meshVertices.size());
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    logger->info(filePath.string() + ": optimized " + std::to_string(meshIndices.size() / 3) +
+                 " triangles in " + std::to_string(toMs(endTime - startTime)) + " ms, ACMR " +
+                 std::to_string(before.acmr) + " -> " + std::to_string(after.acmr) + ", ATVR " +
+                 std::to_string(before.atvr) + " -> " + std::to_string(after.atvr));
+    optimized = true;
+}
+
+// the levels share the vertices of the full mesh, so they are appended to its indices after the
+// vertex fetch order has been settled and only get their triangles reordered for the cache
+void ModelFile::generateLods() {
+    auto lodCount = std::min(importSettings.lodCount, Math::DataFormat::maxLodCount);
+    if (lodCount <= 1 || indices.empty()) {
+        return;
+    }
+
+    auto startTime    = std::chrono::high_resolution_clock::now();
+    meshDesc.lodCount = Mesh::buildLodChain(
+        vertices, indices, std::span<Math::DataFormat::MeshLod>(meshDesc.lods).first(lodCount));
+    for (uint32_t lod = 1; lod < meshDesc.lodCount && optimized; lod++) {
+        auto range = std::span<IdxType>(indices).subspan(meshDesc.lods[lod].firstIndex,
+                                                         meshDesc.lods[lod].indexCount);
+        Mesh::optimizeVertexCache(range, vertices.size());
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    indicesByte       = toBytes(indices);
+    meshDesc.idxCount = indices.size();
+
+    std::string levels{};
+    for (uint32_t lod = 0; lod < meshDesc.lodCount; lod++) {
+        levels += (lod > 0 ? ", " : "") + std::to_string(meshDesc.lods[lod].indexCount / 3);
+    }
+    logger->info(filePath.string() + ": " + std::to_string(meshDesc.lodCount) +
+                 " levels of detail with " + levels + " triangles in " +
+                 std::to_string(toMs(endTime - startTime)) + " ms, coarsest error " +
+                 std::to_string(meshDesc.lods[meshDesc.lodCount - 1].error));
+}
+
+// the levels of detail were simplified from the full mesh already, reordering its triangles
+// changes nothing for them, each meshlet gets its own order for the vertex cache
+// the full mesh starts the index blob, so the meshlets count from the start of it either way
+void ModelFile::buildMeshlets() {
+    if (!importSettings.meshlets || indices.empty()) {
+        return;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto full      = std::span<IdxType>(indices).first(meshDesc.lods[0].indexCount);
+    Mesh::buildMeshlets(vertices, full, meshlets);
+    if (optimized) {
+        for (const auto& meshlet : meshlets) {
+            Mesh::optimizeVertexCache(full.subspan(meshlet.firstIndex, meshlet.indexCount),
+                                      vertices.size());
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    meshletsByte = toBytes(meshlets);
+    logger->info(filePath.string() + ": " + std::to_string(meshlets.size()) + " meshlets of " +
+                 std::to_string(meshlets.empty() ? 0.0f
+                                                 : meshDesc.lods[0].indexCount / 3.0f /
+                                                       static_cast<float>(meshlets.size())) +
+                 " triangles on average in " + std::to_string(toMs(endTime - startTime)) + " ms");
+}
+
+// convert the parsed mesh into the uploaded layout, the float data is released when replaced
+void ModelFile::pack() {
+    const size_t vertexCount = vertices.size();
+    const size_t floatBytes  = verticesByte.size() + indicesByte.size();
+
+    auto bounds           = Mesh::computeBounds(vertices);
+    meshDesc.vertexLayout = importSettings.vertexLayout;
+    meshDesc.bounds       = bounds.sphere;
+    meshDesc.boxMin       = bounds.boxMin;
+    meshDesc.boxMax       = bounds.boxMax;
+    if (meshDesc.vertexLayout == VertexLayout::ePacked) {
+        meshDesc.quantization = Mesh::computeQuantization(vertices);
+        packedVertices.resize(vertexCount);
+        Mesh::quantizeVertices(vertices, meshDesc.quantization, packedVertices);
+        auto error =
+            Mesh::measureQuantizationError(vertices, meshDesc.quantization, packedVertices);
+        logger->info(filePath.string() + ": quantized, vertices moved by up to " +
+                     std::to_string(error.position) + " in model space and " +
+                     std::to_string(error.texCoord) + " in uv");
+        std::vector<Vertex>().swap(vertices);
+        verticesByte = toBytes(packedVertices);
+    }
+
+    if (vertexCount <= Mesh::maxShortIdxVertexCount) {
+        shortIndices.resize(indices.size());
+        Mesh::narrowIndices(indices, shortIndices);
+        std::vector<IdxType>().swap(indices);
+        indicesByte        = toBytes(shortIndices);
+        meshDesc.idxStride = sizeof(uint16_t);
+    }
+
+    logger->info(filePath.string() + ": packed " + std::to_string(floatBytes) + " bytes into " +
+                 std::to_string(verticesByte.size() + indicesByte.size()) + " bytes, " +
+                 std::to_string(meshDesc.idxStride * 8) + " bit indices");
+}
+
+bool ModelFile::readCooked(const std::filesystem::path& cookedPath) {
+    if (!cookedMesh.open(cookedPath)) {
+        return false;
+    }
+    verticesByte = cookedMesh.getVerticesByte();
+    indicesByte  = cookedMesh.getIndicesByte();
+    meshletsByte = cookedMesh.getMeshletsByte();
+    meshDesc     = cookedMesh.getMeshDesc();
+    optimized    = cookedMesh.getFlags() & CookedMeshHeader::flagVertexCacheOptimized;
+    return true;
+}
+
+void ModelFile::readObj() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<Vertex> corners{};
+    bool                parsed = false;
+    {
+        Utils::MappedFile objFile{};
+        if (objFile.open(filePath)) {
+            auto bytes = objFile.bytes();
+            parsed     = ObjParser::parse(
+                std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()),
+                corners);
+        }
+    }
+    if (!parsed) {
+        logger->info("obj not handled by the built-in parser, falling back to tinyobj: " +
+                     filePath.string());
+        corners = readObjCornersTinyobj(filePath);
+    }
+
+    auto parseTime = std::chrono::high_resolution_clock::now();
+
+    Mesh::weldVertices(corners, vertices, indices);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto weldMs  = toMs(endTime - parseTime);
+    logger->info(filePath.string() + ": " + std::to_string(corners.size()) + " corners parsed in " +
+                 std::to_string(toMs(parseTime - startTime)) + " ms by " +
+                 (parsed ? "ObjParser" : "tinyobj") + ", welded into " +
+                 std::to_string(vertices.size()) + " vertices in " + std::to_string(weldMs) +
+                 " ms (" + std::to_string(weldMs > 0.0 ? corners.size() / weldMs / 1000.0 : 0.0) +
+                 " M corners/s)");
+
+    verticesByte      = toBytes(vertices);
+    indicesByte       = toBytes(indices);
+    meshDesc          = {};
+    meshDesc.idxCount = indices.size();
+    meshDesc.lods[0]  = {0, static_cast<uint32_t>(indices.size()), 0.0f};
+}
+
+std::vector<Vertex> ModelFile::readObjCornersTinyobj(const std::filesystem::path& objPath) {
     tinyobj::attrib_t                attrib{};
     std::vector<tinyobj::shape_t>    shapes{};
     std::vector<tinyobj::material_t> materials{};
     std::string                      warn, err{};
 
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.string().c_str())) {
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.string().c_str())) {
         auto msg = warn + err;
         logger->error(msg);
         throw std::runtime_error(msg);
     }
 
-    std::unordered_map<Vertex, IdxType> uniqueVertices{};
-
+    std::vector<Vertex> corners{};
     for (const auto& shape : shapes) {
         for (const auto& index : shape.mesh.indices) {
-            Vertex vertex{};
+            Vertex& vertex  = corners.emplace_back();
             vertex.pos      = {attrib.vertices[3 * index.vertex_index + 0],
                                attrib.vertices[3 * index.vertex_index + 1],
                                attrib.vertices[3 * index.vertex_index + 2]};
             vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0],
                                1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
             vertex.color    = {1.0f, 1.0f, 1.0f};
-            if (uniqueVertices.count(vertex) == 0) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-            }
+        }
+    }
+    return corners;
+}
 
-            indices.push_back(uniqueVertices[vertex]);
+// a flat grid of side x side vertices, two triangles per cell
+static void writeGridObj(const std::filesystem::path& path, uint32_t side) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        Utils::Log::logErrorMsg("failed to create " + path.string());
+    }
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            out << "v " << x * 0.01f << ' ' << y * 0.01f << " 0\n";
+        }
+    }
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            out << "vt " << x / static_cast<float>(side - 1) << ' '
+                << y / static_cast<float>(side - 1) << '\n';
+        }
+    }
+    for (uint32_t y = 0; y + 1 < side; y++) {
+        for (uint32_t x = 0; x + 1 < side; x++) {
+            auto a = y * side + x + 1, b = a + 1, c = a + side, d = c + 1;
+            out << "f " << a << '/' << a << ' ' << b << '/' << b << ' ' << d << '/' << d << '\n';
+            out << "f " << a << '/' << a << ' ' << d << '/' << d << ' ' << c << '/' << c << '\n';
         }
     }
 }
 
-void ModelFile::free() {
-    vertices.clear();
-    indices.clear();
+void ModelFile::benchmark(const std::filesystem::path& objPath) {
+    auto gridPath = std::filesystem::temp_directory_path() / "tbe_benchmark_grid.obj";
+    writeGridObj(gridPath, 708); // 999'698 triangles
+
+    for (const auto& path : {objPath, gridPath}) {
+        Utils::MappedFile objFile{};
+        if (!objFile.open(path)) {
+            logger->warn("obj benchmark: cannot open " + path.string());
+            continue;
+        }
+        auto bytes = objFile.bytes();
+        auto text  = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+        // the fastest of a few runs each, the first one also warms the file cache
+        std::vector<Vertex> parsed{}, reference{};
+        double              parserMs  = std::numeric_limits<double>::max();
+        double              tinyobjMs = std::numeric_limits<double>::max();
+        bool                handled   = true;
+        for (int run = 0; run < 3; run++) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            handled        = ObjParser::parse(text, parsed) && handled;
+            auto midTime   = std::chrono::high_resolution_clock::now();
+            reference      = readObjCornersTinyobj(path);
+            auto endTime   = std::chrono::high_resolution_clock::now();
+            parserMs       = std::min(parserMs, toMs(midTime - startTime));
+            tinyobjMs      = std::min(tinyobjMs, toMs(endTime - midTime));
+        }
+        if (!handled) {
+            logger->warn("obj benchmark: ObjParser does not handle " + path.string());
+            continue;
+        }
+
+        bool identical = parsed.size() == reference.size() &&
+                         std::memcmp(parsed.data(),
+                                     reference.data(),
+                                     parsed.size() * sizeof(Vertex)) == 0;
+        logger->info("obj benchmark, " + path.filename().string() + ": " +
+                     std::to_string(reference.size() / 3) + " triangles, ObjParser " +
+                     std::to_string(parserMs) + " ms, tinyobj " + std::to_string(tinyobjMs) +
+                     " ms, " + std::to_string(tinyobjMs / std::max(parserMs, 1e-6)) +
+                     "x faster, " + (identical ? "identical corners" : "CORNERS DIFFER"));
+
+        Mesh::benchmarkWeld(reference, path.filename().string());
+    }
+
+    std::error_code ec{};
+    std::filesystem::remove(gridPath, ec);
+}
+
+// everything that changes the cooked bytes, including the cooked format itself
+uint64_t ModelFile::hashImportSettings() const {
+    uint64_t seed = CookedMeshHeader::versionValue;
+    seed          = Utils::hashCombine(seed, importSettings.optimize);
+    seed          = Utils::hashCombine(seed, static_cast<uint32_t>(importSettings.vertexLayout));
+    seed          = Utils::hashCombine(seed, importSettings.lodCount);
+    seed          = Utils::hashCombine(seed, importSettings.meshlets);
+    return seed;
+}
+
+bool ModelFile::matchesImportSettings() const {
+    return meshDesc.vertexLayout == importSettings.vertexLayout &&
+           (optimized || !importSettings.optimize);
 }
 
 bool ModelFile::checkPathValid() {
@@ -1,15 +1,29 @@
 #pragma once
 
 #include "TBEngine/resource/file/base/fileBase.hpp"
+#include "TBEngine/resource/file/model/cookedMesh.hpp"
 #include "TBEngine/core/math/dataFormat.hpp"
 
-#include <tiny_obj_loader.h>
 #include <vector>
 #include <span>
 #include <string_view>
 
 namespace TBE::Resource::File {
 
+// choices that change the imported data, a cooked mesh is only reused if they match
+struct ModelImportSettings {
+    bool                           optimize     = false;
+    Math::DataFormat::VertexLayout vertexLayout = Math::DataFormat::VertexLayout::eFloat;
+    uint32_t                       lodCount     = 1; // levels of detail, the full mesh included
+    bool                           meshlets     = false; // split the full mesh for cluster culling
+};
+
+// read a model either from a cooked .tbmesh or from an .obj
+// reading an .obj looks in the asset cache first, and cooks an entry on a miss, so the obj is only
+// parsed once for each set of import settings
+// the welded mesh is optimized, simplified into its levels of detail, split into meshlets and
+// packed into the requested vertex layout before it is cooked, meshes with few enough vertices get
+// 16 bit indices
 class ModelFile : public FileBase {
     using super = FileBase;
 
@@ -17,22 +31,38 @@ public:
     ModelFile(std::string_view filePath_ = "None");
 
 private:
-    std::vector<Math::DataFormat::Vertex>  vertices{};
-    std::vector<Math::DataFormat::IdxType> indices{};
+    // only used by the obj path, a cooked mesh is viewed in place
+    std::vector<Math::DataFormat::Vertex>       vertices{};
+    std::vector<Math::DataFormat::IdxType>      indices{};
+    std::vector<Math::DataFormat::PackedVertex> packedVertices{};
+    std::vector<uint16_t>                       shortIndices{};
+    std::vector<Math::DataFormat::Meshlet>      meshlets{};
+
+    CookedMesh                 cookedMesh{};
+    std::span<std::byte>       verticesByte{};
+    std::span<std::byte>       indicesByte{};
+    std::span<std::byte>       meshletsByte{};
+    Math::DataFormat::MeshDesc meshDesc{};
+    ModelImportSettings        importSettings{};
+    bool                       optimized{};
+
+public:
+    void read();
+    void free();
+    void optimize();
+    void setImportSettings(const ModelImportSettings& settings) { importSettings = settings; }
+
+    // log how fast ObjParser and tinyobj read objPath and a generated grid of about a million
+    // triangles, and whether both read the same corners, then how fast they are welded
+    static void benchmark(const std::filesystem::path& objPath);
 
 public:
-    void                       read();
-    void                       free();
-    const decltype(vertices)&  getVertices() { return vertices; };
-    const decltype(indices)&   getIndices() { return indices; };
-    const std::span<std::byte> getVerticesByte() {
-        return std::span<std::byte>(static_cast<std::byte*>(static_cast<void*>(vertices.data())),
-                                    vertices.size() * sizeof(vertices[0]));
-    }
-    const std::span<std::byte> getIndicesByte() {
-        return std::span<std::byte>(static_cast<std::byte*>(static_cast<void*>(indices.data())),
-                                    indices.size() * sizeof(indices[0]));
-    }
+    size_t                            getIdxCount() const { return meshDesc.idxCount; }
+    const Math::DataFormat::MeshDesc& getMeshDesc() const { return meshDesc; }
+    const std::span<std::byte>        getVerticesByte() const { return verticesByte; }
+    const std::span<std::byte>        getIndicesByte() const { return indicesByte; }
+    // Math::DataFormat::Meshlet, empty unless the mesh was imported with meshlets
+    const std::span<std::byte>        getMeshletsByte() const { return meshletsByte; }
 
 private:
     static std::vector<std::string> supportedShaderTypes;
@@ -41,6 +71,17 @@ private:
     bool checkPathValid() override;
     void releaseOldFile() override;
     void prepareNewFile() override;
+
+private:
+    bool                                  readCooked(const std::filesystem::path& cookedPath);
+    void                                  readObj();
+    void                                  generateLods();
+    void                                  buildMeshlets();
+    void                                  pack();
+    static std::vector<Math::DataFormat::Vertex>
+    readObjCornersTinyobj(const std::filesystem::path& objPath);
+    uint64_t                              hashImportSettings() const;
+    bool                                  matchesImportSettings() const;
 };
 
 } // namespace TBE::Resource::File
@@ -0,0 +1,343 @@
+#include "objParser.hpp"
+#include "TBEngine/utils/parallel/parallel.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace TBE::Resource::File {
+
+using Math::DataFormat::Vertex;
+
+namespace {
+
+constexpr size_t minChunkSize = 1 << 20;
+
+// a face corner before the chunk offsets are known
+// a relative index is kept relative to the first record of its own chunk
+struct ObjCorner {
+    int64_t v{};
+    int64_t vt{};
+    bool    vRelative{};
+    bool    vtRelative{};
+};
+
+struct ObjChunk {
+    std::string_view       text{};
+    std::vector<float>     positions{}; // x, y, z
+    std::vector<float>     texcoords{}; // u, v
+    std::vector<ObjCorner> corners{};
+    bool                   supported = true;
+};
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool isTokenEnd(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// same steps as tinyobj's tryParseDouble, a correctly rounded parser would differ in the last bit
+bool parseDouble(const char* s, const char* end, double& result) {
+    if (s >= end) {
+        return false;
+    }
+
+    double      mantissa = 0.0;
+    int         exponent = 0;
+    char        sign     = '+';
+    char        expSign  = '+';
+    const char* cur      = s;
+    int         read     = 0;
+    bool        leadingDot{};
+
+    if (*cur == '+' || *cur == '-') {
+        sign = *cur;
+        cur++;
+        if (cur != end && *cur == '.') {
+            leadingDot = true;
+        }
+    } else if (isDigit(*cur)) {
+    } else if (*cur == '.') {
+        leadingDot = true;
+    } else {
+        return false;
+    }
+
+    if (!leadingDot) {
+        while (cur != end && isDigit(*cur)) {
+            mantissa *= 10;
+            mantissa += static_cast<int>(*cur - '0');
+            cur++;
+            read++;
+        }
+        if (read == 0) {
+            return false;
+        }
+    }
+
+    if (cur != end) {
+        bool readExponent = true;
+        if (*cur == '.') {
+            static const double powLut[] = {
+                1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001};
+            constexpr int lutEntries = sizeof(powLut) / sizeof(powLut[0]);
+
+            cur++;
+            read = 1;
+            while (cur != end && isDigit(*cur)) {
+                mantissa += static_cast<int>(*cur - '0') *
+                            (read < lutEntries ? powLut[read] : std::pow(10.0, -read));
+                read++;
+                cur++;
+            }
+        } else if (*cur != 'e' && *cur != 'E') {
+            readExponent = false;
+        }
+
+        if (readExponent && cur != end && (*cur == 'e' || *cur == 'E')) {
+            cur++;
+            if (cur != end && (*cur == '+' || *cur == '-')) {
+                expSign = *cur;
+                cur++;
+            } else if (cur == end || !isDigit(*cur)) {
+                return false;
+            }
+
+            read = 0;
+            while (cur != end && isDigit(*cur)) {
+                if (exponent > 2147483647 / 10) {
+                    return false;
+                }
+                exponent *= 10;
+                exponent += static_cast<int>(*cur - '0');
+                cur++;
+                read++;
+            }
+            exponent *= (expSign == '+' ? 1 : -1);
+            if (read == 0) {
+                return false;
+            }
+        }
+    }
+
+    result = (sign == '+' ? 1 : -1) *
+             (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+    return true;
+}
+
+// tinyobj's parseReal: a token that fails to parse reads as 0
+float parseFloat(const char*& cur, const char* end) {
+    while (cur != end && isSpace(*cur)) {
+        cur++;
+    }
+    const char* tokenEnd = cur;
+    while (tokenEnd != end && !isTokenEnd(*tokenEnd)) {
+        tokenEnd++;
+    }
+
+    double value = 0.0;
+    parseDouble(cur, tokenEnd, value);
+    cur = tokenEnd;
+    return static_cast<float>(value);
+}
+
+// atoi, stopping at the end of the line
+int64_t parseInt(const char*& cur, const char* end) {
+    bool negative = false;
+    if (cur != end && (*cur == '+' || *cur == '-')) {
+        negative = *cur == '-';
+        cur++;
+    }
+    int64_t value = 0;
+    while (cur != end && isDigit(*cur) && value < INT32_MAX) {
+        value = value * 10 + (*cur - '0');
+        cur++;
+    }
+    while (cur != end && !isTokenEnd(*cur) && *cur != '/') { // tinyobj skips to the next separator
+        cur++;
+    }
+    return negative ? -value : value;
+}
+
+// OBJ indices start at 1, negative ones count back from the latest record
+bool fixIndex(int64_t idx, size_t localCount, int64_t& ret, bool& relative) {
+    if (idx > 0) {
+        ret      = idx - 1;
+        relative = false;
+        return true;
+    }
+    if (idx < 0) {
+        ret      = static_cast<int64_t>(localCount) + idx;
+        relative = true;
+        return true;
+    }
+    return false;
+}
+
+void parseFace(const char* cur, const char* end, ObjChunk& chunk) {
+    size_t numCorners = 0;
+    while (cur != end && *cur != '\r') {
+        ObjCorner corner{};
+
+        int64_t idx = parseInt(cur, end);
+        if (!fixIndex(idx, chunk.positions.size() / 3, corner.v, corner.vRelative)) {
+            chunk.supported = false;
+            return;
+        }
+
+        // a face without texcoords would read garbage in the tinyobj path as well
+        if (cur == end || *cur != '/' || cur + 1 == end || cur[1] == '/') {
+            chunk.supported = false;
+            return;
+        }
+        cur++;
+
+        idx = parseInt(cur, end);
+        if (!fixIndex(idx, chunk.texcoords.size() / 2, corner.vt, corner.vtRelative)) {
+            chunk.supported = false;
+            return;
+        }
+
+        if (cur != end && *cur == '/') { // the normal is not used
+            cur++;
+            parseInt(cur, end);
+        }
+
+        chunk.corners.push_back(corner);
+        numCorners++;
+
+        while (cur != end && (isSpace(*cur) || *cur == '\r')) {
+            cur++;
+        }
+    }
+
+    // faces that tinyobj would triangulate are left to tinyobj
+    if (numCorners != 3) {
+        chunk.supported = false;
+    }
+}
+
+void parseChunk(ObjChunk& chunk) {
+    const char* cur = chunk.text.data();
+    const char* end = cur + chunk.text.size();
+
+    while (cur != end && chunk.supported) {
+        const char* lineEnd = cur;
+        while (lineEnd != end && *lineEnd != '\n') {
+            lineEnd++;
+        }
+
+        while (cur != lineEnd && isSpace(*cur)) {
+            cur++;
+        }
+
+        if (lineEnd - cur >= 2) {
+            if (cur[0] == 'v' && isSpace(cur[1])) {
+                cur += 2;
+                chunk.positions.push_back(parseFloat(cur, lineEnd));
+                chunk.positions.push_back(parseFloat(cur, lineEnd));
+                chunk.positions.push_back(parseFloat(cur, lineEnd));
+            } else if (cur[0] == 'v' && cur[1] == 't' && lineEnd - cur >= 3 && isSpace(cur[2])) {
+                cur += 3;
+                chunk.texcoords.push_back(parseFloat(cur, lineEnd));
+                chunk.texcoords.push_back(parseFloat(cur, lineEnd));
+            } else if (cur[0] == 'f' && isSpace(cur[1])) {
+                cur += 2;
+                while (cur != lineEnd && isSpace(*cur)) {
+                    cur++;
+                }
+                parseFace(cur, lineEnd, chunk);
+            }
+        }
+
+        cur = lineEnd == end ? end : lineEnd + 1;
+    }
+}
+
+std::vector<ObjChunk> splitChunks(std::string_view text) {
+    size_t chunkSize = std::max(minChunkSize, text.size() / (Utils::workerCount() * 4));
+
+    std::vector<ObjChunk> chunks{};
+    size_t                begin = 0;
+    while (begin < text.size()) {
+        size_t end = std::min(text.size(), begin + chunkSize);
+        if (end < text.size()) {
+            end = text.find('\n', end);
+            end = end == std::string_view::npos ? text.size() : end + 1;
+        }
+        chunks.emplace_back().text = text.substr(begin, end - begin);
+        begin                      = end;
+    }
+    return chunks;
+}
+
+} // namespace
+
+bool ObjParser::parse(std::string_view text, std::vector<Vertex>& corners) {
+    auto chunks = splitChunks(text);
+
+    Utils::parallelFor(chunks.size(), 1, [&chunks](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            parseChunk(chunks[i]);
+        }
+    });
+
+    // offsets of every chunk in the merged arrays
+    std::vector<size_t> posBase(chunks.size()), uvBase(chunks.size()), cornerBase(chunks.size());
+    size_t              numPos = 0, numUv = 0, numCorners = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        if (!chunks[i].supported) {
+            return false;
+        }
+        posBase[i]    = numPos;
+        uvBase[i]     = numUv;
+        cornerBase[i] = numCorners;
+        numPos += chunks[i].positions.size() / 3;
+        numUv += chunks[i].texcoords.size() / 2;
+        numCorners += chunks[i].corners.size();
+    }
+
+    std::vector<float> positions(numPos * 3), texcoords(numUv * 2);
+    Utils::parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            std::copy(chunks[i].positions.begin(),
+                      chunks[i].positions.end(),
+                      positions.begin() + posBase[i] * 3);
+            std::copy(chunks[i].texcoords.begin(),
+                      chunks[i].texcoords.end(),
+                      texcoords.begin() + uvBase[i] * 2);
+        }
+    });
+
+    corners.resize(numCorners);
+    std::atomic<bool> inRange = true;
+    Utils::parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            auto* out = corners.data() + cornerBase[i];
+            for (const auto& corner : chunks[i].corners) {
+                int64_t v  = corner.v + (corner.vRelative ? posBase[i] : 0);
+                int64_t vt = corner.vt + (corner.vtRelative ? uvBase[i] : 0);
+                if (v < 0 || v >= static_cast<int64_t>(numPos) || vt < 0 ||
+                    vt >= static_cast<int64_t>(numUv)) {
+                    inRange = false;
+                    return;
+                }
+
+                Vertex& vertex = *out++;
+                vertex.pos     = {positions[3 * v + 0], positions[3 * v + 1], positions[3 * v + 2]};
+                vertex.texCoord = {texcoords[2 * vt + 0], 1.0f - texcoords[2 * vt + 1]};
+                vertex.color    = {1.0f, 1.0f, 1.0f};
+            }
+        }
+    });
+
+    return inRange;
+}
+
+} // namespace TBE::Resource::File
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace TBE::Resource::File {
+
+/**
+ * @brief A multithreaded parser for the subset of OBJ that ModelFile uses.
+ *
+ * @details The text is split into line-aligned chunks, v / vt / f records of every chunk are parsed
+ * on worker threads and the results are merged in file order. Numbers are parsed with the same
+ * arithmetic as tinyobj, so every corner comes out bit-identical to the tinyobj path.
+ *
+ * Only triangulated faces that reference both a position and a texcoord are handled. Anything
+ * else makes parse() return false and the caller should fall back to tinyobj.
+ */
+class ObjParser {
+public:
+    // one Vertex per face corner, in file order, not yet deduplicated
+    [[nodiscard]] static bool parse(std::string_view                       text,
+                                    std::vector<Math::DataFormat::Vertex>& corners);
+};
+
+} // namespace TBE::Resource::File
@@ -0,0 +1,92 @@
+#include "cookedTexture.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace TBE::Resource::File {
+
+static constexpr uint64_t alignUp(uint64_t value) {
+    return (value + cookedTextureAlignment - 1) & ~(cookedTextureAlignment - 1);
+}
+
+bool CookedTexture::open(const std::filesystem::path& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    auto bytes = file.bytes();
+    if (bytes.size() < sizeof(CookedTextureHeader)) {
+        logger->warn("cooked texture too small: " + path.string());
+        close();
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    bool ok = header.magic == CookedTextureHeader::magicValue &&
+              header.version == CookedTextureHeader::versionValue && header.mipCount > 0 &&
+              header.mipCount <= cookedTextureMaxMips &&
+              Texture::getBlockBytes(header.format) != 0 &&
+              header.dataOffset % cookedTextureAlignment == 0 &&
+              header.dataOffset + header.dataSize <= bytes.size();
+    for (uint32_t i = 0; ok && i < header.mipCount; i++) {
+        ok = header.mips[i].offset + header.mips[i].size <= header.dataSize;
+    }
+    if (!ok) {
+        logger->warn("cooked texture is stale or corrupted: " + path.string());
+        close();
+        return false;
+    }
+
+    pixels = bytes.subspan(header.dataOffset, header.dataSize);
+    return true;
+}
+
+void CookedTexture::close() {
+    file.close();
+    header = {};
+    pixels = {};
+}
+
+void CookedTexture::write(const std::filesystem::path&         path,
+                          std::span<const std::byte>           chain,
+                          std::span<const Texture::TextureMip> mips,
+                          Texture::TextureFormat               format) {
+    if (mips.empty() || mips.size() > cookedTextureMaxMips) {
+        Utils::Log::logErrorMsg("unsupported mip count for a cooked texture: " + path.string());
+    }
+
+    CookedTextureHeader header{};
+    header.width      = mips[0].width;
+    header.height     = mips[0].height;
+    header.mipCount   = static_cast<uint32_t>(mips.size());
+    header.format     = format;
+    header.dataOffset = alignUp(sizeof(CookedTextureHeader));
+    header.dataSize   = chain.size();
+    std::copy(mips.begin(), mips.end(), header.mips.begin());
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Utils::Log::logErrorMsg("failed to create cooked texture: " + tmpPath.string());
+        }
+
+        const char zeros[cookedTextureAlignment]{};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(zeros, static_cast<std::streamsize>(header.dataOffset - sizeof(header)));
+        out.write(reinterpret_cast<const char*>(chain.data()),
+                  static_cast<std::streamsize>(chain.size()));
+
+        if (!out.good()) {
+            Utils::Log::logErrorMsg("failed to write cooked texture: " + tmpPath.string());
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path);
+}
+
+} // namespace TBE::Resource::File
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "TBEngine/resource/texture/mipmap/mipmap.hpp"
+#include "TBEngine/resource/texture/textureFormat/textureFormat.hpp"
+#include "TBEngine/utils/mappedFile/mappedFile.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace TBE::Resource::File {
+
+// file extension of the cooked texture container
+inline constexpr std::string_view cookedTextureExt = ".tbtex";
+
+inline constexpr uint64_t cookedTextureAlignment = 64;
+inline constexpr uint32_t cookedTextureMaxMips   = 16;
+
+/**
+ * @brief Header at the beginning of a .tbtex file.
+ *
+ * @details Layout of the file:
+ * | header | padding | mip chain |
+ * The chain is in the header format, level 0 first, exactly as it is copied into the image.
+ */
+struct CookedTextureHeader {
+    static constexpr std::array<char, 4> magicValue   = {'T', 'B', 'T', 'X'};
+    static constexpr uint32_t            versionValue = 2;
+
+    std::array<char, 4>    magic   = magicValue;
+    uint32_t               version = versionValue;
+    uint32_t               width{};
+    uint32_t               height{};
+    uint32_t               mipCount{};
+    Texture::TextureFormat format{};
+    uint64_t               dataOffset{};
+    uint64_t               dataSize{};
+
+    std::array<Texture::TextureMip, cookedTextureMaxMips> mips{};
+};
+static_assert(sizeof(CookedTextureHeader) == 424, "CookedTextureHeader is part of the file format");
+
+// a .tbtex file mapped into memory, the pixels point straight into the mapping
+class CookedTexture {
+public:
+    // return false if the file is missing, truncated or of another version
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+public:
+    std::span<std::byte> getPixels() const { return pixels; }
+    uint32_t             getWidth() const { return header.width; }
+    uint32_t             getHeight() const { return header.height; }
+
+    Texture::TextureFormat getFormat() const { return header.format; }
+
+    std::span<const Texture::TextureMip> getMips() const {
+        return {header.mips.data(), header.mipCount};
+    }
+
+public:
+    // write a cooked texture, the file is written beside the target and renamed when complete
+    static void write(const std::filesystem::path&         path,
+                      std::span<const std::byte>           chain,
+                      std::span<const Texture::TextureMip> mips,
+                      Texture::TextureFormat               format);
+
+private:
+    Utils::MappedFile    file{};
+    CookedTextureHeader  header{};
+    std::span<std::byte> pixels{};
+};
+
+} // namespace TBE::Resource::File
@@ -0,0 +1,87 @@
+#include "ktx2Texture.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace TBE::Resource::File {
+
+bool Ktx2Texture::open(const std::filesystem::path& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    auto fail = [&](const std::string& reason) {
+        logger->warn("unsupported KTX2 texture, " + reason + ": " + path.string());
+        close();
+        return false;
+    };
+
+    auto bytes = file.bytes();
+    if (bytes.size() < sizeof(Ktx2Header)) {
+        return fail("file too small");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    format = static_cast<Texture::TextureFormat>(header.vkFormat);
+    if (header.identifier != Ktx2Header::identifierValue) {
+        return fail("not a KTX2 file");
+    }
+    if (Texture::getBlockBytes(format) == 0) {
+        return fail("VkFormat " + std::to_string(header.vkFormat));
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 ||
+        header.layerCount > 1 || header.faceCount != 1) {
+        return fail("not a single 2D image");
+    }
+    if (header.supercompressionScheme != 0) {
+        return fail("supercompressed");
+    }
+
+    // a level count of 0 asks the loader to generate the mips, the one level is used as it is
+    const uint32_t levelCount = std::max(header.levelCount, 1u);
+    if (levelCount > Texture::getMipLevelCount(header.pixelWidth, header.pixelHeight) ||
+        sizeof(Ktx2Header) + levelCount * sizeof(Ktx2LevelIndex) > bytes.size()) {
+        return fail("bad level index");
+    }
+    std::vector<Ktx2LevelIndex> levels(levelCount);
+    std::memcpy(levels.data(),
+                bytes.data() + sizeof(Ktx2Header),
+                levels.size() * sizeof(Ktx2LevelIndex));
+
+    uint64_t begin = std::numeric_limits<uint64_t>::max(), end = 0;
+    for (uint32_t i = 0; i < levelCount; i++) {
+        uint32_t width  = std::max(header.pixelWidth >> i, 1u);
+        uint32_t height = std::max(header.pixelHeight >> i, 1u);
+        uint64_t size   = Texture::getLevelSize(format, width, height);
+        if (levels[i].byteLength != size || levels[i].byteOffset > bytes.size() ||
+            bytes.size() - levels[i].byteOffset < size) {
+            return fail("level " + std::to_string(i) + " out of range");
+        }
+        begin = std::min(begin, levels[i].byteOffset);
+        end   = std::max(end, levels[i].byteOffset + size);
+    }
+
+    mips.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        mips[i].offset = levels[i].byteOffset - begin;
+        mips[i].size   = levels[i].byteLength;
+        mips[i].width  = std::max(header.pixelWidth >> i, 1u);
+        mips[i].height = std::max(header.pixelHeight >> i, 1u);
+    }
+    pixels = bytes.subspan(begin, end - begin);
+    return true;
+}
+
+void Ktx2Texture::close() {
+    file.close();
+    header = {};
+    format = {};
+    mips.clear();
+    pixels = {};
+}
+
+} // namespace TBE::Resource::File
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "TBEngine/resource/texture/mipmap/mipmap.hpp"
+#include "TBEngine/resource/texture/textureFormat/textureFormat.hpp"
+#include "TBEngine/utils/mappedFile/mappedFile.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace TBE::Resource::File {
+
+inline constexpr std::string_view ktx2Ext = ".ktx2";
+
+// fixed part at the beginning of a KTX2 file, followed by levelCount Ktx2LevelIndex
+struct Ktx2Header {
+    static constexpr std::array<uint8_t, 12> identifierValue = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    std::array<uint8_t, 12> identifier{};
+    uint32_t                vkFormat{};
+    uint32_t                typeSize{};
+    uint32_t                pixelWidth{};
+    uint32_t                pixelHeight{};
+    uint32_t                pixelDepth{};
+    uint32_t                layerCount{};
+    uint32_t                faceCount{};
+    uint32_t                levelCount{};
+    uint32_t                supercompressionScheme{};
+    uint32_t                dfdByteOffset{};
+    uint32_t                dfdByteLength{};
+    uint32_t                kvdByteOffset{};
+    uint32_t                kvdByteLength{};
+    uint64_t                sgdByteOffset{};
+    uint64_t                sgdByteLength{};
+};
+static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header has to match the KTX2 layout");
+
+struct Ktx2LevelIndex {
+    uint64_t byteOffset{};
+    uint64_t byteLength{};
+    uint64_t uncompressedByteLength{};
+};
+
+/**
+ * @brief A KTX2 texture mapped into memory, the levels are uploaded straight from the mapping.
+ *
+ * @details Only single 2D images without supercompression are taken, in one of the formats of
+ * Texture::TextureFormat. The file stores the smallest level first, the mips locate every level
+ * relative to the start of the pixels, the same as for a cooked texture.
+ */
+class Ktx2Texture {
+public:
+    // return false if the file is missing, truncated or uses anything unsupported
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+public:
+    std::span<std::byte>                 getPixels() const { return pixels; }
+    std::span<const Texture::TextureMip> getMips() const { return mips; }
+    Texture::TextureFormat               getFormat() const { return format; }
+    uint32_t                             getWidth() const { return header.pixelWidth; }
+    uint32_t                             getHeight() const { return header.pixelHeight; }
+
+private:
+    Utils::MappedFile                file{};
+    Ktx2Header                       header{};
+    Texture::TextureFormat           format{};
+    std::vector<Texture::TextureMip> mips{};
+    std::span<std::byte>             pixels{};
+};
+
+} // namespace TBE::Resource::File
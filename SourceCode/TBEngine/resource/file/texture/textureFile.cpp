@@ -1,4 +1,7 @@
 #include "textureFile.hpp"
+#include "TBEngine/resource/cache/assetCache.hpp"
+#include "TBEngine/resource/texture/blockCompress/blockCompress.hpp"
+#include "TBEngine/utils/hash/hash.hpp"
 #include "TBEngine/utils/log/log.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -7,6 +10,9 @@
 #include <string>
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <string_view>
 
 extern const TBE::Utils::Log::Logger* logger;
 
@@ -18,6 +24,7 @@ TextureFile::TextureFile(const std::filesystem::path& filePath_) : FileBase(file
     if (supportedTextureTypes.empty()) {
         supportedTextureTypes.emplace_back(".jpg");
         supportedTextureTypes.emplace_back(".png");
+        supportedTextureTypes.emplace_back(ktx2Ext);
     }
     valid = checkPathValid();
 }
@@ -29,10 +36,85 @@ TextureFile::TextureFile(const std::string& filePath_)
 TextureFile::TextureFile(const char* filePath_) : TextureFile(std::string(filePath_)) {
 }
 
+TextureUsage TextureFile::usageOf(const std::filesystem::path& texturePath) {
+    auto stem = texturePath.stem().string();
+    std::transform(stem.begin(), stem.end(), stem.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    for (std::string_view suffix : {"_normal", "_normals", "_nrm", "_norm", "_n"}) {
+        if (stem.ends_with(suffix)) {
+            return TextureUsage::eNormal;
+        }
+    }
+    return TextureUsage::eColor;
+}
+
+static double toMs(std::chrono::high_resolution_clock::duration duration) {
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(duration).count();
+}
+
 TextureContent* TextureFile::read() {
-    if (texContent.pixels)
+    if (!texContent.pixels.empty())
+        return &texContent;
+
+    if (filePath.extension() == ktx2Ext) {
+        if (!readKtx2()) {
+            Utils::Log::logErrorMsg("failed to read KTX2 texture: " + filePath.string());
+        }
+        return &texContent;
+    }
+
+    auto& cache     = Cache::AssetCache::get();
+    auto  startTime = std::chrono::high_resolution_clock::now();
+    auto entryPath = cache.getEntryPath(Cache::AssetKind::eTexture, filePath, hashImportSettings());
+    if (!entryPath.empty() && std::filesystem::exists(entryPath) &&
+        texContent.cooked.open(entryPath)) {
+        auto& cooked          = texContent.cooked;
+        texContent.pixels     = cooked.getPixels();
+        texContent.mips       = {cooked.getMips().begin(), cooked.getMips().end()};
+        texContent.format     = cooked.getFormat();
+        texContent.texWidth   = static_cast<int>(cooked.getWidth());
+        texContent.texHeight  = static_cast<int>(cooked.getHeight());
+        texContent.texChannel = 4;
+        cache.recordHit(Cache::AssetKind::eTexture,
+                        entryPath,
+                        toMs(std::chrono::high_resolution_clock::now() - startTime));
         return &texContent;
+    }
+
+    importImage();
+
+    if (!entryPath.empty()) {
+        try {
+            CookedTexture::write(entryPath, texContent.pixels, texContent.mips, texContent.format);
+            cache.recordMiss(Cache::AssetKind::eTexture,
+                             entryPath,
+                             toMs(std::chrono::high_resolution_clock::now() - startTime));
+        } catch (const std::exception& e) {
+            logger->warn(std::string("failed to cook texture: ") + e.what());
+        }
+    }
+    return &texContent;
+}
+
+bool TextureFile::readKtx2() {
+    auto& ktx2 = texContent.ktx2;
+    if (!ktx2.open(filePath)) {
+        return false;
+    }
+    texContent.pixels     = ktx2.getPixels();
+    texContent.mips       = {ktx2.getMips().begin(), ktx2.getMips().end()};
+    texContent.format     = ktx2.getFormat();
+    texContent.texWidth   = static_cast<int>(ktx2.getWidth());
+    texContent.texHeight  = static_cast<int>(ktx2.getHeight());
+    texContent.texChannel = 4;
+    logger->info(filePath.string() + ": " + std::to_string(texContent.mips.size()) +
+                 " levels of " + std::string(Texture::toString(texContent.format)));
+    return true;
+}
 
+// decode with stb and build the mip chain, filtered on the worker threads
+void TextureFile::importImage() {
     int  texWidth, texHeight, texChannel;
     auto pixels =
         stbi_load(filePath.string().c_str(), &texWidth, &texHeight, &texChannel, STBI_rgb_alpha);
@@ -41,8 +123,72 @@ TextureContent* TextureFile::read() {
         logger->error(msg);
         throw std::runtime_error(msg);
     }
-    texContent = {pixels, texHeight, texWidth, texChannel};
-    return &texContent;
+
+    const size_t               levelSize = static_cast<size_t>(texWidth) * texHeight * 4;
+    const bool                 srgb      = importSettings.usage != TextureUsage::eNormal;
+    std::span<const std::byte> level0(reinterpret_cast<const std::byte*>(pixels), levelSize);
+    texContent.mips       = Texture::buildMipChain(level0,
+                                             static_cast<uint32_t>(texWidth),
+                                             static_cast<uint32_t>(texHeight),
+                                             texContent.storage,
+                                             importSettings.mipFilter,
+                                             srgb);
+    texContent.pixels     = texContent.storage;
+    texContent.format     = srgb ? Texture::TextureFormat::eRGBA8Srgb
+                                 : Texture::TextureFormat::eRGBA8Unorm;
+    texContent.texWidth   = texWidth;
+    texContent.texHeight  = texHeight;
+    texContent.texChannel = texChannel;
+
+    bool hasAlpha = false;
+    for (size_t i = 3; i < levelSize && !hasAlpha; i += 4) {
+        hasAlpha = pixels[i] != 255;
+    }
+    stbi_image_free(pixels);
+
+    if (importSettings.compress) {
+        compress(hasAlpha);
+    }
+}
+
+// replace the RGBA8 chain by its BC encoding
+void TextureFile::compress(bool hasAlpha) {
+    auto format    = chooseCompressedFormat(hasAlpha);
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::byte> compressed{};
+    texContent.mips =
+        Texture::compressMipChain(texContent.storage, texContent.mips, format, compressed);
+
+    logger->info(filePath.string() + ": compressed into " + std::string(Texture::toString(format)) +
+                 ", " + std::to_string(texContent.storage.size()) + " -> " +
+                 std::to_string(compressed.size()) + " bytes in " +
+                 std::to_string(toMs(std::chrono::high_resolution_clock::now() - startTime)) +
+                 " ms");
+
+    texContent.storage.swap(compressed);
+    texContent.pixels = texContent.storage;
+    texContent.format = format;
+}
+
+Texture::TextureFormat TextureFile::chooseCompressedFormat(bool hasAlpha) const {
+    using Texture::TextureFormat;
+    if (importSettings.usage == TextureUsage::eNormal) {
+        return TextureFormat::eBC5Unorm;
+    }
+    if (importSettings.preferBC7) {
+        return TextureFormat::eBC7Srgb;
+    }
+    return hasAlpha ? TextureFormat::eBC3Srgb : TextureFormat::eBC1RGBSrgb;
+}
+
+uint64_t TextureFile::hashImportSettings() const {
+    uint64_t seed = CookedTextureHeader::versionValue;
+    seed          = Utils::hashCombine(seed, static_cast<uint32_t>(importSettings.mipFilter));
+    seed          = Utils::hashCombine(seed, static_cast<uint32_t>(importSettings.usage));
+    seed          = Utils::hashCombine(seed, importSettings.compress);
+    seed          = Utils::hashCombine(seed, importSettings.preferBC7);
+    return seed;
 }
 
 void TextureFile::free() {
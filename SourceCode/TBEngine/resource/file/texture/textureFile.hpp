@@ -1,29 +1,60 @@
 #pragma once
 
 #include "TBEngine/resource/file/base/fileBase.hpp"
+#include "TBEngine/resource/file/texture/cookedTexture.hpp"
+#include "TBEngine/resource/file/texture/ktx2Texture.hpp"
+#include "TBEngine/resource/texture/mipmap/mipmap.hpp"
+#include "TBEngine/resource/texture/textureFormat/textureFormat.hpp"
 
-#include <stb_image.h>
-
+#include <span>
 #include <string>
 #include <vector>
 #include <filesystem>
 
 namespace TBE::Resource::File {
 
+// pixels of every mip level in format, owned either by the imported storage or by the mapped
+// cooked or KTX2 texture
 struct TextureContent {
-    stbi_uc* pixels = nullptr;
-    int      texHeight{};
-    int      texWidth{};
-    int      texChannel{};
+    std::span<std::byte>             pixels{};
+    std::vector<Texture::TextureMip> mips{};
+    Texture::TextureFormat           format = Texture::TextureFormat::eRGBA8Srgb;
+    int                              texHeight{};
+    int                              texWidth{};
+    int                              texChannel{};
+
+    std::vector<std::byte> storage{};
+    CookedTexture          cooked{};
+    Ktx2Texture            ktx2{};
 
     inline void free() {
-        if (pixels) {
-            stbi_image_free(pixels);
-            *this = {};
-        }
+        pixels = {};
+        mips.clear();
+        format    = Texture::TextureFormat::eRGBA8Srgb;
+        texHeight = texWidth = texChannel = 0;
+        std::vector<std::byte>().swap(storage);
+        cooked.close();
+        ktx2.close();
     }
 };
 
+// what the texture holds, normal maps are filtered and compressed as linear data
+enum class TextureUsage : uint32_t
+{
+    eColor,
+    eNormal
+};
+
+// choices that change the imported data, part of the cache key of the cooked texture
+struct TextureImportSettings {
+    Texture::MipFilter mipFilter = Texture::MipFilter::eBox;
+    TextureUsage       usage     = TextureUsage::eColor;
+    bool               compress  = false; // BC1, BC3 with alpha, BC5 for normal maps
+    bool               preferBC7 = false; // BC7 for color, twice the size of BC1 without banding
+};
+
+// read .jpg and .png through the asset cache, the image is decoded, mipmapped and optionally
+// block compressed on a miss, .ktx2 files are already cooked and read as they are
 class TextureFile : public FileBase {
     using super = FileBase;
 
@@ -36,8 +67,21 @@ public:
     TextureContent* read();
     void            free();
 
+    void setImportSettings(const TextureImportSettings& settings) { importSettings = settings; }
+
+    // what a texture holds by the usual suffixes of its file name, "_normal", "_nrm", "_n"
+    static TextureUsage usageOf(const std::filesystem::path& texturePath);
+
+private:
+    TextureContent        texContent{};
+    TextureImportSettings importSettings{};
+
 private:
-    TextureContent texContent{};
+    void                   importImage();
+    bool                   readKtx2();
+    void                   compress(bool hasAlpha);
+    Texture::TextureFormat chooseCompressedFormat(bool hasAlpha) const;
+    uint64_t               hashImportSettings() const;
 
 private:
     static std::vector<std::string> supportedTextureTypes;
@@ -0,0 +1,33 @@
+#include "meshBounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TBE::Resource::Mesh {
+
+using Math::DataFormat::Vertex;
+
+MeshBounds computeBounds(std::span<const Vertex> vertices) {
+    MeshBounds bounds{};
+    if (vertices.empty()) {
+        return bounds;
+    }
+
+    bounds.boxMin = vertices[0].pos;
+    bounds.boxMax = vertices[0].pos;
+    for (const auto& vertex : vertices) {
+        bounds.boxMin = glm::min(bounds.boxMin, vertex.pos);
+        bounds.boxMax = glm::max(bounds.boxMax, vertex.pos);
+    }
+
+    glm::vec3 center   = (bounds.boxMin + bounds.boxMax) * 0.5f;
+    float     radiusSq = 0.0f;
+    for (const auto& vertex : vertices) {
+        glm::vec3 offset = vertex.pos - center;
+        radiusSq         = std::max(radiusSq, glm::dot(offset, offset));
+    }
+    bounds.sphere = glm::vec4(center, std::sqrt(radiusSq));
+    return bounds;
+}
+
+} // namespace TBE::Resource::Mesh
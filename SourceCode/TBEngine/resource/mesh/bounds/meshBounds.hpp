@@ -0,0 +1,20 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+
+namespace TBE::Resource::Mesh {
+
+// model space bounds of the vertices, the sphere is xyz center and w radius
+struct MeshBounds {
+    glm::vec3 boxMin{0.0f};
+    glm::vec3 boxMax{0.0f};
+    glm::vec4 sphere{0.0f};
+};
+
+// the sphere is centered on the bounding box, which is a little looser than the smallest sphere
+// but cheap and stable
+MeshBounds computeBounds(std::span<const Math::DataFormat::Vertex> vertices);
+
+} // namespace TBE::Resource::Mesh
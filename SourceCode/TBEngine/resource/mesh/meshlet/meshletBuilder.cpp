@@ -0,0 +1,235 @@
+#include "meshletBuilder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace TBE::Resource::Mesh {
+
+using Math::DataFormat::IdxType;
+using Math::DataFormat::Meshlet;
+using Math::DataFormat::Vertex;
+
+static constexpr uint32_t noMeshlet = UINT32_MAX;
+static constexpr size_t   noTri     = std::numeric_limits<size_t>::max();
+
+// cones wider than this never cull, so there is no point in computing them
+static constexpr float minConeDot = 0.1f;
+// how many live neighbours a triangle facing away from the meshlet so far is worth
+static constexpr float coneWeight = 4.0f;
+
+// unit normal, zero for a degenerate triangle
+static glm::vec3 triangleNormal(std::span<const Vertex> vertices, const IdxType* tri) {
+    auto normal = glm::cross(vertices[tri[1]].pos - vertices[tri[0]].pos,
+                             vertices[tri[2]].pos - vertices[tri[0]].pos);
+    auto length = glm::length(normal);
+    return length > 0.0f ? normal / length : glm::vec3(0.0f);
+}
+
+void buildMeshlets(std::span<const Vertex> vertices,
+                   std::span<IdxType>      indices,
+                   std::vector<Meshlet>&   meshlets,
+                   uint32_t                maxVertices,
+                   uint32_t                maxTriangles) {
+    meshlets.clear();
+    const size_t numTris     = indices.size() / 3;
+    const size_t vertexCount = vertices.size();
+    if (numTris == 0) {
+        return;
+    }
+    maxVertices  = std::max(maxVertices, 3u);
+    maxTriangles = std::max(maxTriangles, 1u);
+
+    std::vector<glm::vec3> normals(numTris);
+    for (size_t t = 0; t < numTris; t++) {
+        normals[t] = triangleNormal(vertices, &indices[t * 3]);
+    }
+
+    // triangles on both sides of a uv seam are neighbours as well, they only share positions
+    std::vector<uint32_t> positionOf(vertexCount);
+    {
+        std::unordered_map<uint64_t, uint32_t> firstAt{};
+        firstAt.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            auto pos = vertices[v].pos + glm::vec3(0.0f); // -0.0 and 0.0 are the same position
+            std::array<uint32_t, 3> bits{};
+            std::memcpy(bits.data(), &pos, sizeof(bits));
+            // a collision only makes two triangles neighbours that are not
+            auto key      = Utils::hashBytes(bits.data(), sizeof(bits));
+            positionOf[v] = firstAt.try_emplace(key, static_cast<uint32_t>(v)).first->second;
+        }
+    }
+
+    // position -> triangle adjacency in compressed rows
+    std::vector<uint32_t> liveCount(vertexCount, 0);
+    for (auto idx : indices.first(numTris * 3)) {
+        liveCount[positionOf[idx]]++;
+    }
+    std::vector<size_t> adjOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjOffset[v + 1] = adjOffset[v] + liveCount[v];
+    }
+    std::vector<uint32_t> adjTris(numTris * 3);
+    {
+        std::vector<size_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (size_t i = 0; i < numTris * 3; i++) {
+            adjTris[fill[positionOf[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<bool>     emitted(numTris, false);
+    std::vector<uint32_t> meshletOf(vertexCount, noMeshlet); // the last meshlet a vertex is in
+    std::vector<uint32_t> candidates{};
+    std::vector<IdxType>  output{};
+    output.reserve(numTris * 3);
+
+    size_t cursor = 0; // next triangle in input order to seed from when nothing is left nearby
+    while (output.size() < numTris * 3) {
+        // a triangle left next to the last meshlet, the most enclosed one, so few are stranded
+        size_t   seed     = noTri;
+        uint32_t seedLive = UINT32_MAX;
+        for (auto tri : candidates) {
+            if (emitted[tri]) {
+                continue;
+            }
+            const auto* corner = &indices[size_t{tri} * 3];
+            auto        live   = liveCount[positionOf[corner[0]]] +
+                        liveCount[positionOf[corner[1]]] + liveCount[positionOf[corner[2]]];
+            if (live < seedLive) {
+                seed     = tri;
+                seedLive = live;
+            }
+        }
+        if (seed == noTri) {
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            seed = cursor;
+        }
+
+        auto      id           = static_cast<uint32_t>(meshlets.size());
+        auto      first        = output.size();
+        uint32_t  meshletVerts = 0;
+        uint32_t  meshletTris  = 0;
+        glm::vec3 normalSum    = glm::vec3(0.0f);
+        auto      emit         = [&](size_t tri) {
+            emitted[tri] = true;
+            for (size_t k = 0; k < 3; k++) {
+                auto v        = indices[tri * 3 + k];
+                auto position = positionOf[v];
+                output.push_back(v);
+                liveCount[position]--;
+                if (meshletOf[v] == id) {
+                    continue;
+                }
+                meshletOf[v] = id;
+                meshletVerts++;
+                for (size_t i = adjOffset[position]; i < adjOffset[position + 1]; i++) {
+                    if (!emitted[adjTris[i]]) {
+                        candidates.push_back(adjTris[i]);
+                    }
+                }
+            }
+            normalSum += normals[tri];
+            meshletTris++;
+        };
+
+        candidates.clear();
+        emit(seed);
+        while (meshletTris < maxTriangles) {
+            auto length = glm::length(normalSum);
+            auto axis   = length > 0.0f ? normalSum / length : glm::vec3(0.0f);
+
+            size_t   best      = noTri;
+            uint32_t bestExtra = 4;
+            float    bestScore = std::numeric_limits<float>::max();
+            for (size_t i = 0; i < candidates.size();) {
+                auto tri = candidates[i];
+                if (emitted[tri]) {
+                    candidates[i] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                i++;
+
+                const auto* corner = &indices[size_t{tri} * 3];
+                uint32_t    extra  = (meshletOf[corner[0]] != id) + (meshletOf[corner[1]] != id) +
+                                 (meshletOf[corner[2]] != id);
+                if (meshletVerts + extra > maxVertices) {
+                    continue;
+                }
+                auto  live  = liveCount[positionOf[corner[0]]] + liveCount[positionOf[corner[1]]] +
+                            liveCount[positionOf[corner[2]]];
+                float score = static_cast<float>(live) +
+                              coneWeight * (1.0f - glm::dot(normals[tri], axis));
+                if (extra < bestExtra || (extra == bestExtra && score < bestScore)) {
+                    best      = tri;
+                    bestExtra = extra;
+                    bestScore = score;
+                }
+            }
+            if (best == noTri) {
+                break;
+            }
+            emit(best);
+        }
+
+        auto meshlet       = computeMeshletBounds(vertices, std::span(output).subspan(first));
+        meshlet.firstIndex = static_cast<uint32_t>(first);
+        meshlets.push_back(meshlet);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+Meshlet computeMeshletBounds(std::span<const Vertex> vertices, std::span<const IdxType> indices) {
+    Meshlet meshlet{};
+    meshlet.indexCount = static_cast<uint32_t>(indices.size());
+    meshlet.cone       = {0.0f, 0.0f, 0.0f, 1.0f};
+    if (indices.empty()) {
+        return meshlet;
+    }
+
+    // a meshlet has a few dozen vertices, sorting them is the cheapest way to count them
+    std::vector<IdxType> unique(indices.begin(), indices.end());
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+    meshlet.vertexCount = static_cast<uint32_t>(unique.size());
+
+    // centered on the box like Mesh::computeBounds
+    glm::vec3 boxMin = vertices[unique[0]].pos, boxMax = boxMin;
+    for (auto v : unique) {
+        boxMin = glm::min(boxMin, vertices[v].pos);
+        boxMax = glm::max(boxMax, vertices[v].pos);
+    }
+    auto  center = (boxMin + boxMax) * 0.5f;
+    float radius = 0.0f;
+    for (auto v : unique) {
+        radius = std::max(radius, glm::length(vertices[v].pos - center));
+    }
+    meshlet.sphere = glm::vec4(center, radius);
+
+    glm::vec3 normalSum = glm::vec3(0.0f);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        normalSum += triangleNormal(vertices, &indices[i]);
+    }
+    auto length = glm::length(normalSum);
+    if (length <= 0.0f) {
+        return meshlet;
+    }
+    auto  axis   = normalSum / length;
+    float minDot = 1.0f;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        auto normal = triangleNormal(vertices, &indices[i]);
+        if (normal != glm::vec3(0.0f)) {
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+    }
+    float cutoff = minDot <= minConeDot ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    meshlet.cone = glm::vec4(axis, cutoff);
+    return meshlet;
+}
+
+} // namespace TBE::Resource::Mesh
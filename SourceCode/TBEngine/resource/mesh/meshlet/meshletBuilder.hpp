@@ -0,0 +1,45 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+#include <vector>
+
+namespace TBE::Resource::Mesh {
+
+// the limits mesh shaders are usually given, a meshlet stays small enough to be culled on its own
+constexpr uint32_t meshletMaxVertices  = 64;
+constexpr uint32_t meshletMaxTriangles = 124;
+
+/**
+ * @brief Split a triangle list into meshlets and reorder it so that every meshlet is a
+ * contiguous run of it.
+ *
+ * @details A meshlet starts from the triangle left over next to the one before it that has the
+ * fewest live neighbours and grows by the neighbouring triangle adding the fewest vertices, among
+ * those the one with few live neighbours that faces close to the meshlet so far. Finishing off
+ * enclosed triangles first leaves few small meshlets behind, the facing keeps the normal cones
+ * narrow. Triangles sharing a position across a uv seam are neighbours too. A meshlet ends at
+ * either limit or when no neighbour fits anymore.
+ *
+ * @param indices reordered in place, the winding of every triangle is kept
+ * @param meshlets receives them with their bounds, firstIndex counts from the start of indices
+ */
+void buildMeshlets(std::span<const Math::DataFormat::Vertex> vertices,
+                   std::span<Math::DataFormat::IdxType>      indices,
+                   std::vector<Math::DataFormat::Meshlet>&   meshlets,
+                   uint32_t                                  maxVertices  = meshletMaxVertices,
+                   uint32_t                                  maxTriangles = meshletMaxTriangles);
+
+/**
+ * @brief The bounding sphere and the normal cone of a run of triangles.
+ *
+ * @details The cone is the one of meshoptimizer's meshopt_computeClusterBounds: its axis is the
+ * mean of the triangle normals and its cutoff the sine of the widest angle between them and the
+ * axis, so Math::meshletBackfacing() can tell when the eye is behind every triangle. Triangles
+ * spreading further than about 84 degrees from the axis get a cutoff of 1, which never culls.
+ */
+Math::DataFormat::Meshlet computeMeshletBounds(std::span<const Math::DataFormat::Vertex>  vertices,
+                                               std::span<const Math::DataFormat::IdxType> indices);
+
+} // namespace TBE::Resource::Mesh
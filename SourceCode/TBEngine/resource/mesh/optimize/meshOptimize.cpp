@@ -0,0 +1,156 @@
+#include "meshOptimize.hpp"
+
+#include <vector>
+#include <limits>
+
+namespace TBE::Resource::Mesh {
+
+using Math::DataFormat::IdxType;
+using Math::DataFormat::Vertex;
+
+VertexCacheStats
+analyzeVertexCache(std::span<const IdxType> indices, size_t vertexCount, size_t cacheSize) {
+    // a vertex is in the cache if fewer than cacheSize misses were pushed after it
+    std::vector<size_t> pushedAt(vertexCount, 0);
+    std::vector<bool>   used(vertexCount, false);
+    size_t              misses = 0, usedCount = 0;
+
+    for (auto idx : indices) {
+        if (!used[idx]) {
+            used[idx] = true;
+            usedCount++;
+        }
+        if (pushedAt[idx] == 0 || misses - pushedAt[idx] >= cacheSize) {
+            misses++;
+            pushedAt[idx] = misses;
+        }
+    }
+
+    VertexCacheStats stats{};
+    if (!indices.empty()) {
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(usedCount);
+    }
+    return stats;
+}
+
+void optimizeVertexCache(std::span<IdxType> indices, size_t vertexCount, size_t cacheSize) {
+    const size_t numTris = indices.size() / 3;
+    if (numTris == 0) {
+        return;
+    }
+
+    // vertex -> triangle adjacency in compressed rows
+    std::vector<uint32_t> liveCount(vertexCount, 0);
+    for (auto idx : indices) {
+        liveCount[idx]++;
+    }
+    std::vector<size_t> adjOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjOffset[v + 1] = adjOffset[v] + liveCount[v];
+    }
+    std::vector<uint32_t> adjTris(indices.size());
+    {
+        std::vector<size_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjTris[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<size_t>  cacheTime(vertexCount, 0);
+    std::vector<bool>    emitted(numTris, false);
+    std::vector<IdxType> deadEnd{};
+    std::vector<IdxType> candidates{};
+    std::vector<IdxType> output{};
+    output.reserve(indices.size());
+
+    size_t time   = cacheSize + 1;
+    size_t cursor = 0; // next vertex in input order to resume from on a dead end
+
+    auto skipDeadEnd = [&]() -> int64_t {
+        while (!deadEnd.empty()) {
+            IdxType v = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveCount[v] > 0) {
+                return v;
+            }
+        }
+        while (cursor < vertexCount) {
+            if (liveCount[cursor] > 0) {
+                return static_cast<int64_t>(cursor);
+            }
+            cursor++;
+        }
+        return -1;
+    };
+
+    int64_t fanning = skipDeadEnd();
+    while (fanning >= 0) {
+        candidates.clear();
+
+        // emit every remaining triangle around the fanning vertex
+        for (size_t a = adjOffset[fanning]; a < adjOffset[fanning + 1]; a++) {
+            uint32_t tri = adjTris[a];
+            if (emitted[tri]) {
+                continue;
+            }
+            for (size_t c = 0; c < 3; c++) {
+                IdxType v = indices[tri * 3 + c];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveCount[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+            emitted[tri] = true;
+        }
+
+        // prefer the candidate that stays in the cache after its remaining triangles are emitted
+        int64_t best         = -1;
+        int64_t bestPriority = -1;
+        for (IdxType v : candidates) {
+            if (liveCount[v] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * liveCount[v] <= cacheSize) {
+                priority = static_cast<int64_t>(time - cacheTime[v]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best         = v;
+            }
+        }
+        fanning = best >= 0 ? best : skipDeadEnd();
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void optimizeVertexFetch(std::span<Vertex> vertices, std::span<IdxType> indices) {
+    constexpr IdxType   unassigned = std::numeric_limits<IdxType>::max();
+    std::vector<IdxType> remap(vertices.size(), unassigned);
+
+    IdxType next = 0;
+    for (auto& idx : indices) {
+        if (remap[idx] == unassigned) {
+            remap[idx] = next++;
+        }
+        idx = remap[idx];
+    }
+    for (auto& newIdx : remap) {
+        if (newIdx == unassigned) {
+            newIdx = next++;
+        }
+    }
+
+    std::vector<Vertex> reordered(vertices.size());
+    for (size_t v = 0; v < vertices.size(); v++) {
+        reordered[remap[v]] = vertices[v];
+    }
+    std::copy(reordered.begin(), reordered.end(), vertices.begin());
+}
+
+} // namespace TBE::Resource::Mesh
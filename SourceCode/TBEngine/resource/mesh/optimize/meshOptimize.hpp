@@ -0,0 +1,36 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+
+namespace TBE::Resource::Mesh {
+
+// size of the FIFO post-transform cache used by the optimizer and the statistics
+constexpr size_t defaultVertexCacheSize = 16;
+
+struct VertexCacheStats {
+    float acmr{}; // average cache miss ratio, transformed vertices per triangle, 0.5 ~ 3.0
+    float atvr{}; // average transformed vertex ratio, transformed vertices per vertex, 1.0 is best
+};
+
+// simulate a FIFO vertex cache over a triangle list
+VertexCacheStats analyzeVertexCache(std::span<const Math::DataFormat::IdxType> indices,
+                                    size_t                                     vertexCount,
+                                    size_t cacheSize = defaultVertexCacheSize);
+
+/**
+ * @brief Reorder triangles for post-transform cache reuse, with Tipsify.
+ *
+ * @details Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw", 2007. Runs in linear time, the winding of every triangle is kept.
+ */
+void optimizeVertexCache(std::span<Math::DataFormat::IdxType> indices,
+                         size_t                               vertexCount,
+                         size_t                               cacheSize = defaultVertexCacheSize);
+
+// renumber vertices in the order the index buffer first uses them, unused ones go last
+void optimizeVertexFetch(std::span<Math::DataFormat::Vertex>  vertices,
+                         std::span<Math::DataFormat::IdxType> indices);
+
+} // namespace TBE::Resource::Mesh
@@ -0,0 +1,113 @@
+#include "vertexQuantize.hpp"
+#include "TBEngine/utils/parallel/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace TBE::Resource::Mesh {
+
+using Math::DataFormat::IdxType;
+using Math::DataFormat::MeshQuantization;
+using Math::DataFormat::PackedVertex;
+using Math::DataFormat::Vertex;
+
+static constexpr float snorm16Max = 32767.0f;
+static constexpr float unorm16Max = 65535.0f;
+
+static int16_t toSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * snorm16Max));
+}
+
+static uint16_t toUnorm16(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * unorm16Max));
+}
+
+// same decoding as the vulkan fixed function conversion
+static float fromSnorm16(int16_t value) {
+    return std::max(static_cast<float>(value) / snorm16Max, -1.0f);
+}
+
+static float fromUnorm16(uint16_t value) {
+    return static_cast<float>(value) / unorm16Max;
+}
+
+MeshQuantization computeQuantization(std::span<const Vertex> vertices) {
+    MeshQuantization quantization{};
+    if (vertices.empty()) {
+        return quantization;
+    }
+
+    glm::vec3 posMin = vertices[0].pos, posMax = vertices[0].pos;
+    glm::vec2 uvMin = vertices[0].texCoord, uvMax = vertices[0].texCoord;
+    for (const auto& vertex : vertices) {
+        posMin = glm::min(posMin, vertex.pos);
+        posMax = glm::max(posMax, vertex.pos);
+        uvMin  = glm::min(uvMin, vertex.texCoord);
+        uvMax  = glm::max(uvMax, vertex.texCoord);
+    }
+
+    // a flat axis keeps a non zero scale so the packing never divides by zero
+    auto nonZero = [](float extent) { return extent > 0.0f ? extent : 1.0f; };
+
+    glm::vec3 halfExtent = (posMax - posMin) * 0.5f;
+    glm::vec2 uvExtent   = uvMax - uvMin;
+
+    quantization.posScale =
+        {nonZero(halfExtent.x), nonZero(halfExtent.y), nonZero(halfExtent.z), 0.0f};
+    quantization.posOffset     = glm::vec4((posMin + posMax) * 0.5f, 0.0f);
+    quantization.uvScaleOffset = {nonZero(uvExtent.x), nonZero(uvExtent.y), uvMin.x, uvMin.y};
+    return quantization;
+}
+
+void quantizeVertices(std::span<const Vertex> src,
+                      const MeshQuantization& quantization,
+                      std::span<PackedVertex> dst) {
+    const glm::vec3 posScale(quantization.posScale);
+    const glm::vec3 posOffset(quantization.posOffset);
+    const glm::vec2 uvScale   = {quantization.uvScaleOffset.x, quantization.uvScaleOffset.y};
+    const glm::vec2 uvOffset  = {quantization.uvScaleOffset.z, quantization.uvScaleOffset.w};
+
+    Utils::parallelFor(src.size(), 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            glm::vec3 pos = (src[i].pos - posOffset) / posScale;
+            glm::vec2 uv  = (src[i].texCoord - uvOffset) / uvScale;
+
+            dst[i].pos      = {toSnorm16(pos.x), toSnorm16(pos.y), toSnorm16(pos.z), 0};
+            dst[i].texCoord = {toUnorm16(uv.x), toUnorm16(uv.y)};
+        }
+    });
+}
+
+Vertex dequantizeVertex(const PackedVertex& vertex, const MeshQuantization& quantization) {
+    glm::vec3 pos = {
+        fromSnorm16(vertex.pos[0]), fromSnorm16(vertex.pos[1]), fromSnorm16(vertex.pos[2])};
+    glm::vec2 uv = {fromUnorm16(vertex.texCoord[0]), fromUnorm16(vertex.texCoord[1])};
+
+    Vertex ret{};
+    ret.pos      = pos * glm::vec3(quantization.posScale) + glm::vec3(quantization.posOffset);
+    ret.texCoord = uv * glm::vec2(quantization.uvScaleOffset.x, quantization.uvScaleOffset.y) +
+                   glm::vec2(quantization.uvScaleOffset.z, quantization.uvScaleOffset.w);
+    ret.color    = {1.0f, 1.0f, 1.0f};
+    return ret;
+}
+
+QuantizationError measureQuantizationError(std::span<const Vertex>       src,
+                                           const MeshQuantization&       quantization,
+                                           std::span<const PackedVertex> packed) {
+    QuantizationError error{};
+    for (size_t i = 0; i < src.size(); i++) {
+        auto vertex    = dequantizeVertex(packed[i], quantization);
+        error.position = std::max(error.position, glm::length(vertex.pos - src[i].pos));
+        error.texCoord = std::max(error.texCoord, glm::length(vertex.texCoord - src[i].texCoord));
+    }
+    return error;
+}
+
+void narrowIndices(std::span<const IdxType> src, std::span<uint16_t> dst) {
+    std::transform(src.begin(), src.end(), dst.begin(), [](IdxType idx) {
+        return static_cast<uint16_t>(idx);
+    });
+}
+
+} // namespace TBE::Resource::Mesh
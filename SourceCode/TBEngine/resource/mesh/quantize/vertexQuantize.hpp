@@ -0,0 +1,40 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+
+namespace TBE::Resource::Mesh {
+
+// largest vertex count that gets a 16 bit index buffer, 0xFFFF is left free as the restart index
+constexpr size_t maxShortIdxVertexCount = 0xFFFF;
+
+// fit the position and uv bounds of a mesh into the normalized ranges of PackedVertex
+Math::DataFormat::MeshQuantization
+computeQuantization(std::span<const Math::DataFormat::Vertex> vertices);
+
+// pack vertices into the snorm16 / unorm16 layout, dst must be as long as src
+void quantizeVertices(std::span<const Math::DataFormat::Vertex> src,
+                      const Math::DataFormat::MeshQuantization& quantization,
+                      std::span<Math::DataFormat::PackedVertex> dst);
+
+// inverse of quantizeVertices, color is set to white
+Math::DataFormat::Vertex dequantizeVertex(const Math::DataFormat::PackedVertex&     vertex,
+                                          const Math::DataFormat::MeshQuantization& quantization);
+
+// the largest distance a vertex moved by packing, in model space and in uv units
+struct QuantizationError {
+    float position{};
+    float texCoord{};
+};
+
+// round trip every vertex of src through packed and dequantizeVertex
+QuantizationError
+measureQuantizationError(std::span<const Math::DataFormat::Vertex>       src,
+                         const Math::DataFormat::MeshQuantization&       quantization,
+                         std::span<const Math::DataFormat::PackedVertex> packed);
+
+// copy indices into a 16 bit buffer, the caller checks the vertex count fits
+void narrowIndices(std::span<const Math::DataFormat::IdxType> src, std::span<uint16_t> dst);
+
+} // namespace TBE::Resource::Mesh
@@ -0,0 +1,447 @@
+#include "meshSimplify.hpp"
+#include "TBEngine/resource/mesh/bounds/meshBounds.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+
+namespace TBE::Resource::Mesh {
+
+using Math::DataFormat::IdxType;
+using Math::DataFormat::MeshLod;
+using Math::DataFormat::Vertex;
+
+static constexpr float    borderWeight = 10.0f; // planes through open borders, keeps them in place
+static constexpr uint32_t noVertex     = UINT32_MAX;
+
+// kinds of positions, worked out again every pass
+static constexpr uint8_t kindManifold = 0;
+static constexpr uint8_t kindBorder   = 1; // on an edge with one triangle
+static constexpr uint8_t kindLocked   = 2; // on an edge with more than two triangles
+
+// the squared distance to a set of planes, each weighted by the area of its triangle
+struct Quadric {
+    float a00{}, a01{}, a02{}, a11{}, a12{}, a22{};
+    float b0{}, b1{}, b2{};
+    float c{};
+    float weight{};
+
+    static Quadric fromPlane(const glm::vec3& normal, float distance, float weight) {
+        Quadric quadric{};
+        quadric.a00    = weight * normal.x * normal.x;
+        quadric.a01    = weight * normal.x * normal.y;
+        quadric.a02    = weight * normal.x * normal.z;
+        quadric.a11    = weight * normal.y * normal.y;
+        quadric.a12    = weight * normal.y * normal.z;
+        quadric.a22    = weight * normal.z * normal.z;
+        quadric.b0     = weight * normal.x * distance;
+        quadric.b1     = weight * normal.y * distance;
+        quadric.b2     = weight * normal.z * distance;
+        quadric.c      = weight * distance * distance;
+        quadric.weight = weight;
+        return quadric;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    // the weighted mean of the squared distances of point to the planes
+    float evaluate(const glm::vec3& point) const {
+        if (weight <= 0.0f) {
+            return 0.0f;
+        }
+        float x     = a00 * point.x + a01 * point.y + a02 * point.z;
+        float y     = a01 * point.x + a11 * point.y + a12 * point.z;
+        float z     = a02 * point.x + a12 * point.y + a22 * point.z;
+        float error = point.x * x + point.y * y + point.z * z +
+                      2.0f * (b0 * point.x + b1 * point.y + b2 * point.z) + c;
+        return std::max(0.0f, error / weight);
+    }
+};
+
+static uint64_t edgeKey(uint32_t from, uint32_t to) {
+    return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+// the first vertex with the same position as every vertex
+static std::vector<uint32_t> groupPositions(std::span<const glm::vec3> positions) {
+    std::vector<uint32_t> order(positions.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        const auto& a = positions[lhs];
+        const auto& b = positions[rhs];
+        if (a.x != b.x) {
+            return a.x < b.x;
+        }
+        if (a.y != b.y) {
+            return a.y < b.y;
+        }
+        if (a.z != b.z) {
+            return a.z < b.z;
+        }
+        return lhs < rhs;
+    });
+
+    std::vector<uint32_t> posOf(positions.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        bool same       = i > 0 && positions[order[i]] == positions[order[i - 1]];
+        posOf[order[i]] = same ? posOf[order[i - 1]] : order[i];
+    }
+    return posOf;
+}
+
+float simplifyMesh(std::span<const Vertex>  vertices,
+                   std::span<const IdxType> indices,
+                   size_t                   targetIndexCount,
+                   float                    maxError,
+                   std::vector<IdxType>&    result) {
+    result.assign(indices.begin(), indices.end());
+    if (result.size() <= targetIndexCount || vertices.empty()) {
+        return 0.0f;
+    }
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+    // positions in a unit box, so the errors are relative to the size of the mesh
+    auto      bounds = computeBounds(vertices);
+    glm::vec3 size   = bounds.boxMax - bounds.boxMin;
+    float     extent = std::max(size.x, std::max(size.y, size.z));
+    float     scale  = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+    std::vector<glm::vec3> positions(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        positions[v] = (vertices[v].pos - bounds.boxMin) * scale;
+    }
+
+    // the vertices of one position are its wedges, linked in a ring, the quadric and the
+    // topology belong to the position and are kept at its first vertex
+    auto                  posOf = groupPositions(positions);
+    std::vector<uint32_t> nextWedge(vertexCount);
+    std::iota(nextWedge.begin(), nextWedge.end(), 0u);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        if (posOf[v] != v) {
+            nextWedge[v]        = nextWedge[posOf[v]];
+            nextWedge[posOf[v]] = v;
+        }
+    }
+
+    // directed edges between positions, an edge without its reverse is on an open border
+    std::unordered_map<uint64_t, uint32_t> edges{};
+    auto countEdges = [&]() {
+        edges.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (size_t k = 0; k < 3; k++) {
+                edges[edgeKey(posOf[result[i + k]], posOf[result[i + (k + 1) % 3]])]++;
+            }
+        }
+    };
+    auto isBorderEdge = [&](uint32_t a, uint32_t b) {
+        return edges.contains(edgeKey(a, b)) != edges.contains(edgeKey(b, a));
+    };
+
+    std::vector<Quadric> quadrics(vertexCount);
+    countEdges();
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const auto& p0     = positions[result[i]];
+        const auto& p1     = positions[result[i + 1]];
+        const auto& p2     = positions[result[i + 2]];
+        glm::vec3   normal = glm::cross(p1 - p0, p2 - p0);
+        float       length = glm::length(normal);
+        if (length <= 0.0f) {
+            continue;
+        }
+        normal /= length;
+
+        auto plane = Quadric::fromPlane(normal, -glm::dot(normal, p0), length * 0.5f);
+        for (size_t k = 0; k < 3; k++) {
+            quadrics[posOf[result[i + k]]] += plane;
+        }
+        for (size_t k = 0; k < 3; k++) {
+            uint32_t a = posOf[result[i + k]], b = posOf[result[i + (k + 1) % 3]];
+            if (edges.contains(edgeKey(b, a))) {
+                continue;
+            }
+            glm::vec3 edge       = positions[b] - positions[a];
+            glm::vec3 sideNormal = glm::cross(edge, normal);
+            float     sideLength = glm::length(sideNormal);
+            if (sideLength <= 0.0f) {
+                continue;
+            }
+            sideNormal /= sideLength;
+            auto side = Quadric::fromPlane(sideNormal,
+                                           -glm::dot(sideNormal, positions[a]),
+                                           glm::dot(edge, edge) * borderWeight);
+            quadrics[a] += side;
+            quadrics[b] += side;
+        }
+    }
+
+    struct Collapse {
+        uint32_t from{};
+        uint32_t to{};
+        float    error{};
+    };
+
+    std::vector<uint32_t> adjOffset(vertexCount + 1);
+    std::vector<uint32_t> adjTris{};
+    std::vector<uint8_t>  kinds(vertexCount);
+    std::vector<uint8_t>  touched(vertexCount);
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<Collapse> candidates{};
+    std::vector<Collapse> targets{};
+    std::vector<uint32_t> fromRing{}, toRing{};
+
+    // the triangles around a position
+    auto getTris = [&](uint32_t pos) {
+        return std::span<const uint32_t>(adjTris.data() + adjOffset[pos],
+                                         adjOffset[pos + 1] - adjOffset[pos]);
+    };
+    auto cornerAt = [&](uint32_t tri, uint32_t pos) {
+        for (uint32_t k = 0; k < 3; k++) {
+            if (posOf[result[tri * 3 + k]] == pos) {
+                return result[tri * 3 + k];
+            }
+        }
+        return noVertex;
+    };
+
+    // every wedge of from moves to the wedge of to it shares a triangle with, which keeps the uv
+    // of every triangle on its side of a seam, false if a wedge has none or two of them
+    auto mapWedges = [&](uint32_t from, uint32_t to, bool apply) {
+        uint32_t wedge = from;
+        do {
+            uint32_t target = noVertex;
+            bool     used   = false;
+            for (auto tri : getTris(from)) {
+                if (cornerAt(tri, from) != wedge) {
+                    continue;
+                }
+                used        = true;
+                auto corner = cornerAt(tri, to);
+                if (corner == noVertex) {
+                    continue;
+                }
+                if (target != noVertex && target != corner) {
+                    return false;
+                }
+                target = corner;
+            }
+            if (used && target == noVertex) {
+                return false;
+            }
+            if (apply && used) {
+                remap[wedge] = target;
+            }
+            wedge = nextWedge[wedge];
+        } while (wedge != from);
+        return true;
+    };
+
+    auto getRing = [&](uint32_t pos, std::vector<uint32_t>& ring) {
+        ring.clear();
+        for (auto tri : getTris(pos)) {
+            for (uint32_t k = 0; k < 3; k++) {
+                auto other = posOf[result[tri * 3 + k]];
+                if (other != pos) {
+                    ring.push_back(other);
+                }
+            }
+        }
+        std::sort(ring.begin(), ring.end());
+        ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+    };
+
+    // the positions both ends are joined to may only be the ones opposite their edge, otherwise
+    // the collapse would join two sheets of the surface, and no triangle may turn over
+    auto canCollapse = [&](uint32_t from, uint32_t to) {
+        getRing(from, fromRing);
+        getRing(to, toRing);
+        uint32_t edgeTris = 0;
+        for (auto tri : getTris(from)) {
+            edgeTris += cornerAt(tri, to) != noVertex;
+        }
+        std::vector<uint32_t> shared{};
+        std::set_intersection(fromRing.begin(),
+                              fromRing.end(),
+                              toRing.begin(),
+                              toRing.end(),
+                              std::back_inserter(shared));
+        if (shared.size() != edgeTris) {
+            return false;
+        }
+
+        for (auto tri : getTris(from)) {
+            if (cornerAt(tri, to) != noVertex) {
+                continue;
+            }
+            std::array<glm::vec3, 3> corners{};
+            for (uint32_t k = 0; k < 3; k++) {
+                corners[k] = positions[posOf[result[tri * 3 + k]]];
+            }
+            glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+            for (auto& corner : corners) {
+                corner = corner == positions[from] ? positions[to] : corner;
+            }
+            glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+            if (glm::dot(before, after) <= 1e-2f * glm::length(before) * glm::length(after)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    float maxErrorSq = maxError * maxError;
+    float reachedSq  = 0.0f;
+    while (result.size() > targetIndexCount) {
+        const auto triCount = static_cast<uint32_t>(result.size() / 3);
+
+        std::fill(adjOffset.begin(), adjOffset.end(), 0u);
+        for (auto idx : result) {
+            adjOffset[posOf[idx] + 1]++;
+        }
+        std::partial_sum(adjOffset.begin(), adjOffset.end(), adjOffset.begin());
+        adjTris.resize(result.size());
+        {
+            std::vector<uint32_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+            for (uint32_t i = 0; i < result.size(); i++) {
+                adjTris[fill[posOf[result[i]]]++] = i / 3;
+            }
+        }
+
+        countEdges();
+        std::fill(kinds.begin(), kinds.end(), kindManifold);
+        for (const auto& [key, count] : edges) {
+            auto    a    = static_cast<uint32_t>(key >> 32);
+            auto    b    = static_cast<uint32_t>(key);
+            uint8_t kind = count > 1 ? kindLocked : isBorderEdge(a, b) ? kindBorder : kindManifold;
+            kinds[a]     = std::max(kinds[a], kind);
+            kinds[b]     = std::max(kinds[b], kind);
+        }
+
+        // the cheapest valid neighbour of every position
+        candidates.clear();
+        for (uint32_t pos = 0; pos < vertexCount; pos++) {
+            if (posOf[pos] != pos || kinds[pos] == kindLocked || getTris(pos).empty()) {
+                continue;
+            }
+            targets.clear();
+            for (auto tri : getTris(pos)) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    auto to = posOf[result[tri * 3 + k]];
+                    if (to == pos || (kinds[pos] == kindBorder && !isBorderEdge(pos, to))) {
+                        continue;
+                    }
+                    targets.push_back({pos, to, quadrics[pos].evaluate(positions[to])});
+                }
+            }
+            std::sort(targets.begin(), targets.end(), [](const Collapse& a, const Collapse& b) {
+                return a.error < b.error;
+            });
+            for (const auto& target : targets) {
+                if (mapWedges(pos, target.to, false)) {
+                    candidates.push_back(target);
+                    break;
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) {
+            return a.error < b.error;
+        });
+        // the cheaper half, the rest is looked at again once the mesh around them has changed
+        candidates.resize((candidates.size() + 1) / 2);
+
+        // a collapse only touches the triangles around from, so collapses whose neighbourhoods
+        // do not overlap are independent and done in the same pass
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(touched.begin(), touched.end(), uint8_t{0});
+        uint32_t removed = 0, collapsed = 0;
+        for (const auto& candidate : candidates) {
+            if (candidate.error > maxErrorSq || (triCount - removed) * 3 <= targetIndexCount) {
+                break;
+            }
+            auto [from, to, error] = candidate;
+            if (touched[from] || touched[to] || !canCollapse(from, to)) {
+                continue;
+            }
+
+            mapWedges(from, to, true);
+            quadrics[to] += quadrics[from];
+            reachedSq = std::max(reachedSq, error);
+            for (auto tri : getTris(from)) {
+                removed += cornerAt(tri, to) != noVertex;
+            }
+            touched[from] = touched[to] = 1;
+            for (auto pos : fromRing) {
+                touched[pos] = 1;
+            }
+            collapsed++;
+        }
+        if (collapsed == 0) {
+            break;
+        }
+
+        // triangles that lost a corner to the collapse are dropped
+        size_t kept = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            IdxType a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (posOf[a] == posOf[b] || posOf[b] == posOf[c] || posOf[a] == posOf[c]) {
+                continue;
+            }
+            result[kept++] = a;
+            result[kept++] = b;
+            result[kept++] = c;
+        }
+        result.resize(kept);
+    }
+    return std::sqrt(reachedSq);
+}
+
+uint32_t buildLodChain(std::span<const Vertex> vertices,
+                       std::vector<IdxType>&   indices,
+                       std::span<MeshLod>      lods,
+                       float                   maxError) {
+    if (lods.empty()) {
+        return 0;
+    }
+    lods[0] = {0, static_cast<uint32_t>(indices.size()), 0.0f};
+
+    auto      bounds = computeBounds(vertices);
+    glm::vec3 size   = bounds.boxMax - bounds.boxMin;
+    float     extent = std::max(size.x, std::max(size.y, size.z));
+
+    uint32_t             lodCount = 1;
+    std::vector<IdxType> source(indices.begin(), indices.end());
+    std::vector<IdxType> level{};
+    while (lodCount < lods.size()) {
+        const auto& previous = lods[lodCount - 1];
+        size_t      target   = source.size() / 6 * 3;
+        float       error    = simplifyMesh(vertices, source, target, maxError, level);
+        if (level.empty() || level.size() * 4 > source.size() * 3) {
+            break;
+        }
+
+        lods[lodCount] = {static_cast<uint32_t>(indices.size()),
+                          static_cast<uint32_t>(level.size()),
+                          previous.error + error * extent};
+        indices.insert(indices.end(), level.begin(), level.end());
+        source.swap(level);
+        lodCount++;
+    }
+    return lodCount;
+}
+
+} // namespace TBE::Resource::Mesh
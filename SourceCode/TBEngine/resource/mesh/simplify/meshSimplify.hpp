@@ -0,0 +1,47 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+#include <vector>
+
+namespace TBE::Resource::Mesh {
+
+// how far a level may move the surface at most, relative to the largest side of the mesh box
+constexpr float defaultLodMaxError = 0.05f;
+
+/**
+ * @brief Collapse edges of a triangle list until it is down to targetIndexCount indices or the
+ * next collapse would move the surface further than maxError.
+ *
+ * @details Garland, Heckbert, "Surface Simplification Using Quadric Error Metrics", 1997. Every
+ * collapse moves a vertex onto one of its neighbours, so the result indexes the input vertices and
+ * needs no vertex blob of its own. Vertices sharing a position with another uv are only collapsed
+ * along the uv seam, vertices on an open border only along the border, vertices on a non manifold
+ * edge never. Collapses that flip a triangle or join two sheets of the surface are skipped.
+ *
+ * @param maxError relative to the largest side of the bounding box of the vertices
+ * @return the largest error of a collapse, relative the same way
+ */
+float simplifyMesh(std::span<const Math::DataFormat::Vertex>  vertices,
+                   std::span<const Math::DataFormat::IdxType> indices,
+                   size_t                                     targetIndexCount,
+                   float                                      maxError,
+                   std::vector<Math::DataFormat::IdxType>&    result);
+
+/**
+ * @brief Append coarser levels of detail behind the indices of a mesh.
+ *
+ * @details Every level is simplified from the one before it to about half of its triangles, and
+ * its error adds up those of the levels before. The chain ends early once a level saves less than
+ * a quarter of the triangles. lods[0] is set to the input indices.
+ *
+ * @param lods receives the levels, at most lods.size() of them
+ * @return how many levels were set, 1 if the mesh could not be simplified
+ */
+uint32_t buildLodChain(std::span<const Math::DataFormat::Vertex> vertices,
+                       std::vector<Math::DataFormat::IdxType>&   indices,
+                       std::span<Math::DataFormat::MeshLod>      lods,
+                       float                                     maxError = defaultLodMaxError);
+
+} // namespace TBE::Resource::Mesh
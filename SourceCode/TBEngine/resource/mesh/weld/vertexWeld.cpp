@@ -0,0 +1,253 @@
+#include "vertexWeld.hpp"
+#include "TBEngine/utils/parallel/parallel.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace TBE::Resource::Mesh {
+
+using Math::DataFormat::hashVertex;
+using Math::DataFormat::IdxType;
+using Math::DataFormat::Vertex;
+
+namespace {
+
+// eAuto switches to eSort from this many corners
+constexpr size_t sortModeThreshold = 1 << 22;
+constexpr size_t parallelBatch     = 1 << 14;
+
+constexpr IdxType emptySlot = std::numeric_limits<IdxType>::max();
+
+void weldHash(std::span<const Vertex> corners,
+              std::vector<Vertex>&    vertices,
+              std::vector<IdxType>&   indices) {
+    // the table never holds more than corners.size() entries, keep the load factor under 2/3
+    size_t capacity = std::bit_ceil(std::max<size_t>(16, corners.size() + corners.size() / 2));
+    size_t mask     = capacity - 1;
+
+    // the upper half of the hash is kept beside the index, so most mismatches never touch vertices
+    struct Slot {
+        uint32_t tag = 0;
+        IdxType  idx = emptySlot;
+    };
+    std::vector<Slot> table(capacity);
+
+    for (const auto& vertex : corners) {
+        uint64_t hash = hashVertex(vertex);
+        auto     tag  = static_cast<uint32_t>(hash >> 32);
+        size_t   pos  = static_cast<size_t>(hash) & mask;
+
+        while (true) {
+            Slot& slot = table[pos];
+            if (slot.idx == emptySlot) {
+                slot = {tag, static_cast<IdxType>(vertices.size())};
+                indices.push_back(slot.idx);
+                vertices.push_back(vertex);
+                break;
+            }
+            if (slot.tag == tag && vertices[slot.idx] == vertex) {
+                indices.push_back(slot.idx);
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+}
+
+void weldSort(std::span<const Vertex> corners,
+              std::vector<Vertex>&    vertices,
+              std::vector<IdxType>&   indices) {
+    const size_t count = corners.size();
+
+    struct Key {
+        uint64_t hash;
+        IdxType  corner;
+    };
+    std::vector<Key> keys(count);
+    Utils::parallelFor(count, parallelBatch, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            keys[i] = {hashVertex(corners[i]), static_cast<IdxType>(i)};
+        }
+    });
+
+    // ties are broken by corner index, so the first corner of a run is its first occurrence
+    Utils::parallelSort(keys.begin(), keys.end(), [](const Key& a, const Key& b) {
+        return a.hash < b.hash || (a.hash == b.hash && a.corner < b.corner);
+    });
+
+    // firstOf[i] is the first corner equal to corner i
+    std::vector<IdxType> firstOf(count);
+    Utils::parallelFor(count, parallelBatch, [&](size_t begin, size_t end) {
+        // a run of equal hashes belongs to the range its first key falls into
+        while (begin > 0 && begin < end && keys[begin].hash == keys[begin - 1].hash) {
+            begin++;
+        }
+        while (end < count && keys[end].hash == keys[end - 1].hash) {
+            end++;
+        }
+
+        std::vector<IdxType> distinct{}; // first corners of the distinct vertices in a run
+        for (size_t runBegin = begin; runBegin < end;) {
+            size_t runEnd = runBegin + 1;
+            while (runEnd < count && keys[runEnd].hash == keys[runBegin].hash) {
+                runEnd++;
+            }
+
+            distinct.clear();
+            for (size_t i = runBegin; i < runEnd; i++) {
+                IdxType corner = keys[i].corner;
+                IdxType first  = corner;
+                for (IdxType candidate : distinct) { // only more than one on a hash collision
+                    if (corners[candidate] == corners[corner]) {
+                        first = candidate;
+                        break;
+                    }
+                }
+                if (first == corner) {
+                    distinct.push_back(corner);
+                }
+                firstOf[corner] = first;
+            }
+            runBegin = runEnd;
+        }
+    });
+    keys = {};
+
+    // number the first occurrences in corner order with a two pass prefix sum
+    const size_t        numBlocks = (count + parallelBatch - 1) / parallelBatch;
+    std::vector<size_t> blockBase(numBlocks + 1, 0);
+    Utils::parallelFor(numBlocks, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            size_t num = 0;
+            for (size_t i = block * parallelBatch; i < std::min(count, (block + 1) * parallelBatch);
+                 i++) {
+                num += firstOf[i] == i;
+            }
+            blockBase[block + 1] = num;
+        }
+    });
+    for (size_t block = 0; block < numBlocks; block++) {
+        blockBase[block + 1] += blockBase[block];
+    }
+
+    vertices.resize(blockBase[numBlocks]);
+    indices.resize(count);
+    Utils::parallelFor(numBlocks, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            auto next = static_cast<IdxType>(blockBase[block]);
+            for (size_t i = block * parallelBatch; i < std::min(count, (block + 1) * parallelBatch);
+                 i++) {
+                if (firstOf[i] == i) {
+                    vertices[next] = corners[i];
+                    indices[i]     = next++;
+                }
+            }
+        }
+    });
+
+    // a first occurrence always comes before the corners pointing at it
+    Utils::parallelFor(count, parallelBatch, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (firstOf[i] != i) {
+                indices[i] = indices[firstOf[i]];
+            }
+        }
+    });
+}
+
+} // namespace
+
+void weldVertices(std::span<const Vertex> corners,
+                  std::vector<Vertex>&    vertices,
+                  std::vector<IdxType>&   indices,
+                  WeldMode                mode) {
+    vertices.clear();
+    indices.clear();
+    if (corners.size() >= emptySlot) {
+        Utils::Log::logErrorMsg("too many corners to be indexed by IdxType");
+    }
+
+    if (mode == WeldMode::eAuto) {
+        mode = (corners.size() >= sortModeThreshold && Utils::workerCount() > 1) ? WeldMode::eSort
+                                                                                  : WeldMode::eHash;
+    }
+
+    if (mode == WeldMode::eSort) {
+        weldSort(corners, vertices, indices);
+    } else {
+        indices.reserve(corners.size());
+        weldHash(corners, vertices, indices);
+    }
+}
+
+// what ModelFile welded with before weldVertices, a node based map with a xor / shift hash and two
+// lookups per corner
+struct LegacyVertexHash {
+    size_t operator()(const Vertex& vertex) const {
+        auto pos   = std::hash<glm::vec3>()(vertex.pos);
+        auto color = std::hash<glm::vec3>()(vertex.color);
+        return ((pos ^ (color << 1)) >> 1) ^ (std::hash<glm::vec2>()(vertex.texCoord) << 1);
+    }
+};
+
+static void weldLegacy(std::span<const Vertex> corners,
+                       std::vector<Vertex>&    vertices,
+                       std::vector<IdxType>&   indices) {
+    vertices.clear();
+    indices.clear();
+    std::unordered_map<Vertex, IdxType, LegacyVertexHash> uniqueVertices{};
+
+    indices.reserve(corners.size());
+    for (const auto& vertex : corners) {
+        if (uniqueVertices.count(vertex) == 0) {
+            uniqueVertices[vertex] = static_cast<IdxType>(vertices.size());
+            vertices.push_back(vertex);
+        }
+        indices.push_back(uniqueVertices[vertex]);
+    }
+}
+
+void benchmarkWeld(std::span<const Vertex> corners, std::string_view name) {
+    std::vector<Vertex>  refVertices{}, vertices{};
+    std::vector<IdxType> refIndices{}, indices{};
+
+    struct Candidate {
+        const char*           label;
+        std::function<void()> weld;
+    };
+    std::array<Candidate, 3> candidates{
+        Candidate{"unordered_map", [&]() { weldLegacy(corners, vertices, indices); }},
+        Candidate{"hash", [&]() { weldVertices(corners, vertices, indices, WeldMode::eHash); }},
+        Candidate{"sort", [&]() { weldVertices(corners, vertices, indices, WeldMode::eSort); }}};
+
+    std::string report{};
+    for (size_t i = 0; i < candidates.size(); i++) {
+        // the fastest of a few runs
+        double bestMs = std::numeric_limits<double>::max();
+        for (int run = 0; run < 3; run++) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            candidates[i].weld();
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto ms      = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+            bestMs       = std::min(bestMs, ms);
+        }
+        if (i == 0) {
+            refVertices = vertices;
+            refIndices  = indices;
+        }
+        bool same = vertices == refVertices && indices == refIndices;
+        report += std::string(i > 0 ? ", " : "") + candidates[i].label + " " +
+                  std::to_string(corners.size() / std::max(bestMs, 1e-6) / 1000.0) +
+                  " M corners/s" + (same ? "" : " (DIFFERS)");
+    }
+    logger->info("weld benchmark, " + std::string(name) + ": " + std::to_string(corners.size()) +
+                 " corners into " + std::to_string(refVertices.size()) + " vertices, " + report);
+}
+
+} // namespace TBE::Resource::Mesh
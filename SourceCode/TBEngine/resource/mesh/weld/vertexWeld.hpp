@@ -0,0 +1,37 @@
+#pragma once
+
+#include "TBEngine/core/math/dataFormat.hpp"
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace TBE::Resource::Mesh {
+
+enum class WeldMode
+{
+    eAuto = 0, // eSort for large inputs on a multicore machine, eHash otherwise
+    eHash,     // single thread, open addressing table keyed by Math::DataFormat::hashVertex
+    eSort,     // multithreaded, sort corners by hash and merge equal runs
+};
+
+/**
+ * @brief Merge equal corners into unique vertices and an index buffer.
+ *
+ * @details Every mode keeps unique vertices in first-seen order, so the output is the same as
+ * inserting the corners one by one into a map, whatever mode is picked.
+ *
+ * @param corners  one vertex per face corner
+ * @param vertices receives the unique vertices, cleared first
+ * @param indices  receives one index per corner, cleared first
+ */
+void weldVertices(std::span<const Math::DataFormat::Vertex> corners,
+                  std::vector<Math::DataFormat::Vertex>&    vertices,
+                  std::vector<Math::DataFormat::IdxType>&   indices,
+                  WeldMode                                  mode = WeldMode::eAuto);
+
+// log corners per second of both modes and of the std::unordered_map loop ModelFile used before,
+// and whether every mode welds the corners the same way, name says which mesh they are
+void benchmarkWeld(std::span<const Math::DataFormat::Vertex> corners, std::string_view name);
+
+} // namespace TBE::Resource::Mesh
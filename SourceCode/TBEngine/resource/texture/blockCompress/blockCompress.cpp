@@ -0,0 +1,634 @@
+#include "blockCompress.hpp"
+#include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/utils/parallel/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace TBE::Resource::Texture {
+
+using Pixel = std::array<uint8_t, 4>;
+using Block = std::array<Pixel, 16>;
+
+// 4x4 pixels starting at (bx, by) in blocks, clamped to the level
+static void loadBlock(const uint8_t* level,
+                      uint32_t       width,
+                      uint32_t       height,
+                      uint32_t       bx,
+                      uint32_t       by,
+                      Block&         block) {
+    for (uint32_t y = 0; y < 4; y++) {
+        uint32_t sy = std::min(by * 4 + y, height - 1);
+        for (uint32_t x = 0; x < 4; x++) {
+            uint32_t sx = std::min(bx * 4 + x, width - 1);
+            auto     src = (static_cast<size_t>(sy) * width + sx) * 4;
+            std::memcpy(block[y * 4 + x].data(), level + src, 4);
+        }
+    }
+}
+
+static void storeBlock(const Block& block,
+                       uint8_t*     level,
+                       uint32_t     width,
+                       uint32_t     height,
+                       uint32_t     bx,
+                       uint32_t     by) {
+    for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++) {
+        for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++) {
+            auto dst = (static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4;
+            std::memcpy(level + dst, block[y * 4 + x].data(), 4);
+        }
+    }
+}
+
+template <size_t N>
+using Vec = std::array<float, N>;
+
+template <size_t N>
+static float dot(const Vec<N>& a, const Vec<N>& b) {
+    float sum = 0.0f;
+    for (size_t c = 0; c < N; c++) {
+        sum += a[c] * b[c];
+    }
+    return sum;
+}
+
+/**
+ * Mean and principal axis of the first N channels of a block, found by power iteration on the
+ * covariance. The axis starts along the bounding box diagonal, which is close for most blocks.
+ */
+template <size_t N>
+static void principalAxis(const Block& block, Vec<N>& mean, Vec<N>& axis) {
+    Vec<N> lo{}, hi{};
+    lo.fill(255.0f);
+    mean.fill(0.0f);
+    for (const auto& px : block) {
+        for (size_t c = 0; c < N; c++) {
+            mean[c] += px[c] / 16.0f;
+            lo[c] = std::min(lo[c], static_cast<float>(px[c]));
+            hi[c] = std::max(hi[c], static_cast<float>(px[c]));
+        }
+    }
+
+    std::array<Vec<N>, N> cov{};
+    for (const auto& px : block) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                cov[i][j] += (px[i] - mean[i]) * (px[j] - mean[j]);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < N; c++) {
+        axis[c] = hi[c] - lo[c];
+    }
+    for (int iter = 0; iter < 8; iter++) {
+        Vec<N> next{};
+        for (size_t i = 0; i < N; i++) {
+            next[i] = dot(cov[i], axis);
+        }
+        float len = std::sqrt(dot(next, next));
+        if (len < 1e-6f) {
+            break;
+        }
+        for (size_t c = 0; c < N; c++) {
+            axis[c] = next[c] / len;
+        }
+    }
+    float len = std::sqrt(dot(axis, axis));
+    for (size_t c = 0; c < N; c++) {
+        axis[c] = len > 1e-6f ? axis[c] / len : 0.0f;
+    }
+}
+
+// endpoints at the extremes of the block projected on its principal axis
+template <size_t N>
+static void fitEndpoints(const Block& block, Vec<N>& e0, Vec<N>& e1) {
+    Vec<N> mean{}, axis{};
+    principalAxis<N>(block, mean, axis);
+
+    float tMin = std::numeric_limits<float>::max(), tMax = std::numeric_limits<float>::lowest();
+    for (const auto& px : block) {
+        float t = 0.0f;
+        for (size_t c = 0; c < N; c++) {
+            t += (px[c] - mean[c]) * axis[c];
+        }
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    for (size_t c = 0; c < N; c++) {
+        e0[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    }
+}
+
+/**
+ * Endpoints minimizing the squared error for fixed interpolation weights, pixel i is
+ * weights[i] * e0 + (1 - weights[i]) * e1. Return false if the weights do not separate the
+ * endpoints.
+ */
+template <size_t N>
+static bool solveEndpoints(const Block&                 block,
+                           const std::array<float, 16>& weights,
+                           Vec<N>&                      e0,
+                           Vec<N>&                      e1) {
+    float  aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    Vec<N> ap{}, bp{};
+    for (size_t i = 0; i < 16; i++) {
+        float a = weights[i], b = 1.0f - weights[i];
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (size_t c = 0; c < N; c++) {
+            ap[c] += a * block[i][c];
+            bp[c] += b * block[i][c];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) {
+        return false;
+    }
+    for (size_t c = 0; c < N; c++) {
+        e0[c] = std::clamp((ap[c] * bb - bp[c] * ab) / det, 0.0f, 255.0f);
+        e1[c] = std::clamp((bp[c] * aa - ap[c] * ab) / det, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// BC1
+
+static uint16_t to565(const Vec<3>& color) {
+    auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+    auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+    auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+static std::array<int32_t, 3> from565(uint16_t value) {
+    int32_t r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+// four color palette in index order, the one BC3 always uses
+static std::array<std::array<int32_t, 3>, 4> bc1Palette(uint16_t c0, uint16_t c1) {
+    auto p0 = from565(c0), p1 = from565(c1);
+    std::array<std::array<int32_t, 3>, 4> palette{p0, p1};
+    for (size_t c = 0; c < 3; c++) {
+        palette[2][c] = (2 * p0[c] + p1[c]) / 3;
+        palette[3][c] = (p0[c] + 2 * p1[c]) / 3;
+    }
+    return palette;
+}
+
+struct Bc1Candidate {
+    uint16_t c0{}, c1{};
+    uint32_t indices{};
+    uint32_t error = std::numeric_limits<uint32_t>::max();
+};
+
+static Bc1Candidate evaluateBc1(const Block& block, uint16_t c0, uint16_t c1) {
+    auto         palette = bc1Palette(c0, c1);
+    Bc1Candidate ret{c0, c1, 0, 0};
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t best = 0, bestErr = std::numeric_limits<uint32_t>::max();
+        for (uint32_t p = 0; p < 4; p++) {
+            uint32_t err = 0;
+            for (size_t c = 0; c < 3; c++) {
+                int32_t d = block[i][c] - palette[p][c];
+                err += static_cast<uint32_t>(d * d);
+            }
+            if (err < bestErr) {
+                best    = p;
+                bestErr = err;
+            }
+        }
+        ret.indices |= best << (i * 2);
+        ret.error += bestErr;
+    }
+    return ret;
+}
+
+static void encodeBc1Block(const Block& block, uint8_t* out) {
+    Vec<3> e0{}, e1{};
+    fitEndpoints<3>(block, e0, e1);
+    auto best = evaluateBc1(block, to565(e0), to565(e1));
+
+    // weight of c0 for each palette index
+    constexpr std::array<float, 4> indexWeights = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    for (int iter = 0; iter < 2 && best.error > 0; iter++) {
+        std::array<float, 16> weights{};
+        for (uint32_t i = 0; i < 16; i++) {
+            weights[i] = indexWeights[(best.indices >> (i * 2)) & 3];
+        }
+        if (!solveEndpoints<3>(block, weights, e0, e1)) {
+            break;
+        }
+        auto refined = evaluateBc1(block, to565(e0), to565(e1));
+        if (refined.error >= best.error) {
+            break;
+        }
+        best = refined;
+    }
+
+    // c0 > c1 selects the four color mode, swapping the endpoints swaps 0 <-> 1 and 2 <-> 3
+    if (best.c0 < best.c1) {
+        std::swap(best.c0, best.c1);
+        best.indices ^= 0x55555555u;
+    } else if (best.c0 == best.c1) {
+        best.indices = 0;
+    }
+    std::memcpy(out, &best.c0, 2);
+    std::memcpy(out + 2, &best.c1, 2);
+    std::memcpy(out + 4, &best.indices, 4);
+}
+
+static void decodeBc1Block(const uint8_t* in, Block& block, bool fourColorOnly, bool punchAlpha) {
+    uint16_t c0{}, c1{};
+    uint32_t indices{};
+    std::memcpy(&c0, in, 2);
+    std::memcpy(&c1, in + 2, 2);
+    std::memcpy(&indices, in + 4, 4);
+
+    auto palette    = bc1Palette(c0, c1);
+    bool threeColor = !fourColorOnly && c0 <= c1;
+    if (threeColor) {
+        auto p0 = from565(c0), p1 = from565(c1);
+        for (size_t c = 0; c < 3; c++) {
+            palette[2][c] = (p0[c] + p1[c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t p = (indices >> (i * 2)) & 3;
+        for (size_t c = 0; c < 3; c++) {
+            block[i][c] = static_cast<uint8_t>(palette[p][c]);
+        }
+        block[i][3] = threeColor && p == 3 && punchAlpha ? 0 : 255;
+    }
+}
+
+// BC4, one channel, also the alpha of BC3 and both channels of BC5
+
+static void encodeBc4Block(const Block& block, size_t channel, uint8_t* out) {
+    uint8_t lo = 255, hi = 0;
+    for (const auto& px : block) {
+        lo = std::min(lo, px[channel]);
+        hi = std::max(hi, px[channel]);
+    }
+    std::memset(out, 0, 8);
+    out[0] = hi;
+    out[1] = lo;
+    if (hi == lo) {
+        return;
+    }
+
+    // hi > lo selects the eight value mode
+    std::array<int32_t, 8> palette{hi, lo};
+    for (int32_t i = 2; i < 8; i++) {
+        palette[i] = ((8 - i) * hi + (i - 1) * lo) / 7;
+    }
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        uint64_t best    = 0;
+        int32_t  bestErr = std::numeric_limits<int32_t>::max();
+        for (uint32_t p = 0; p < 8; p++) {
+            int32_t err = std::abs(block[i][channel] - palette[p]);
+            if (err < bestErr) {
+                best    = p;
+                bestErr = err;
+            }
+        }
+        indices |= best << (i * 3);
+    }
+    for (size_t b = 0; b < 6; b++) {
+        out[2 + b] = static_cast<uint8_t>(indices >> (b * 8));
+    }
+}
+
+static void decodeBc4Block(const uint8_t* in, Block& block, size_t channel) {
+    int32_t                a0 = in[0], a1 = in[1];
+    std::array<int32_t, 8> palette{a0, a1};
+    if (a0 > a1) {
+        for (int32_t i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        }
+    } else {
+        for (int32_t i = 2; i < 6; i++) {
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t indices = 0;
+    for (size_t b = 0; b < 6; b++) {
+        indices |= static_cast<uint64_t>(in[2 + b]) << (b * 8);
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+        block[i][channel] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+    }
+}
+
+// BC7 mode 6, RGBA endpoints of 7 bits plus a shared lowest bit each, 4 bit indices
+
+static constexpr std::array<int32_t, 16> bc7Weights4 = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// little endian bit stream of a 128 bit block
+class BlockBits {
+public:
+    explicit BlockBits(uint8_t* bytes_) : bytes(bytes_) {}
+
+    void write(uint32_t value, uint32_t count) {
+        for (uint32_t b = 0; b < count; b++, pos++) {
+            bytes[pos / 8] |= static_cast<uint8_t>(((value >> b) & 1) << (pos % 8));
+        }
+    }
+    uint32_t read(uint32_t count) {
+        uint32_t value = 0;
+        for (uint32_t b = 0; b < count; b++, pos++) {
+            value |= static_cast<uint32_t>((bytes[pos / 8] >> (pos % 8)) & 1) << b;
+        }
+        return value;
+    }
+
+private:
+    uint8_t* bytes{};
+    uint32_t pos{};
+};
+
+struct Bc7Candidate {
+    std::array<Pixel, 2>    endpoints{}; // 7 bit values
+    std::array<uint32_t, 2> pBits{};
+    std::array<uint8_t, 16> indices{};
+    uint64_t                error = std::numeric_limits<uint64_t>::max();
+};
+
+static Pixel bc7Expand(const Pixel& endpoint, uint32_t pBit) {
+    Pixel ret{};
+    for (size_t c = 0; c < 4; c++) {
+        ret[c] = static_cast<uint8_t>(endpoint[c] << 1 | pBit);
+    }
+    return ret;
+}
+
+static void evaluateBc7(const Block& block, Bc7Candidate& candidate) {
+    auto e0 = bc7Expand(candidate.endpoints[0], candidate.pBits[0]);
+    auto e1 = bc7Expand(candidate.endpoints[1], candidate.pBits[1]);
+
+    std::array<Pixel, 16> palette{};
+    for (size_t p = 0; p < 16; p++) {
+        for (size_t c = 0; c < 4; c++) {
+            palette[p][c] = static_cast<uint8_t>(
+                ((64 - bc7Weights4[p]) * e0[c] + bc7Weights4[p] * e1[c] + 32) >> 6);
+        }
+    }
+    candidate.error = 0;
+    for (size_t i = 0; i < 16; i++) {
+        uint32_t bestErr = std::numeric_limits<uint32_t>::max();
+        for (uint8_t p = 0; p < 16; p++) {
+            uint32_t err = 0;
+            for (size_t c = 0; c < 4; c++) {
+                int32_t d = block[i][c] - palette[p][c];
+                err += static_cast<uint32_t>(d * d);
+            }
+            if (err < bestErr) {
+                candidate.indices[i] = p;
+                bestErr              = err;
+            }
+        }
+        candidate.error += bestErr;
+    }
+}
+
+// try every pair of p-bits for the float endpoints and keep the best
+static void quantizeBc7(const Block&  block,
+                        const Vec<4>& e0,
+                        const Vec<4>& e1,
+                        Bc7Candidate& best) {
+    const std::array<const Vec<4>*, 2> ends = {&e0, &e1};
+    for (uint32_t pBits = 0; pBits < 4; pBits++) {
+        Bc7Candidate candidate{};
+        for (size_t e = 0; e < 2; e++) {
+            candidate.pBits[e] = (pBits >> e) & 1;
+            for (size_t c = 0; c < 4; c++) {
+                float q  = ((*ends[e])[c] - static_cast<float>(candidate.pBits[e])) / 2.0f;
+                auto  q7 = std::clamp(static_cast<int32_t>(std::lround(q)), 0, 127);
+                candidate.endpoints[e][c] = static_cast<uint8_t>(q7);
+            }
+        }
+        evaluateBc7(block, candidate);
+        if (candidate.error < best.error) {
+            best = candidate;
+        }
+    }
+}
+
+static void encodeBc7Block(const Block& block, uint8_t* out) {
+    Vec<4> e0{}, e1{};
+    fitEndpoints<4>(block, e0, e1);
+
+    Bc7Candidate best{};
+    quantizeBc7(block, e0, e1, best);
+    if (best.error > 0) {
+        std::array<float, 16> weights{};
+        for (size_t i = 0; i < 16; i++) {
+            weights[i] = static_cast<float>(64 - bc7Weights4[best.indices[i]]) / 64.0f;
+        }
+        if (solveEndpoints<4>(block, weights, e0, e1)) {
+            quantizeBc7(block, e0, e1, best);
+        }
+    }
+
+    // the top bit of the first index is implied 0, swap the endpoints to get there
+    if (best.indices[0] >= 8) {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        std::swap(best.pBits[0], best.pBits[1]);
+        for (auto& idx : best.indices) {
+            idx = static_cast<uint8_t>(15 - idx);
+        }
+    }
+
+    std::memset(out, 0, 16);
+    BlockBits bits(out);
+    bits.write(1 << 6, 7);
+    for (size_t c = 0; c < 4; c++) {
+        bits.write(best.endpoints[0][c], 7);
+        bits.write(best.endpoints[1][c], 7);
+    }
+    bits.write(best.pBits[0], 1);
+    bits.write(best.pBits[1], 1);
+    bits.write(best.indices[0], 3);
+    for (size_t i = 1; i < 16; i++) {
+        bits.write(best.indices[i], 4);
+    }
+}
+
+static bool decodeBc7Block(const uint8_t* in, Block& block) {
+    if ((in[0] & 0x7F) != 1 << 6) {
+        return false;
+    }
+    std::array<uint8_t, 16> bytes{};
+    std::memcpy(bytes.data(), in, 16);
+    BlockBits bits(bytes.data());
+    bits.read(7);
+
+    std::array<Pixel, 2> endpoints{};
+    for (size_t c = 0; c < 4; c++) {
+        endpoints[0][c] = static_cast<uint8_t>(bits.read(7));
+        endpoints[1][c] = static_cast<uint8_t>(bits.read(7));
+    }
+    auto e0 = bc7Expand(endpoints[0], bits.read(1));
+    auto e1 = bc7Expand(endpoints[1], bits.read(1));
+    for (size_t i = 0; i < 16; i++) {
+        auto w = bc7Weights4[bits.read(i == 0 ? 3 : 4)];
+        for (size_t c = 0; c < 4; c++) {
+            block[i][c] = static_cast<uint8_t>(((64 - w) * e0[c] + w * e1[c] + 32) >> 6);
+        }
+    }
+    return true;
+}
+
+static void encodeBlock(const Block& block, TextureFormat format, uint8_t* out) {
+    switch (format) {
+        case TextureFormat::eBC1RGBUnorm:
+        case TextureFormat::eBC1RGBSrgb:
+        case TextureFormat::eBC1RGBAUnorm:
+        case TextureFormat::eBC1RGBASrgb: encodeBc1Block(block, out); break;
+        case TextureFormat::eBC3Unorm:
+        case TextureFormat::eBC3Srgb:
+            encodeBc4Block(block, 3, out);
+            encodeBc1Block(block, out + 8);
+            break;
+        case TextureFormat::eBC4Unorm: encodeBc4Block(block, 0, out); break;
+        case TextureFormat::eBC5Unorm:
+            encodeBc4Block(block, 0, out);
+            encodeBc4Block(block, 1, out + 8);
+            break;
+        case TextureFormat::eBC7Unorm:
+        case TextureFormat::eBC7Srgb: encodeBc7Block(block, out); break;
+        default: break;
+    }
+}
+
+static bool decodeBlock(const uint8_t* in, TextureFormat format, Block& block) {
+    switch (format) {
+        case TextureFormat::eBC1RGBUnorm:
+        case TextureFormat::eBC1RGBSrgb: decodeBc1Block(in, block, false, false); return true;
+        case TextureFormat::eBC1RGBAUnorm:
+        case TextureFormat::eBC1RGBASrgb: decodeBc1Block(in, block, false, true); return true;
+        case TextureFormat::eBC3Unorm:
+        case TextureFormat::eBC3Srgb:
+            decodeBc1Block(in + 8, block, true, false);
+            decodeBc4Block(in, block, 3);
+            return true;
+        case TextureFormat::eBC4Unorm:
+            decodeBc4Block(in, block, 0);
+            for (auto& px : block) {
+                px = {px[0], 0, 0, 255};
+            }
+            return true;
+        case TextureFormat::eBC5Unorm:
+            decodeBc4Block(in, block, 0);
+            decodeBc4Block(in + 8, block, 1);
+            for (auto& px : block) {
+                px[2] = 0;
+                px[3] = 255;
+            }
+            return true;
+        case TextureFormat::eBC7Unorm:
+        case TextureFormat::eBC7Srgb: return decodeBc7Block(in, block);
+        default: return false;
+    }
+}
+
+std::vector<TextureMip> compressMipChain(std::span<const std::byte> chain,
+                                         std::span<const TextureMip> mips,
+                                         TextureFormat               format,
+                                         std::vector<std::byte>&     out) {
+    const uint32_t blockBytes = getBlockBytes(format);
+    if (!isBlockCompressed(format)) {
+        Utils::Log::logErrorMsg("not a block compressed format: " + std::string(toString(format)));
+    }
+
+    std::vector<TextureMip> outMips(mips.size());
+    uint64_t                offset = 0;
+    for (size_t i = 0; i < mips.size(); i++) {
+        outMips[i]        = mips[i];
+        outMips[i].offset = offset;
+        outMips[i].size   = getLevelSize(format, mips[i].width, mips[i].height);
+        offset += outMips[i].size;
+    }
+    out.resize(offset);
+
+    for (size_t i = 0; i < mips.size(); i++) {
+        const auto* src     = reinterpret_cast<const uint8_t*>(chain.data() + mips[i].offset);
+        auto*       dst     = reinterpret_cast<uint8_t*>(out.data() + outMips[i].offset);
+        uint32_t    width   = mips[i].width;
+        uint32_t    height  = mips[i].height;
+        uint32_t    blocksX = (width + 3) / 4;
+
+        Utils::parallelFor((height + 3) / 4, 4, [&](size_t rowBegin, size_t rowEnd) {
+            Block block{};
+            for (size_t by = rowBegin; by < rowEnd; by++) {
+                for (uint32_t bx = 0; bx < blocksX; bx++) {
+                    loadBlock(src, width, height, bx, static_cast<uint32_t>(by), block);
+                    encodeBlock(block, format, dst + (by * blocksX + bx) * blockBytes);
+                }
+            }
+        });
+    }
+    return outMips;
+}
+
+bool decompressMipChain(std::span<const std::byte> chain,
+                        std::span<const TextureMip> mips,
+                        TextureFormat               format,
+                        std::vector<std::byte>&     out,
+                        std::vector<TextureMip>&    outMips) {
+    const uint32_t blockBytes = getBlockBytes(format);
+    if (!isBlockCompressed(format)) {
+        return false;
+    }
+
+    outMips.resize(mips.size());
+    uint64_t offset = 0;
+    for (size_t i = 0; i < mips.size(); i++) {
+        outMips[i]        = mips[i];
+        outMips[i].offset = offset;
+        outMips[i].size   = getLevelSize(TextureFormat::eRGBA8Unorm, mips[i].width, mips[i].height);
+        offset += outMips[i].size;
+    }
+    out.resize(offset);
+
+    bool ok = true;
+    for (size_t i = 0; i < mips.size() && ok; i++) {
+        const auto* src     = reinterpret_cast<const uint8_t*>(chain.data() + mips[i].offset);
+        auto*       dst     = reinterpret_cast<uint8_t*>(out.data() + outMips[i].offset);
+        uint32_t    width   = mips[i].width;
+        uint32_t    height  = mips[i].height;
+        uint32_t    blocksX = (width + 3) / 4;
+
+        // a rejected block only ever turns the flag off
+        std::atomic_bool levelOk = true;
+        Utils::parallelFor((height + 3) / 4, 4, [&](size_t rowBegin, size_t rowEnd) {
+            Block block{};
+            for (size_t by = rowBegin; by < rowEnd; by++) {
+                for (uint32_t bx = 0; bx < blocksX; bx++) {
+                    if (!decodeBlock(src + (by * blocksX + bx) * blockBytes, format, block)) {
+                        levelOk = false;
+                        return;
+                    }
+                    storeBlock(block, dst, width, height, bx, static_cast<uint32_t>(by));
+                }
+            }
+        });
+        ok = levelOk;
+    }
+    return ok;
+}
+
+} // namespace TBE::Resource::Texture
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "TBEngine/resource/texture/mipmap/mipmap.hpp"
+#include "TBEngine/resource/texture/textureFormat/textureFormat.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace TBE::Resource::Texture {
+
+/**
+ * @brief Encode an RGBA8 mip chain into a BC format.
+ *
+ * @details BC1 and BC3 fit the color endpoints along the principal axis of each block and refine
+ * them by least squares, BC3 alpha, BC4 and BC5 use the range of the block. BC7 is written in
+ * mode 6 only, a single RGBA subset with 4 bit indices. Blocks past the edge of a level repeat its
+ * last row and column. Block rows are split over worker threads.
+ *
+ * @param chain  RGBA8 levels as built by buildMipChain
+ * @param format one of the BC formats, the sRGB flag only changes how the GPU reads the data
+ * @param out    receives every compressed level tightly packed, level 0 first
+ * @return       the location of each level in out
+ */
+std::vector<TextureMip> compressMipChain(std::span<const std::byte> chain,
+                                         std::span<const TextureMip> mips,
+                                         TextureFormat               format,
+                                         std::vector<std::byte>&     out);
+
+/**
+ * @brief Decode a BC mip chain back into RGBA8, for devices without BC sampling.
+ *
+ * @details Decodes BC1, BC3, BC4, BC5 and BC7 mode 6 blocks. Other BC7 modes are only written
+ * by external encoders, the chain is rejected when it contains one.
+ *
+ * @return false if the format or one of the blocks cannot be decoded
+ */
+bool decompressMipChain(std::span<const std::byte> chain,
+                        std::span<const TextureMip> mips,
+                        TextureFormat               format,
+                        std::vector<std::byte>&     out,
+                        std::vector<TextureMip>&    outMips);
+
+} // namespace TBE::Resource::Texture
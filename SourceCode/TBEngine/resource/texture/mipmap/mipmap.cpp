@@ -0,0 +1,406 @@
+#include "mipmap.hpp"
+#include "TBEngine/utils/parallel/parallel.hpp"
+#include "TBEngine/utils/simd/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace TBE::Resource::Texture {
+
+static constexpr size_t linearToSrgbSteps = 4096;
+
+struct SrgbTables {
+    std::array<float, 256>                 toLinear{};
+    std::array<uint8_t, linearToSrgbSteps> toSrgb{};
+
+    SrgbTables() {
+        for (size_t i = 0; i < toLinear.size(); i++) {
+            float c     = static_cast<float>(i) / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (size_t i = 0; i < toSrgb.size(); i++) {
+            float l   = static_cast<float>(i) / static_cast<float>(linearToSrgbSteps - 1);
+            float c   = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            toSrgb[i] = static_cast<uint8_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+        }
+    }
+};
+
+static const SrgbTables& getSrgbTables() {
+    static const SrgbTables tables{};
+    return tables;
+}
+
+// the windowed sinc filters reach 3 destination pixels to each side
+static constexpr uint32_t maxKernelTaps = 12;
+
+/**
+ * A 2:1 kernel, destination pixel x reads the source pixels [2x - radius + 1, 2x + radius]. The
+ * weights are symmetric around 2x + 0.5 and sum up to 1.
+ */
+struct MipKernel {
+    int32_t                          radius{};
+    uint32_t                         taps{};
+    std::array<float, maxKernelTaps> weights{};
+};
+
+static double sinc(double x) {
+    if (std::abs(x) < 1e-6) {
+        return 1.0;
+    }
+    double px = std::numbers::pi * x;
+    return std::sin(px) / px;
+}
+
+// zeroth order modified Bessel function of the first kind
+static double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+static MipKernel makeKernel(MipFilter filter) {
+    constexpr double sincWidth   = 3.0; // in destination pixels
+    constexpr double kaiserAlpha = 4.0;
+
+    MipKernel kernel{};
+    kernel.radius = filter == MipFilter::eBox ? 1 : static_cast<int32_t>(sincWidth * 2);
+    kernel.taps   = static_cast<uint32_t>(kernel.radius * 2);
+
+    double sum = 0.0;
+    for (uint32_t t = 0; t < kernel.taps; t++) {
+        // distance to the destination pixel center, in destination pixels
+        double u = (static_cast<double>(t) - kernel.radius + 0.5) / 2.0;
+        double w = 1.0;
+        switch (filter) {
+            case MipFilter::eKaiser: {
+                double r = u / sincWidth;
+                w        = sinc(u) * besselI0(kaiserAlpha * std::sqrt(std::max(0.0, 1.0 - r * r))) /
+                    besselI0(kaiserAlpha);
+                break;
+            }
+            case MipFilter::eLanczos: w = sinc(u) * sinc(u / sincWidth); break;
+            case MipFilter::eBox:
+            default: break;
+        }
+        kernel.weights[t] = static_cast<float>(w);
+        sum += w;
+    }
+    for (uint32_t t = 0; t < kernel.taps; t++) {
+        kernel.weights[t] = static_cast<float>(kernel.weights[t] / sum);
+    }
+    return kernel;
+}
+
+// scalar kernels, also used for the edges and tails of the vector ones
+
+static void filterPixelClamped(const float*     src,
+                               int32_t          srcWidth,
+                               int32_t          first,
+                               const MipKernel& kernel,
+                               float*           dst) {
+    float acc[4]{};
+    for (uint32_t t = 0; t < kernel.taps; t++) {
+        const float* px = src + std::clamp(first + static_cast<int32_t>(t), 0, srcWidth - 1) * 4;
+        for (size_t c = 0; c < 4; c++) {
+            acc[c] += kernel.weights[t] * px[c];
+        }
+    }
+    std::memcpy(dst, acc, sizeof(acc));
+}
+
+#if !defined(TBE_SIMD_X86)
+// the vector row kernels take filterRowEdges() for their edges instead
+static void filterRowScalar(const float*     src,
+                            uint32_t         srcWidth,
+                            float*           dst,
+                            uint32_t         dstWidth,
+                            const MipKernel& kernel) {
+    for (uint32_t x = 0; x < dstWidth; x++) {
+        filterPixelClamped(src,
+                           static_cast<int32_t>(srcWidth),
+                           static_cast<int32_t>(x * 2) - kernel.radius + 1,
+                           kernel,
+                           dst + x * 4);
+    }
+}
+#endif
+
+static void filterColumnScalar(const float* const* rows,
+                               const MipKernel&    kernel,
+                               float*              dst,
+                               size_t              begin,
+                               size_t              count) {
+    for (size_t i = begin; i < count; i++) {
+        float acc = 0.0f;
+        for (uint32_t t = 0; t < kernel.taps; t++) {
+            acc += kernel.weights[t] * rows[t][i];
+        }
+        dst[i] = acc;
+    }
+}
+
+// destination pixels whose taps all lie inside the source row, [begin, end)
+static std::pair<uint32_t, uint32_t>
+interiorRange(uint32_t srcWidth, uint32_t dstWidth, const MipKernel& kernel) {
+    const int64_t lastFirst = static_cast<int64_t>(srcWidth) - 1 - kernel.radius;
+    const int64_t begin     = std::min<int64_t>(kernel.radius / 2, dstWidth);
+    const int64_t end       = lastFirst < 0 ? 0 : std::min<int64_t>(lastFirst / 2 + 1, dstWidth);
+    return {static_cast<uint32_t>(begin), static_cast<uint32_t>(std::max(begin, end))};
+}
+
+// the pixels around [begin, end) read past the row and take the clamped path
+static void filterRowEdges(const float*     src,
+                           uint32_t         srcWidth,
+                           float*           dst,
+                           uint32_t         dstWidth,
+                           const MipKernel& kernel,
+                           uint32_t         begin,
+                           uint32_t         end) {
+    for (uint32_t x = begin == 0 ? end : 0; x < dstWidth; x = x + 1 == begin ? end : x + 1) {
+        filterPixelClamped(src,
+                           static_cast<int32_t>(srcWidth),
+                           static_cast<int32_t>(x * 2) - kernel.radius + 1,
+                           kernel,
+                           dst + x * 4);
+    }
+}
+
+#if defined(TBE_SIMD_X86)
+
+static void filterRowSse(const float*     src,
+                         uint32_t         srcWidth,
+                         float*           dst,
+                         uint32_t         dstWidth,
+                         const MipKernel& kernel) {
+    __m128 weights[maxKernelTaps]{};
+    for (uint32_t t = 0; t < kernel.taps; t++) {
+        weights[t] = _mm_set1_ps(kernel.weights[t]);
+    }
+
+    auto [begin, end] = interiorRange(srcWidth, dstWidth, kernel);
+    for (uint32_t x = begin; x < end; x++) {
+        const float* px  = src + (static_cast<int32_t>(x * 2) - kernel.radius + 1) * 4;
+        __m128       acc = _mm_setzero_ps();
+        for (uint32_t t = 0; t < kernel.taps; t++) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(px + t * 4), weights[t]));
+        }
+        _mm_storeu_ps(dst + x * 4, acc);
+    }
+    filterRowEdges(src, srcWidth, dst, dstWidth, kernel, begin, end);
+}
+
+static void filterColumnSse(const float* const* rows,
+                            const MipKernel&    kernel,
+                            float*              dst,
+                            size_t              begin,
+                            size_t              count) {
+    size_t i = begin;
+    for (; i + 4 <= count; i += 4) {
+        __m128 acc = _mm_setzero_ps();
+        for (uint32_t t = 0; t < kernel.taps; t++) {
+            __m128 w = _mm_set1_ps(kernel.weights[t]);
+            acc      = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(rows[t] + i), w));
+        }
+        _mm_storeu_ps(dst + i, acc);
+    }
+    filterColumnScalar(rows, kernel, dst, i, count);
+}
+
+// two destination pixels per iteration, their taps are two source pixels apart
+TBE_TARGET_AVX2 static void filterRowAvx2(const float*     src,
+                                          uint32_t         srcWidth,
+                                          float*           dst,
+                                          uint32_t         dstWidth,
+                                          const MipKernel& kernel) {
+    __m256 weights[maxKernelTaps]{};
+    for (uint32_t t = 0; t < kernel.taps; t++) {
+        weights[t] = _mm256_set1_ps(kernel.weights[t]);
+    }
+
+    auto [begin, end] = interiorRange(srcWidth, dstWidth, kernel);
+    uint32_t x        = begin;
+    for (; x + 2 <= end; x += 2) {
+        const float* px  = src + (static_cast<int32_t>(x * 2) - kernel.radius + 1) * 4;
+        __m256       acc = _mm256_setzero_ps();
+        for (uint32_t t = 0; t < kernel.taps; t++) {
+            __m256 pair = _mm256_insertf128_ps(
+                _mm256_castps128_ps256(_mm_loadu_ps(px + t * 4)), _mm_loadu_ps(px + t * 4 + 8), 1);
+            acc = _mm256_fmadd_ps(pair, weights[t], acc);
+        }
+        _mm256_storeu_ps(dst + x * 4, acc);
+    }
+    filterRowEdges(src, srcWidth, dst, dstWidth, kernel, begin, x);
+}
+
+TBE_TARGET_AVX2 static void filterColumnAvx2(const float* const* rows,
+                                             const MipKernel&    kernel,
+                                             float*              dst,
+                                             size_t              begin,
+                                             size_t              count) {
+    size_t i = begin;
+    for (; i + 8 <= count; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (uint32_t t = 0; t < kernel.taps; t++) {
+            __m256 w = _mm256_set1_ps(kernel.weights[t]);
+            acc      = _mm256_fmadd_ps(_mm256_loadu_ps(rows[t] + i), w, acc);
+        }
+        _mm256_storeu_ps(dst + i, acc);
+    }
+    filterColumnSse(rows, kernel, dst, i, count);
+}
+
+#endif
+
+struct RowKernels {
+    void (*filterRow)(const float*, uint32_t, float*, uint32_t, const MipKernel&);
+    void (*filterColumn)(const float* const*, const MipKernel&, float*, size_t, size_t);
+};
+
+static RowKernels selectRowKernels() {
+#if defined(TBE_SIMD_X86)
+    if (Utils::getCpuFeatures().avx2) {
+        return {filterRowAvx2, filterColumnAvx2};
+    }
+    return {filterRowSse, filterColumnSse};
+#else
+    return {filterRowScalar, filterColumnScalar};
+#endif
+}
+
+static void loadLinearRow(const uint8_t* src, float* dst, size_t pixelCount, bool srgb) {
+    const auto& tables = getSrgbTables();
+    if (!srgb) {
+        for (size_t i = 0; i < pixelCount * 4; i++) {
+            dst[i] = static_cast<float>(src[i]) * (1.0f / 255.0f);
+        }
+        return;
+    }
+    for (size_t i = 0; i < pixelCount * 4; i += 4) {
+        dst[i + 0] = tables.toLinear[src[i + 0]];
+        dst[i + 1] = tables.toLinear[src[i + 1]];
+        dst[i + 2] = tables.toLinear[src[i + 2]];
+        dst[i + 3] = static_cast<float>(src[i + 3]) * (1.0f / 255.0f);
+    }
+}
+
+// the sinc filters ring, so everything is clamped before the table lookup
+static void storeRow(const float* src, uint8_t* dst, size_t pixelCount, bool srgb) {
+    const auto& tables = getSrgbTables();
+    const float scale  = srgb ? static_cast<float>(linearToSrgbSteps - 1) : 255.0f;
+#if defined(TBE_SIMD_X86)
+    // sRGB color is scaled to the table index, everything else straight to 8 bits
+    const __m128 scales = _mm_setr_ps(scale, scale, scale, 255.0f);
+    const __m128 half   = _mm_set1_ps(0.5f);
+    const __m128 zero   = _mm_setzero_ps();
+    const __m128 one    = _mm_set1_ps(1.0f);
+    alignas(16) int32_t idx[4]{};
+    for (size_t i = 0; i < pixelCount * 4; i += 4) {
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one);
+        _mm_store_si128(reinterpret_cast<__m128i*>(idx),
+                        _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scales), half)));
+        for (size_t c = 0; c < 3; c++) {
+            dst[i + c] = srgb ? tables.toSrgb[idx[c]] : static_cast<uint8_t>(idx[c]);
+        }
+        dst[i + 3] = static_cast<uint8_t>(idx[3]);
+    }
+#else
+    for (size_t i = 0; i < pixelCount * 4; i += 4) {
+        for (size_t c = 0; c < 3; c++) {
+            auto idx   = static_cast<size_t>(std::clamp(src[i + c], 0.0f, 1.0f) * scale + 0.5f);
+            dst[i + c] = srgb ? tables.toSrgb[idx] : static_cast<uint8_t>(idx);
+        }
+        dst[i + 3] = static_cast<uint8_t>(std::clamp(src[i + 3], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+#endif
+}
+
+static void downsample(const uint8_t*    src,
+                       uint32_t          srcWidth,
+                       uint32_t          srcHeight,
+                       uint8_t*          dst,
+                       uint32_t          dstWidth,
+                       uint32_t          dstHeight,
+                       const MipKernel&  kernel,
+                       const RowKernels& rowKernels,
+                       bool              srgb) {
+    const size_t dstRowFloats = static_cast<size_t>(dstWidth) * 4;
+
+    Utils::parallelFor(dstHeight, 16, [&](size_t rowBegin, size_t rowEnd) {
+        // horizontally filtered source rows in a ring, each destination row reads taps of them and
+        // moves on by two, the rows shared with the neighbouring bands are filtered twice
+        std::vector<float> linearRow(static_cast<size_t>(srcWidth) * 4);
+        std::vector<float> filtered(kernel.taps * dstRowFloats);
+        std::vector<float> outRow(dstRowFloats);
+
+        const int64_t firstRow = static_cast<int64_t>(rowBegin * 2) - kernel.radius + 1;
+        int64_t       nextRow  = firstRow;
+        auto          ringRow  = [&](int64_t row) {
+            auto slot = static_cast<size_t>(row - firstRow) % kernel.taps;
+            return filtered.data() + slot * dstRowFloats;
+        };
+
+        std::array<const float*, maxKernelTaps> rows{};
+        for (size_t y = rowBegin; y < rowEnd; y++) {
+            const int64_t first = static_cast<int64_t>(y * 2) - kernel.radius + 1;
+            for (; nextRow < first + kernel.taps; nextRow++) {
+                auto srcRow = std::clamp<int64_t>(nextRow, 0, srcHeight - 1);
+                loadLinearRow(src + srcRow * srcWidth * 4, linearRow.data(), srcWidth, srgb);
+                rowKernels.filterRow(
+                    linearRow.data(), srcWidth, ringRow(nextRow), dstWidth, kernel);
+            }
+            for (uint32_t t = 0; t < kernel.taps; t++) {
+                rows[t] = ringRow(first + t);
+            }
+            rowKernels.filterColumn(rows.data(), kernel, outRow.data(), 0, dstRowFloats);
+            storeRow(outRow.data(), dst + y * dstRowFloats, dstWidth, srgb);
+        }
+    });
+}
+
+std::vector<TextureMip> buildMipChain(std::span<const std::byte> level0,
+                                      uint32_t                   width,
+                                      uint32_t                   height,
+                                      std::vector<std::byte>&    chain,
+                                      MipFilter                  filter,
+                                      bool                       srgb) {
+    const uint32_t levelCount = getMipLevelCount(width, height);
+
+    std::vector<TextureMip> mips(levelCount);
+    uint64_t                offset = 0;
+    for (uint32_t i = 0; i < levelCount; i++) {
+        mips[i].width  = std::max(width >> i, 1u);
+        mips[i].height = std::max(height >> i, 1u);
+        mips[i].offset = offset;
+        mips[i].size   = static_cast<uint64_t>(mips[i].width) * mips[i].height * 4;
+        offset += mips[i].size;
+    }
+
+    chain.resize(offset);
+    std::memcpy(chain.data(), level0.data(), mips[0].size);
+
+    const auto kernel     = makeKernel(filter);
+    const auto rowKernels = selectRowKernels();
+
+    auto* base = reinterpret_cast<uint8_t*>(chain.data());
+    for (uint32_t i = 1; i < levelCount; i++) {
+        downsample(base + mips[i - 1].offset,
+                   mips[i - 1].width,
+                   mips[i - 1].height,
+                   base + mips[i].offset,
+                   mips[i].width,
+                   mips[i].height,
+                   kernel,
+                   rowKernels,
+                   srgb);
+    }
+    return mips;
+}
+
+} // namespace TBE::Resource::Texture
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace TBE::Resource::Texture {
+
+// where a mip level lives in a packed chain, offsets are relative to the first level
+struct TextureMip {
+    uint64_t offset{};
+    uint64_t size{};
+    uint32_t width{};
+    uint32_t height{};
+};
+static_assert(sizeof(TextureMip) == 24, "TextureMip is part of the .tbtex format");
+
+// downsampling filter of the mip chain, the windowed sinc filters keep more detail than the box
+enum class MipFilter : uint32_t
+{
+    eBox,
+    eKaiser,
+    eLanczos
+};
+
+// levels down to 1x1, the same count ImageResource creates for a texture
+constexpr uint32_t getMipLevelCount(uint32_t width, uint32_t height) {
+    return static_cast<uint32_t>(std::bit_width(width > height ? width : height));
+}
+
+/**
+ * @brief Build the whole mip chain of an RGBA8 image on the CPU.
+ *
+ * @details Level 0 is copied as is, every other level is filtered from the previous one by a
+ * separable 2:1 kernel with clamped edges. Color channels of an sRGB image are filtered in
+ * linear space, alpha and the channels of linear data such as normal maps as they are. Rows are
+ * split over worker threads and run on AVX2 or SSE2 when available.
+ *
+ * @param level0 width * height * 4 bytes
+ * @param chain  receives every level tightly packed, level 0 first
+ * @param srgb   false for data that is not color, such as normal maps
+ * @return       the location of each level in chain
+ */
+std::vector<TextureMip> buildMipChain(std::span<const std::byte> level0,
+                                      uint32_t                   width,
+                                      uint32_t                   height,
+                                      std::vector<std::byte>&    chain,
+                                      MipFilter                  filter = MipFilter::eBox,
+                                      bool                       srgb   = true);
+
+} // namespace TBE::Resource::Texture
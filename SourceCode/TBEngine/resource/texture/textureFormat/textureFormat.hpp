@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace TBE::Resource::Texture {
+
+// pixel formats a texture chain can be stored in, the values are the matching VkFormat so KTX2
+// files and image creation take them as they are
+enum class TextureFormat : uint32_t
+{
+    eUndefined    = 0,
+    eRGBA8Unorm   = 37,
+    eRGBA8Srgb    = 43,
+    eBC1RGBUnorm  = 131,
+    eBC1RGBSrgb   = 132,
+    eBC1RGBAUnorm = 133,
+    eBC1RGBASrgb  = 134,
+    eBC3Unorm     = 137,
+    eBC3Srgb      = 138,
+    eBC4Unorm     = 139,
+    eBC5Unorm     = 141,
+    eBC7Unorm     = 145,
+    eBC7Srgb      = 146,
+};
+
+// bytes of a 4x4 block, or of a single pixel for the uncompressed formats, 0 if unknown
+constexpr uint32_t getBlockBytes(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::eRGBA8Unorm:
+        case TextureFormat::eRGBA8Srgb: return 4;
+        case TextureFormat::eBC1RGBUnorm:
+        case TextureFormat::eBC1RGBSrgb:
+        case TextureFormat::eBC1RGBAUnorm:
+        case TextureFormat::eBC1RGBASrgb:
+        case TextureFormat::eBC4Unorm: return 8;
+        case TextureFormat::eBC3Unorm:
+        case TextureFormat::eBC3Srgb:
+        case TextureFormat::eBC5Unorm:
+        case TextureFormat::eBC7Unorm:
+        case TextureFormat::eBC7Srgb: return 16;
+        case TextureFormat::eUndefined:
+        default: return 0;
+    }
+}
+
+constexpr bool isBlockCompressed(TextureFormat format) {
+    return getBlockBytes(format) > 4;
+}
+
+constexpr bool isSrgb(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::eRGBA8Srgb:
+        case TextureFormat::eBC1RGBSrgb:
+        case TextureFormat::eBC1RGBASrgb:
+        case TextureFormat::eBC3Srgb:
+        case TextureFormat::eBC7Srgb: return true;
+        default: return false;
+    }
+}
+
+// size of a width * height level, compressed levels are padded to whole blocks
+constexpr uint64_t getLevelSize(TextureFormat format, uint32_t width, uint32_t height) {
+    if (!isBlockCompressed(format)) {
+        return static_cast<uint64_t>(width) * height * getBlockBytes(format);
+    }
+    return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockBytes(format);
+}
+
+constexpr std::string_view toString(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::eRGBA8Unorm: return "RGBA8 unorm";
+        case TextureFormat::eRGBA8Srgb: return "RGBA8 sRGB";
+        case TextureFormat::eBC1RGBUnorm: return "BC1 RGB unorm";
+        case TextureFormat::eBC1RGBSrgb: return "BC1 RGB sRGB";
+        case TextureFormat::eBC1RGBAUnorm: return "BC1 RGBA unorm";
+        case TextureFormat::eBC1RGBASrgb: return "BC1 RGBA sRGB";
+        case TextureFormat::eBC3Unorm: return "BC3 unorm";
+        case TextureFormat::eBC3Srgb: return "BC3 sRGB";
+        case TextureFormat::eBC4Unorm: return "BC4 unorm";
+        case TextureFormat::eBC5Unorm: return "BC5 unorm";
+        case TextureFormat::eBC7Unorm: return "BC7 unorm";
+        case TextureFormat::eBC7Srgb: return "BC7 sRGB";
+        case TextureFormat::eUndefined:
+        default: return "undefined";
+    }
+}
+
+} // namespace TBE::Resource::Texture
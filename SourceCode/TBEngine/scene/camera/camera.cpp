@@ -44,6 +44,15 @@ void Camera::tickCPU() {
     return;
 }
 
+void Camera::getRay(const glm::vec2& ndc, glm::vec3& origin, glm::vec3& direction) const {
+    // the flipped y of proj already matches the screen, depth goes from 0 at the near plane to 1
+    auto      inverse = glm::inverse(*proj * *view);
+    glm::vec4 closer  = inverse * glm::vec4{ndc, 0.0f, 1.0f};
+    glm::vec4 further = inverse * glm::vec4{ndc, 1.0f, 1.0f};
+    origin            = glm::vec3{closer} / closer.w;
+    direction         = glm::normalize(glm::vec3{further} / further.w - origin);
+}
+
 void Camera::onKeyDown(KeyStateMap keyMap) {
     // rotate camera
     glm::vec2 angles = {0.0f, 0.0f}; // rotate by x axis and y axis
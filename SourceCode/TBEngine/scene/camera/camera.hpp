@@ -23,6 +23,9 @@ public:
 public:
     void onKeyDown(KeyStateMap keyMap);
 
+    // the world space ray through a point of the screen, ndc in -1~1 with y pointing down
+    void getRay(const glm::vec2& ndc, glm::vec3& origin, glm::vec3& direction) const;
+
 private:
     glm::vec3 pos{2.0f, 2.0f, 2.0f};
     glm::vec3 front{-1.0f, -1.0f, -1.0f};
@@ -1,24 +1,46 @@
 #include "model.hpp"
 #include "TBEngine/utils/log/log.hpp"
+#include "TBEngine/utils/parallel/parallel.hpp"
 #include "TBEngine/core/graphics/graphics.hpp"
+#include "TBEngine/settings.hpp"
 
+#include <algorithm>
 
 namespace TBE::Scene::Model {
 
 size_t ModelManager::add(std::string_view modelPath, std::string_view texturePath, bool slowRead) {
     auto& modelFile = modelFiles.emplace_back();
+    modelFile.setImportSettings({.optimize     = OPTIMIZE_MESHES,
+                                 .vertexLayout = MESH_VERTEX_LAYOUT,
+                                 .lodCount     = MESH_LOD_COUNT,
+                                 .meshlets     = CLUSTER_CULLING});
     modelFile.newFile(modelPath);
     if (!modelFile.isValid()) {
         Utils::Log::logErrorMsg("invalid file path for model");
     }
 
     auto& textureFile = textureFiles.emplace_back();
+    textureFile.setImportSettings(
+        {.mipFilter = TEXTURE_MIP_FILTER,
+         .usage     = Resource::File::TextureFile::usageOf(texturePath),
+         .compress  = TEXTURE_COMPRESSION &&
+                     Graphics::VulkanGraphics::textureInterface.supportsBlockCompression(),
+         .preferBC7 = TEXTURE_PREFER_BC7});
     textureFile.newFile(texturePath);
     if (!textureFile.isValid()) {
         Utils::Log::logErrorMsg("invalid file path for texture");
     }
 
+    // the GPU slots share the index of the files, the model draws with its texture
     auto idx = modelFiles.size() - 1;
+    if (Graphics::VulkanGraphics::modelInterface.reserve() != idx ||
+        Graphics::VulkanGraphics::textureInterface.reserve() != idx) {
+        Utils::Log::logErrorMsg("model slots out of sync with the model files");
+    }
+    Graphics::VulkanGraphics::modelInterface.setTexture(
+        static_cast<uint32_t>(idx),
+        Graphics::VulkanGraphics::textureInterface.getTableElement(static_cast<uint32_t>(idx)));
+
     if (!slowRead) {
         read(idx);
     }
@@ -27,6 +49,7 @@ size_t ModelManager::add(std::string_view modelPath, std::string_view texturePat
 }
 
 void ModelManager::destroy() {
+    streamQueue.reset();
     textureFiles.clear();
     modelFiles.clear();
 }
@@ -34,11 +57,56 @@ void ModelManager::destroy() {
 void ModelManager::read(size_t idx) {
     auto& modelFile   = modelFiles[idx];
     auto& textureFile = textureFiles[idx];
+    auto  slot        = static_cast<uint32_t>(idx);
 
     modelFile.read();
-    Graphics::VulkanGraphics::modelInterface.read(
-        modelFile.getVerticesByte(), modelFile.getIndicesByte(), modelFile.getIndices().size());
-    Graphics::VulkanGraphics::textureInterface.read(textureFile.read());
+    Graphics::VulkanGraphics::modelInterface.read(slot,
+                                                  modelFile.getVerticesByte(),
+                                                  modelFile.getIndicesByte(),
+                                                  modelFile.getMeshletsByte(),
+                                                  modelFile.getMeshDesc());
+    Graphics::VulkanGraphics::textureInterface.read(slot, textureFile.read());
+}
+
+void ModelManager::stream(size_t idx) {
+    if (!streamQueue) {
+        streamQueue = std::make_unique<Stream::StreamQueue>(
+            std::max<size_t>(1, Utils::workerCount() / 2));
+    }
+
+    auto& modelFile   = modelFiles[idx];
+    auto& textureFile = textureFiles[idx];
+    auto  slot        = static_cast<uint32_t>(idx);
+
+    streamQueue->enqueue(
+        modelFile.getPath(),
+        [&modelFile]() { modelFile.read(); },
+        [&modelFile, slot](Graphics::UploadBatch& batch) {
+            Graphics::VulkanGraphics::modelInterface.upload(slot,
+                                                            modelFile.getVerticesByte(),
+                                                            modelFile.getIndicesByte(),
+                                                            modelFile.getMeshletsByte(),
+                                                            modelFile.getMeshDesc(),
+                                                            batch);
+        },
+        [slot]() { Graphics::VulkanGraphics::modelInterface.setReady(slot); });
+
+    // the second read() only hands out the content decoded by the first one
+    streamQueue->enqueue(
+        textureFile.getPath(),
+        [&textureFile]() { textureFile.read(); },
+        [&textureFile, slot](Graphics::UploadBatch& batch) {
+            Graphics::VulkanGraphics::textureInterface.upload(slot, textureFile.read(), batch);
+        },
+        [slot]() { Graphics::VulkanGraphics::textureInterface.setReady(slot); });
+}
+
+bool ModelManager::tick() {
+    return streamQueue && streamQueue->tick();
+}
+
+std::vector<Stream::StreamRecord> ModelManager::getStreamRecords() {
+    return streamQueue ? streamQueue->getRecords() : std::vector<Stream::StreamRecord>{};
 }
 
 } // namespace TBE::Scene::Model
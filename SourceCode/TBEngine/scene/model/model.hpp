@@ -2,7 +2,10 @@
 
 #include "TBEngine/resource/file/model/modelFile.hpp"
 #include "TBEngine/resource/file/texture/textureFile.hpp"
+#include "TBEngine/scene/stream/streamQueue.hpp"
 
+#include <deque>
+#include <memory>
 #include <string_view>
 #include <vector>
 
@@ -17,16 +20,30 @@ public:
     void destroy();
 
 public:
-    void   read(size_t idx);
+    // read and upload on the calling thread
+    void read(size_t idx);
+
+    // decode on the stream workers and upload without waiting, the model is drawn with the
+    // placeholders until then
+    void stream(size_t idx);
+
+    // pump the stream queue once per frame, returns true on the frame streaming finished
+    bool tick();
+
     bool   empty() { return modelFiles.empty(); }
     size_t size() { return modelFiles.size(); }
 
+    std::vector<Stream::StreamRecord> getStreamRecords();
+
 public:
-    const auto getIdxSize(uint32_t idx) { return modelFiles[idx].getIndices().size(); }
+    const auto getIdxSize(uint32_t idx) { return modelFiles[idx].getIdxCount(); }
 
 private:
-    std::vector<Resource::File::ModelFile>   modelFiles{};
-    std::vector<Resource::File::TextureFile> textureFiles{};
+    // deques keep the files in place while the stream workers decode into them
+    std::deque<Resource::File::ModelFile>   modelFiles{};
+    std::deque<Resource::File::TextureFile> textureFiles{};
+
+    std::unique_ptr<Stream::StreamQueue> streamQueue{};
 };
 
 } // namespace TBE::Scene::Model
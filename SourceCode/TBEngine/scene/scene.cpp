@@ -1,42 +1,81 @@
 #include "scene.hpp"
 #include "TBEngine/utils/log/log.hpp"
 #include "TBEngine/core/graphics/graphics.hpp"
+#include "TBEngine/core/math/frustum/frustum.hpp"
+#include "TBEngine/core/graphics/vulkanAbstract/memoryAllocator/memoryAllocator.hpp"
+#include "TBEngine/resource/cache/assetCache.hpp"
+#include "TBEngine/settings.hpp"
 
+#include <string>
 
 namespace TBE::Scene {
 using namespace TBE::Editor::DelegateManager;
 
+static const glm::vec4 highlightTint{1.0f, 0.6f, 0.3f, 1.0f}; // multiplies the picked one
+
 std::vector<std::tuple<InputType, std::any>> Scene::getBindFuncs() {
     std::any func1 = std::function<void(KeyStateMap)>(
         std::bind(&Camera::Camera::onKeyDown, &camera, std::placeholders::_1));
+    std::any func2 = std::function<void(uint32_t, uint32_t)>(
+        std::bind(&Scene::onMouseMove, this, std::placeholders::_1, std::placeholders::_2));
+    std::any func3 =
+        std::function<void(bool)>(std::bind(&Scene::onMouseClick, this, std::placeholders::_1));
 
-    return {std::make_tuple(InputType::eKeyBoard, func1)};
+    return {std::make_tuple(InputType::eKeyBoard, func1),
+            std::make_tuple(InputType::eMouseMove, func2),
+            std::make_tuple(InputType::eMouseClick, func3)};
 }
 
 void Scene::tickCPU() {
+    if (modelManager.tick()) {
+        Resource::Cache::AssetCache::get().report();
+        Graphics::MemoryAllocator::get().report();
+        Graphics::VulkanGraphics::uploadContext.report();
+        Graphics::VulkanGraphics::modelInterface.report();
+    }
     camera.tickCPU();
-    updateUniformBuffer();
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    updateFrameData();
 }
 
-void Scene::updateUniformBuffer() {
-    static auto startTime = std::chrono::high_resolution_clock::now();
-    const auto& extent    = Graphics::VulkanGraphics::extent;
+void Scene::updateFrameData() {
+    Math::DataFormat::FrameData frameData{*camera.view, *camera.proj};
+    frameData.frustum = Math::extractFrustumPlanes(frameData.proj * frameData.view);
+    Graphics::VulkanGraphics::sceneInterface.setFrameData(frameData);
+}
+
+void Scene::onMouseClick(bool right) {
+    auto extent = Graphics::VulkanGraphics::extent;
+    if (right || extent.width == 0 || extent.height == 0) {
+        return;
+    }
 
-    auto  currentTime = std::chrono::high_resolution_clock::now();
-    float time =
-        std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+    glm::vec2 ndc = (glm::vec2{cursor} + 0.5f) / glm::vec2{extent.width, extent.height};
+    glm::vec3 origin{}, direction{};
+    camera.getRay(ndc * 2.0f - 1.0f, origin, direction);
 
-    Math::DataFormat::UniformBufferObject ubo{};
-    // ubo.model =
-    //     glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    auto instance = Graphics::VulkanGraphics::sceneInterface.pick(origin, direction);
+    select(instance);
+    if (instance == Graphics::nullInstance) {
+        logger->trace("picked nothing");
+    } else {
+        logger->info("picked instance " + std::to_string(instance));
+    }
+}
 
-    ubo.view = *camera.view;
-    ubo.proj = *camera.proj;
+// the tint of the instance selected before is put back
+void Scene::select(Graphics::InstanceHandle instance) {
+    auto& sceneInterface = Graphics::VulkanGraphics::sceneInterface;
+    if (selected != Graphics::nullInstance) {
+        auto data = sceneInterface.getInstance(selected);
+        sceneInterface.setInstance(selected, {data.model, selectedTint});
+    }
 
-    std::span<std::byte> data(static_cast<std::byte*>(static_cast<void*>(&ubo)), sizeof(ubo));
-    Graphics::VulkanGraphics::sceneInterface.updateUniformBuffer(data);
+    selected = instance;
+    if (selected != Graphics::nullInstance) {
+        auto data    = sceneInterface.getInstance(selected);
+        selectedTint = data.tint;
+        sceneInterface.setInstance(selected, {data.model, selectedTint * highlightTint});
+    }
 }
 
 void Scene::read() {
@@ -44,14 +83,53 @@ void Scene::read() {
         logger->warn("Try to read but no model has been prepared");
     }
     for (size_t i = 0; i < modelManager.size(); i++) {
-        modelManager.read(i);
+        if (STREAM_ASSETS) {
+            modelManager.stream(i);
+        } else {
+            modelManager.read(i);
+        }
     }
 
-    Graphics::VulkanGraphics::sceneInterface.initUniformBuffer();
+    // shaders are added before the scene is read, so this covers every startup asset, streamed
+    // assets are reported by tickCPU() once they are in
+    if (!STREAM_ASSETS) {
+        Resource::Cache::AssetCache::get().report();
+        Graphics::MemoryAllocator::get().report();
+        Graphics::VulkanGraphics::uploadContext.report();
+        Graphics::VulkanGraphics::modelInterface.report();
+    }
 }
 
 size_t Scene::addModel(std::string_view modelPath, std::string_view texturePath) {
     return modelManager.add(modelPath, texturePath, true);
 }
 
+Graphics::InstanceHandle
+Scene::addInstance(size_t model, const glm::mat4& transform, const glm::vec4& tint) {
+    if (model >= modelManager.size()) {
+        Utils::Log::logErrorMsg("add an instance of a model that does not exist");
+    }
+    return Graphics::VulkanGraphics::sceneInterface.addInstance(static_cast<uint32_t>(model),
+                                                                {transform, tint});
+}
+
+void Scene::setInstance(Graphics::InstanceHandle instance,
+                        const glm::mat4&         transform,
+                        const glm::vec4&         tint) {
+    if (instance == selected) {
+        selectedTint = tint;
+        Graphics::VulkanGraphics::sceneInterface.setInstance(instance,
+                                                             {transform, tint * highlightTint});
+        return;
+    }
+    Graphics::VulkanGraphics::sceneInterface.setInstance(instance, {transform, tint});
+}
+
+void Scene::removeInstance(Graphics::InstanceHandle instance) {
+    if (instance == selected) {
+        selected = Graphics::nullInstance;
+    }
+    Graphics::VulkanGraphics::sceneInterface.removeInstance(instance);
+}
+
 } // namespace TBE::Scene
@@ -4,6 +4,7 @@
 #include "model/model.hpp"
 #include "camera/camera.hpp"
 #include "TBEngine/enums.hpp"
+#include "TBEngine/core/graphics/interface/sceneInterface/instanceTable.hpp"
 
 #include <vector>
 #include <string_view>
@@ -24,6 +25,17 @@ public: // model related
     void   read();
     size_t addModel(std::string_view modelPath, std::string_view texturePath);
 
+public: // instance related
+    // a model is drawn once per instance, none are added with it, keep the handle to move or
+    // remove the instance later
+    Graphics::InstanceHandle addInstance(size_t           model,
+                                         const glm::mat4& transform,
+                                         const glm::vec4& tint = glm::vec4{1.0f});
+    void setInstance(Graphics::InstanceHandle instance,
+                     const glm::mat4&         transform,
+                     const glm::vec4&         tint = glm::vec4{1.0f});
+    void removeInstance(Graphics::InstanceHandle instance);
+
 public: // shader related
     void addShader(std::string filePath, ShaderType type) {
         shaderManager.addShader(filePath, type);
@@ -36,10 +48,18 @@ private:
     Camera                  camera{};
     Resource::ShaderManager shaderManager{};
     Model::ModelManager     modelManager{};
-    uint32_t                currentFrame = 0;
 
 private:
-    void updateUniformBuffer();
+    // the instance under the cursor is picked by a left click and shown tinted
+    glm::uvec2               cursor{}; // in framebuffer pixels
+    Graphics::InstanceHandle selected = Graphics::nullInstance;
+    glm::vec4                selectedTint{1.0f}; // restored once another instance is picked
+
+private:
+    void updateFrameData();
+    void onMouseMove(uint32_t x, uint32_t y) { cursor = {x, y}; }
+    void onMouseClick(bool right);
+    void select(Graphics::InstanceHandle instance);
 };
 
 } // namespace TBE::Scene
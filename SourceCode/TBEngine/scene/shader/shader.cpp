@@ -2,6 +2,8 @@
 #include "TBEngine/core/graphics/graphics.hpp"
 #include "TBEngine/core/graphics/interface/shaderInterface/shaderInterface.hpp"
 
+#include <cstring>
+
 namespace TBE::Resource {
 using namespace TBE::Utils::Log;
 using File::ShaderFile;
@@ -17,11 +19,28 @@ void ShaderManager::destroy() {
     }
 }
 
+// a SPIR-V module is a stream of 32 bit words starting with the magic number
+static bool isValidSpirv(const std::vector<char>& code) {
+    constexpr uint32_t spirvMagic = 0x07230203;
+
+    uint32_t magic{};
+    if (code.size() < sizeof(magic) || code.size() % sizeof(uint32_t) != 0) {
+        return false;
+    }
+    std::memcpy(&magic, code.data(), sizeof(magic));
+    return magic == spirvMagic;
+}
+
+// SPIR-V is what the driver consumes already, there is no import the asset cache could skip
 void ShaderManager::addShader(std::string filePath, ShaderType type) {
     auto& [shaderFile, _] =
         shaderFiles.emplace_back(std::move(std::make_pair(ShaderFile(filePath), type)));
 
-    Graphics::VulkanGraphics::shaderInterface.addShader(shaderFile.read(), type);
+    auto code = shaderFile.read();
+    if (!isValidSpirv(code)) {
+        logErrorMsg("not a SPIR-V module: " + filePath);
+    }
+    Graphics::VulkanGraphics::shaderInterface.addShader(std::move(code), type);
 }
 
 } // namespace TBE::Resource
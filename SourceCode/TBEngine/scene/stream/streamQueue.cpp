@@ -0,0 +1,160 @@
+#include "streamQueue.hpp"
+#include "TBEngine/utils/log/log.hpp"
+
+namespace TBE::Scene::Stream {
+
+const char* toString(StreamStatus status) {
+    switch (status) {
+        case StreamStatus::eQueued: return "queued";
+        case StreamStatus::eDecoding: return "decoding";
+        case StreamStatus::eDecoded: return "decoded";
+        case StreamStatus::eUploading: return "uploading";
+        case StreamStatus::eReady: return "ready";
+        case StreamStatus::eFailed: return "failed";
+        default: return "unknown";
+    }
+}
+
+StreamQueue::StreamQueue(size_t threadCount) : workers(threadCount) {
+}
+
+size_t StreamQueue::enqueue(std::string name,
+                            DecodeFunc  decode,
+                            UploadFunc  upload,
+                            ReadyFunc   ready) {
+    Job*   pJob = nullptr;
+    size_t idx  = 0;
+    {
+        std::lock_guard lock(mutex);
+        if (!loading && pendingCount == 0) {
+            startTime = Clock::now();
+        }
+        loading = true;
+        pendingCount++;
+
+        auto& job       = jobs.emplace_back();
+        job.record.name = std::move(name);
+        job.decode      = std::move(decode);
+        job.upload      = std::move(upload);
+        job.ready       = std::move(ready);
+        pJob            = &job;
+        idx             = jobs.size() - 1;
+    }
+    workers.submit([this, pJob]() { decodeJob(*pJob); });
+    return idx;
+}
+
+void StreamQueue::decodeJob(Job& job) {
+    {
+        std::lock_guard lock(mutex);
+        job.record.status = StreamStatus::eDecoding;
+    }
+
+    auto startDecode = Clock::now();
+    bool decoded     = true;
+    try {
+        job.decode();
+    } catch (const std::exception& e) {
+        logger->error("failed to stream " + job.record.name + ": " + e.what());
+        decoded = false;
+    }
+    auto decodeMs =
+        std::chrono::duration<double, std::chrono::milliseconds::period>(Clock::now() - startDecode)
+            .count();
+
+    std::lock_guard lock(mutex);
+    job.record.decodeMs = decodeMs;
+    if (decoded) {
+        job.record.status = StreamStatus::eDecoded;
+    } else {
+        job.record.status  = StreamStatus::eFailed;
+        job.record.readyMs = sinceStart();
+        failedCount++;
+        pendingCount--;
+    }
+}
+
+bool StreamQueue::tick() {
+    // only the main thread moves a job on from eDecoded, so the pointers stay valid unlocked
+    std::vector<Job*> decoded{};
+    std::vector<Job*> uploading{};
+    {
+        std::lock_guard lock(mutex);
+        for (auto& job : jobs) {
+            if (job.record.status == StreamStatus::eDecoded) {
+                decoded.emplace_back(&job);
+            } else if (job.record.status == StreamStatus::eUploading) {
+                uploading.emplace_back(&job);
+            }
+        }
+    }
+
+    for (auto* pJob : uploading) {
+        if (!pJob->batch->isDone()) {
+            continue;
+        }
+        pJob->ready();
+        pJob->batch.reset();
+
+        std::lock_guard lock(mutex);
+        pJob->record.status  = StreamStatus::eReady;
+        pJob->record.readyMs = sinceStart();
+        pendingCount--;
+    }
+
+    for (auto* pJob : decoded) {
+        pJob->batch = std::make_unique<Graphics::UploadBatch>();
+        pJob->upload(*pJob->batch);
+        pJob->batch->submit();
+
+        std::lock_guard lock(mutex);
+        pJob->record.status = StreamStatus::eUploading;
+    }
+
+    // failed jobs are done too, but they are not ready
+    std::lock_guard lock(mutex);
+    auto            readyCount = jobs.size() - pendingCount - failedCount;
+    if (!firstFrameLogged && loading) {
+        firstFrameLogged = true;
+        logger->info("stream: first frame after " + std::to_string(sinceStart()) + " ms, " +
+                     std::to_string(readyCount) + " of " + std::to_string(jobs.size()) +
+                     " assets ready, " + std::to_string(failedCount) + " failed");
+    }
+    if (loading && pendingCount == 0) {
+        loading = false;
+        logger->info("stream: " + std::to_string(readyCount) + " of " +
+                     std::to_string(jobs.size()) + " assets loaded after " +
+                     std::to_string(sinceStart()) + " ms, " + std::to_string(failedCount) +
+                     " failed");
+        for (const auto& job : jobs) {
+            logger->info("stream: " + job.record.name + " " + toString(job.record.status) +
+                         ", decoded in " + std::to_string(job.record.decodeMs) + " ms, done at " +
+                         std::to_string(job.record.readyMs) + " ms");
+        }
+        return true;
+    }
+    return false;
+}
+
+bool StreamQueue::idle() {
+    std::lock_guard lock(mutex);
+    return pendingCount == 0;
+}
+
+std::vector<StreamRecord> StreamQueue::getRecords() {
+    std::lock_guard           lock(mutex);
+    std::vector<StreamRecord> records{};
+    records.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        records.emplace_back(job.record);
+    }
+    return records;
+}
+
+double StreamQueue::sinceStart() const {
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(Clock::now() -
+                                                                            startTime)
+        .count();
+}
+
+} // namespace TBE::Scene::Stream
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "TBEngine/core/graphics/vulkanAbstract/uploadBatch/uploadBatch.hpp"
+#include "TBEngine/utils/threadPool/threadPool.hpp"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TBE::Scene::Stream {
+
+enum class StreamStatus
+{
+    eQueued,
+    eDecoding,
+    eDecoded,
+    eUploading,
+    eReady,
+    eFailed
+};
+
+const char* toString(StreamStatus status);
+
+// state of one streamed asset, times are in ms since the first asset was queued
+struct StreamRecord {
+    std::string  name{};
+    StreamStatus status = StreamStatus::eQueued;
+    double       decodeMs{};
+    double       readyMs{};
+};
+
+/**
+ * @brief Loads assets in the background while the render loop keeps running.
+ *
+ * @details Every asset goes through three steps. decode runs on a worker thread and prepares the
+ * CPU data, upload runs on the main thread inside tick() and records the copies into an
+ * UploadBatch, ready runs on the main thread once the fence of that batch has signalled and swaps
+ * the asset in. An exception thrown by decode marks the asset as failed and skips the rest.
+ */
+class StreamQueue {
+public:
+    using DecodeFunc = std::function<void()>;
+    using UploadFunc = std::function<void(Graphics::UploadBatch&)>;
+    using ReadyFunc  = std::function<void()>;
+
+public:
+    explicit StreamQueue(size_t threadCount);
+
+public:
+    size_t enqueue(std::string name, DecodeFunc decode, UploadFunc upload, ReadyFunc ready);
+
+    // call once per frame on the main thread, returns true on the tick the last asset finished
+    bool tick();
+
+    bool                      idle();
+    std::vector<StreamRecord> getRecords();
+
+private:
+    struct Job {
+        StreamRecord                           record{};
+        DecodeFunc                             decode{};
+        UploadFunc                             upload{};
+        ReadyFunc                              ready{};
+        std::unique_ptr<Graphics::UploadBatch> batch{};
+    };
+
+    using Clock = std::chrono::high_resolution_clock;
+
+private:
+    // declared after the jobs, so the workers are joined before the jobs go away
+    std::deque<Job>   jobs{};
+    std::mutex        mutex{};
+    size_t            pendingCount = 0;
+    size_t            failedCount  = 0;
+    Clock::time_point startTime{};
+    bool              loading          = false;
+    bool              firstFrameLogged = false;
+    Utils::ThreadPool workers;
+
+private:
+    double sinceStart() const;
+    void   decodeJob(Job& job);
+};
+
+} // namespace TBE::Scene::Stream
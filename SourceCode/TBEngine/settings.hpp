@@ -1,8 +1,99 @@
 #pragma once
 
+#include "TBEngine/core/math/dataFormat.hpp"
+#include "TBEngine/resource/texture/mipmap/mipmap.hpp"
+
 namespace TBE {
 
 constexpr auto WINDOW_WIDTH  = 1280;
 constexpr auto WINDOW_HEIGHT = 720;
 
+// reorder imported meshes for the post-transform vertex cache and vertex fetch
+constexpr auto OPTIMIZE_MESHES = true;
+
+// vertex layout of imported meshes, ePacked trades precision for less than half the bandwidth
+constexpr auto MESH_VERTEX_LAYOUT = Math::DataFormat::VertexLayout::ePacked;
+
+// levels of detail simplified from every imported mesh, the full mesh included, 1 for none
+constexpr auto MESH_LOD_COUNT = 5u;
+
+// a coarser level of detail is drawn once its error covers at most
+// LOD_PIXEL_ERROR * (1 - LOD_HYSTERESIS) pixels, and kept until it covers more than LOD_PIXEL_ERROR
+constexpr auto LOD_PIXEL_ERROR = 1.0f;
+constexpr auto LOD_HYSTERESIS  = 0.25f;
+
+// split imported meshes into meshlets of up to 64 vertices and 124 triangles, instances drawn with
+// the full mesh then have every meshlet culled on its own against the frustum and by the cone of
+// its normals, which needs VK_KHR_draw_indirect_count when the GPU culls
+constexpr auto CLUSTER_CULLING = true;
+
+// filter of the mip chains built on import, eKaiser and eLanczos keep distant textures sharper
+constexpr auto TEXTURE_MIP_FILTER = Resource::Texture::MipFilter::eKaiser;
+
+// compress imported textures into BC1/BC3 (BC5 for normal maps) when the device samples them
+constexpr auto TEXTURE_COMPRESSION = true;
+
+// BC7 instead of BC1/BC3 for color, twice the size of BC1 but without its banding
+constexpr auto TEXTURE_PREFER_BC7 = false;
+
+// texture slots the bindless table of the fragment shader has room for, clamped to the sampled
+// images the device allows per stage
+constexpr auto TEXTURE_TABLE_SIZE = 4096u;
+
+// decode models and textures on worker threads and draw placeholders until they are uploaded
+constexpr auto STREAM_ASSETS = true;
+
+// size of the device memory blocks buffers and textures are sub-allocated from, smaller heaps
+// use an eighth of their size
+constexpr auto GPU_MEMORY_BLOCK_SIZE = uint64_t{64} << 20;
+
+// upload on a transfer only queue family when the device has one, so copies overlap rendering
+constexpr auto USE_TRANSFER_QUEUE = true;
+
+// persistently mapped ring every upload is staged in, larger data gets a buffer of its own
+constexpr auto STAGING_RING_SIZE = uint64_t{64} << 20;
+
+// per frame in flight, the per frame and per object data of the frame is allocated from it
+constexpr auto FRAME_RING_SIZE = uint64_t{4} << 20;
+
+// sets the first descriptor pool of a list has room for, every pool added to it doubles that up
+// to DESCRIPTOR_POOL_MAX_SETS, a list that needs more adds pools of that size
+constexpr auto DESCRIPTOR_POOL_SETS     = 16u;
+constexpr auto DESCRIPTOR_POOL_MAX_SETS = 1024u;
+
+// vertices and indices a geometry pool starts with, a pool doubles whenever it runs full
+constexpr auto GEOMETRY_POOL_VERTICES = uint64_t{1} << 20;
+constexpr auto GEOMETRY_POOL_INDICES  = uint64_t{4} << 20;
+constexpr auto GEOMETRY_POOL_MESHLETS = uint64_t{1} << 16; // shared by every pool
+
+// meshlet draws a frame has room for, instances at the full mesh past it are drawn whole
+constexpr auto CLUSTER_DRAW_BUDGET = 1u << 16;
+
+// cull instances in a compute pass that writes indirect draws, so recording a frame costs about
+// the same whatever the instance count, the CPU draws everything when the device cannot
+constexpr auto GPU_DRIVEN_RENDERING = true;
+
+// read back what the culling pass kept and compare it with culling on the CPU, prefers a software
+// device such as lavapipe so the results do not depend on the driver of the GPU
+constexpr auto GPU_CULLING_VALIDATION = false;
+
+// log at startup how fast ObjParser and tinyobj read viking_room.obj and a generated grid of a
+// million triangles, and how fast weldVertices welds them against the old std::unordered_map
+constexpr auto MODEL_IMPORT_BENCHMARK = false;
+
+// log at startup how fast the CPU frustum culling kernels are, and the BVH queries against
+// testing every object
+constexpr auto SPATIAL_QUERY_BENCHMARK = false;
+
+// fill the scene with a dense grid of instances and log the frame time and the triangles drawn
+// with and without levels of detail every few seconds, run it again with MESH_LOD_COUNT = 1 to
+// compare the frame time
+constexpr auto LOD_BENCHMARK_SCENE = false;
+
+// log every few seconds how many meshlets the last frame tested and how many of them were culled
+constexpr auto CLUSTER_CULLING_REPORT = false;
+
+// directory of the content addressed asset cache, relative to the root path
+constexpr auto ASSET_CACHE_DIR = "Cache";
+
 } // namespace TBE
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _MSC_VER
+#    include <intrin.h>
+#endif
+
+namespace TBE::Utils {
+
+namespace Detail {
+
+// 64x64 -> 128 bit multiply folded back into 64 bits
+inline uint64_t mum(uint64_t a, uint64_t b) {
+#ifdef _MSC_VER
+    uint64_t hi{};
+    uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#else
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#endif
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v{};
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// read 1~7 bytes
+inline uint64_t readPartial(const uint8_t* p, size_t size) {
+    uint64_t v{};
+    std::memcpy(&v, p, size);
+    return v;
+}
+
+inline constexpr uint64_t hashSecret[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+} // namespace Detail
+
+/**
+ * @brief 64-bit hash of raw bytes, in the spirit of wyhash.
+ *
+ * @details Every input bit affects every output bit through 128-bit multiplies, so it is safe to
+ * use the low bits directly as a table index. It is not a cryptographic hash.
+ */
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+    using namespace Detail;
+    const auto* p = static_cast<const uint8_t*>(data);
+
+    uint64_t h = seed ^ mum(seed ^ hashSecret[0], hashSecret[1]);
+    size_t   i = size;
+    for (; i > 16; i -= 16, p += 16) {
+        h = mum(read64(p) ^ hashSecret[1], read64(p + 8) ^ h);
+    }
+
+    uint64_t a{}, b{};
+    if (i > 8) {
+        a = read64(p);
+        b = readPartial(p + 8, i - 8);
+    } else {
+        a = readPartial(p, i);
+    }
+    return mum(hashSecret[1] ^ size, mum(a ^ hashSecret[2], b ^ h ^ hashSecret[3]));
+}
+
+inline uint64_t hashCombine(uint64_t seed, uint64_t value) {
+    return Detail::mum(seed ^ Detail::hashSecret[0], value ^ Detail::hashSecret[1]);
+}
+
+} // namespace TBE::Utils
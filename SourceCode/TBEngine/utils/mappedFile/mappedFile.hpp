@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace TBE::Utils {
+
+/**
+ * @brief A read-only file mapped into memory with copy-on-write pages.
+ *
+ * @details The pages are mapped privately, so the bytes can be handed out as a mutable
+ * std::span<std::byte> without touching the file on disk. Nothing is read until a page is
+ * accessed.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+public:
+    // return false if the file cannot be opened or mapped, the old mapping is released anyway
+    bool open(const std::filesystem::path& path);
+    void close();
+
+public:
+    bool                 isOpen() const { return data != nullptr; }
+    size_t               size() const { return fileSize; }
+    std::span<std::byte> bytes() const { return {data, fileSize}; }
+
+private:
+    std::byte* data = nullptr;
+    size_t     fileSize{};
+
+#ifdef _WIN32
+    void* fileHandle    = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+} // namespace TBE::Utils
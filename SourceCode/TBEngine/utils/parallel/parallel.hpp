@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace TBE::Utils {
+
+// number of threads the parallel helpers would use, including the calling thread
+inline size_t workerCount() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Run func(begin, end) over contiguous sub-ranges of [0, count) on worker threads.
+ *
+ * @details The calling thread takes the first range and joins the others before returning, also
+ * when its range throws. No range is smaller than minBatch, so small inputs stay on the calling
+ * thread.
+ */
+template <typename Func>
+void parallelFor(size_t count, size_t minBatch, Func&& func) {
+    if (count == 0) {
+        return;
+    }
+    size_t numRanges =
+        std::min(workerCount(), (count + minBatch - 1) / std::max<size_t>(1, minBatch));
+    if (numRanges <= 1) {
+        func(size_t{0}, count);
+        return;
+    }
+
+    size_t                   rangeSize = (count + numRanges - 1) / numRanges;
+    std::vector<std::thread> threads{};
+    threads.reserve(numRanges - 1);
+    for (size_t begin = rangeSize; begin < count; begin += rangeSize) {
+        threads.emplace_back([&func, begin, end = std::min(count, begin + rangeSize)]() {
+            func(begin, end);
+        });
+    }
+
+    // the workers are joined even when the first range throws, a joinable thread left to its
+    // destructor terminates the program
+    auto joinAll = [&threads]() {
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+    try {
+        func(size_t{0}, std::min(count, rangeSize));
+    } catch (...) {
+        joinAll();
+        throw;
+    }
+    joinAll();
+}
+
+/**
+ * @brief std::sort over worker threads.
+ *
+ * @details The range is cut into a power-of-two number of slices, every slice is sorted on its own
+ * thread and neighbouring slices are merged pairwise until one is left. Not stable.
+ */
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, size_t minBatch = 1 << 16) {
+    const size_t count     = static_cast<size_t>(last - first);
+    size_t       numSlices = 1;
+    while (numSlices * 2 <= workerCount() && numSlices * 2 * minBatch <= count) {
+        numSlices *= 2;
+    }
+    if (numSlices == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    auto sliceBegin = [first, count, numSlices](size_t slice) {
+        return first + static_cast<std::ptrdiff_t>(slice * count / numSlices);
+    };
+
+    parallelFor(numSlices, 1, [&](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; slice++) {
+            std::sort(sliceBegin(slice), sliceBegin(slice + 1), comp);
+        }
+    });
+
+    for (size_t width = 1; width < numSlices; width *= 2) {
+        parallelFor(numSlices / (2 * width), 1, [&](size_t begin, size_t end) {
+            for (size_t pair = begin; pair < end; pair++) {
+                size_t slice = pair * 2 * width;
+                std::inplace_merge(sliceBegin(slice),
+                                   sliceBegin(slice + width),
+                                   sliceBegin(slice + 2 * width),
+                                   comp);
+            }
+        });
+    }
+}
+
+} // namespace TBE::Utils
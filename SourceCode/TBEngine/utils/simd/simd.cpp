@@ -0,0 +1,76 @@
+#include "simd.hpp"
+
+#if defined(TBE_SIMD_X86)
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#    endif
+#endif
+
+#include <array>
+#include <cstdint>
+
+namespace TBE::Utils {
+
+#if defined(TBE_SIMD_X86)
+
+static std::array<uint32_t, 4> cpuid(uint32_t leaf, uint32_t subLeaf) {
+    std::array<uint32_t, 4> regs{};
+#    if defined(_MSC_VER)
+    std::array<int, 4> out{};
+    __cpuidex(out.data(), static_cast<int>(leaf), static_cast<int>(subLeaf));
+    for (size_t i = 0; i < regs.size(); i++) {
+        regs[i] = static_cast<uint32_t>(out[i]);
+    }
+#    else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#    endif
+    return regs;
+}
+
+static uint64_t xgetbv0() {
+#    if defined(_MSC_VER)
+    return _xgetbv(0);
+#    else
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#    endif
+}
+
+static CpuFeatures queryCpuFeatures() {
+    CpuFeatures features{};
+
+    auto leaf0 = cpuid(0, 0);
+    if (leaf0[0] < 1) {
+        return features;
+    }
+    auto leaf1     = cpuid(1, 0);
+    features.sse41 = leaf1[2] & (1u << 19);
+
+    const bool osxsave = leaf1[2] & (1u << 27);
+    const bool fma     = leaf1[2] & (1u << 12);
+    // the OS has to save the xmm and ymm registers on context switches
+    const bool ymmState = osxsave && (xgetbv0() & 0x6) == 0x6;
+    if (leaf0[0] >= 7 && ymmState && fma) {
+        auto leaf7    = cpuid(7, 0);
+        features.avx2 = leaf7[1] & (1u << 5);
+    }
+    return features;
+}
+
+#else
+
+static CpuFeatures queryCpuFeatures() {
+    return {};
+}
+
+#endif
+
+const CpuFeatures& getCpuFeatures() {
+    static const CpuFeatures features = queryCpuFeatures();
+    return features;
+}
+
+} // namespace TBE::Utils
@@ -0,0 +1,27 @@
+#pragma once
+
+// x86 SIMD support, every vector path needs a scalar fallback for other targets
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#    define TBE_SIMD_X86
+#    include <immintrin.h>
+#endif
+
+// functions using AVX2/FMA intrinsics, MSVC compiles them without any flag
+#if defined(TBE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#    define TBE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#    define TBE_TARGET_AVX2
+#endif
+
+namespace TBE::Utils {
+
+struct CpuFeatures {
+    bool sse41 = false;
+    bool avx2  = false; // together with FMA, the AVX2 paths use both
+};
+
+// queried once, the answer includes the OS support for the ymm state
+const CpuFeatures& getCpuFeatures();
+
+} // namespace TBE::Utils
@@ -0,0 +1,51 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+namespace TBE::Utils {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = std::max<size_t>(1, threadCount);
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard lock(mutex);
+        jobs.emplace_back(std::move(job));
+    }
+    jobReady.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job{};
+        {
+            std::unique_lock lock(mutex);
+            jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace TBE::Utils
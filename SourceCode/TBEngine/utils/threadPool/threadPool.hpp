@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TBE::Utils {
+
+/**
+ * @brief A fixed set of worker threads running submitted jobs in FIFO order.
+ *
+ * @details Jobs must not throw, report failures through their own state instead. The destructor
+ * drops jobs that have not started and joins the workers.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+public:
+    void   submit(std::function<void()> job);
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread>          workers{};
+    std::deque<std::function<void()>> jobs{};
+    std::mutex                        mutex{};
+    std::condition_variable           jobReady{};
+    bool                              stopping = false;
+
+private:
+    void workerLoop();
+};
+
+} // namespace TBE::Utils